@@ -0,0 +1,91 @@
+/**********************************************************
+ *   AssetLoader:  A class to load assets in the background
+ *   while the first frames are drawn.  Worker threads read
+ *   and decode the files and build the vertex data, and each
+ *   job hands back the OpenGL work it needs done.  The OpenGL
+ *   work runs on the context thread in pump(), a few
+ *   milliseconds each frame, so the window keeps drawing with
+ *   placeholders until the real assets are resident.
+ *   Created by: Edward Charles Eberle <eberdeed@eberdeed.net>
+ *   October 2026 San Diego, California USA
+ * ********************************************************/
+
+#ifndef ASSETLOADER_H
+#define ASSETLOADER_H
+
+#include "commonheader.h"
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <limits>
+
+/** \class AssetLoader Submit a job with submit(), it runs on a
+ * worker and returns the upload to run on the context thread, or
+ * an empty function.  Call pump() once a frame from the context
+ * thread and frameDrawn() after the window is swapped.
+ */
+class AssetLoader
+{
+public:
+    //! The OpenGL work of a job, run on the context thread.
+    typedef function<void()> Upload;
+    //! The work of a job, run on a worker thread.
+    typedef function<Upload()> Job;
+    /** \brief Start the worker threads.
+     * workers : The number of threads, 0 for one less than the cores.
+     */
+    AssetLoader(int workers = 0);
+    //! \brief Stop the workers once their current jobs are done.
+    ~AssetLoader();
+    /* Functions */
+    /** \brief Queue a job for the workers.
+     * name : The asset, for the log.
+     * job : The work, returning the upload that finishes it.
+     */
+    void submit(string name, Job job);
+    //! \brief Queue an upload directly, from any thread.
+    void post(Upload upload);
+    /** \brief Run the queued uploads for up to the given time in
+     * milliseconds, at least one if any are waiting.  Returns the
+     * number run.
+     */
+    int pump(float budget);
+    //! \brief Whether every job and upload has run.
+    bool idle();
+    //! \brief Run the uploads as they come until every job and upload has run.
+    void finish();
+    /** \brief Count a drawn frame, reporting the time to the first
+     * frame and the time to full quality once each.
+     */
+    void frameDrawn();
+    /* Variables */
+    //! Milliseconds from creation to the first frame and to full quality, -1 until reached.
+    float firstFrame = -1.0f, fullQuality = -1.0f;
+    //! The jobs and uploads run so far.
+    int jobsDone = 0, uploadsDone = 0;
+    //! Debug flag.
+    bool debug1 = false;
+protected:
+    //! \brief The loop of each worker thread.
+    void work();
+    //! The worker threads.
+    vector<thread> workers;
+    //! The jobs waiting for a worker, with their names.
+    deque<pair<string, Job>> jobs;
+    //! The uploads waiting for the context thread.
+    deque<Upload> uploads;
+    //! Guards the queues and the counts.
+    mutex lock;
+    //! Wakes the workers for a job, and finish() for an upload or the last job.
+    condition_variable wake, ready;
+    //! The jobs being run now.
+    int running = 0;
+    //! Set when the workers are to stop.
+    bool stopping = false;
+    //! The creation time.
+    chrono::steady_clock::time_point start;
+};
+
+#endif // ASSETLOADER_H
@@ -0,0 +1,124 @@
+/**********************************************************
+ *   AssetPack:  A class to serve the program's files out of
+ *   one packed archive.  The pack has a table of contents
+ *   and its files each start on a 64 byte boundary, stored
+ *   as they are or compressed in the LZ4 block format.  It
+ *   is mapped once, and a stored file is read in place, so
+ *   a cold start reads one file from front to back instead
+ *   of opening dozens of small ones.  Files missing from the
+ *   pack, or every file when there is no pack, are read from
+ *   the file system as before.
+ *   Created by: Edward Charles Eberle <eberdeed@eberdeed.net>
+ *   October 2026 San Diego, California USA
+ * ********************************************************/
+
+#ifndef ASSETPACK_H
+#define ASSETPACK_H
+
+#include "commonheader.h"
+#include <string>
+#include <vector>
+#include <map>
+#include <memory>
+#include <assimp/IOStream.hpp>
+#include <assimp/IOSystem.hpp>
+#include <assimp/DefaultIOSystem.h>
+
+using namespace std;
+
+//! The contents of a file in the pack.
+struct PackView {
+    const unsigned char *data = nullptr;
+    size_t size = 0;
+    //! The decompressed copy of a compressed file, empty for a stored one.
+    shared_ptr<vector<unsigned char>> owned;
+};
+
+/** \class AssetPack The one pack is shared(), opened by open().
+ * A file is named in the pack by its path under the pack's root,
+ * and looked up by its full path, so the callers keep their file
+ * names.  Build a pack with build(), or the astercubepack tool.
+ */
+class AssetPack
+{
+public:
+    //! \brief Echo the creation of the class.
+    AssetPack();
+    //! \brief Unmap the pack.
+    ~AssetPack();
+    /* Functions */
+    //! \brief The pack of the program.
+    static AssetPack &shared();
+    /** \brief Map a pack, returning false when there is no usable pack.
+     * root : The directory the files were packed from, their paths start with it.
+     */
+    bool open(string packPath, string root);
+    //! \brief Whether the file is in the pack.
+    bool contains(string path);
+    //! \brief Whether the file is in the pack or on the disk.
+    bool has(string path);
+    //! \brief The contents of a file in the pack.  Returns false when it is not there.
+    bool view(string path, PackView &contents);
+    //! \brief A hash of the contents of a file in the pack, set when the pack was built.
+    bool contentHash(string path, uint64_t &hash);
+    //! \brief The files in the pack in a directory, with their full paths.
+    vector<string> list(string directory);
+    /** \brief Write a pack of the files under a directory.
+     * compress : Compress the files that shrink by an eighth or more.
+     */
+    static bool build(string root, string packPath, bool compress);
+    //! \brief Compress a block in the LZ4 block format.
+    static vector<unsigned char> compressLZ4(const unsigned char *source, size_t size);
+    //! \brief Decompress an LZ4 block of a known size, returning false when it is damaged.
+    static bool decompressLZ4(const unsigned char *source, size_t size, unsigned char *target, size_t targetSize);
+    /* Variables */
+    //! Debug flag.
+    bool debug1 = false;
+protected:
+    //! \brief The name of a full path in the pack, empty when it is not under the root.
+    string packName(string path);
+    //! One file of the pack.
+    struct Entry {
+        uint64_t offset = 0, size = 0, rawSize = 0, hash = 0;
+        bool compressed = false;
+    };
+    //! The files by name.
+    map<string, Entry> entries;
+    //! The root the names are under.
+    string root;
+    //! The mapping.
+    unsigned char *mapped = nullptr;
+    size_t mappedSize = 0;
+};
+
+/** \class PackIOStream A file of the pack read through the Assimp
+ * file interface.
+ */
+class PackIOStream : public Assimp::IOStream
+{
+public:
+    PackIOStream(PackView contents);
+    size_t Read(void *buffer, size_t size, size_t count);
+    size_t Write(const void *buffer, size_t size, size_t count);
+    aiReturn Seek(size_t offset, aiOrigin origin);
+    size_t Tell() const;
+    size_t FileSize() const;
+    void Flush();
+protected:
+    PackView contents;
+    size_t position = 0;
+};
+
+/** \class PackIOSystem Lets Assimp read a model and its material
+ * files out of the pack, and anything else from the disk.  Give
+ * one to each Assimp::Importer with SetIOHandler().
+ */
+class PackIOSystem : public Assimp::DefaultIOSystem
+{
+public:
+    bool Exists(const char *file) const;
+    Assimp::IOStream *Open(const char *file, const char *mode = "rb");
+    void Close(Assimp::IOStream *file);
+};
+
+#endif // ASSETPACK_H
@@ -34,6 +34,23 @@
 #include "shader.h"
 #include "camera.h"
 #include "uniformprinter.h"
+#include "meshoptimizer.h"
+#include "vertexquantizer.h"
+#include "meshsimplifier.h"
+#include "impostor.h"
+#include "occlusionculler.h"
+#include "overdrawcounter.h"
+#include "depthsorter.h"
+#include "framegovernor.h"
+#include "assetloader.h"
+#include "texturecache.h"
+#include "texturecompressor.h"
+#include "meshcache.h"
+#include "assetpack.h"
+#include "objparser.h"
+#include "glbloader.h"
+#include "texturestreamer.h"
+#include "resourceregistry.h"
 
 /** \brief A structure to contain a vertex
  * for a textured mesh.
@@ -55,6 +72,28 @@ struct Vertex1 {
     //! Normal to the surface at the vertex point.
     float Normal[3];
 };
+/** \brief A compressed Vertex of 16 bytes instead of 32.
+ * Position is normalized 16 bit relative to the mesh bounds,
+ * the normal is octahedral encoded in two signed normalized 
+ * 16 bit values and the texture coordinates are normalized
+ * 16 bit relative to the texture coordinate bounds.
+ */
+struct VertexPacked {
+    //! Vertex Postion cooridinates, the fourth keeps the normal aligned.
+    unsigned short Position[4];
+    //! The octahedral encoded normal.
+    short Normal[2];
+    //! Texture coordinates.
+    unsigned short TexCoords[2];
+};
+/** \brief A compressed Vertex1 of 12 bytes instead of 24.
+ */
+struct Vertex1Packed {
+    //! Vertex Postion cooridinates, the fourth keeps the normal aligned.
+    unsigned short Position[4];
+    //! The octahedral encoded normal.
+    short Normal[2];
+};
 /** \brief A structure to contain a texture 
  * for display on the surface of a mesh.
  */
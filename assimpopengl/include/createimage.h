@@ -8,9 +8,30 @@
 #ifndef CREATEIMAGE_H
 #define CREATEIMAGE_H
 #include "commonheader.h"
+#include "assetloader.h"
+#include "texturecache.h"
+#include "texturecompressor.h"
+#include "texturestreamer.h"
+#include "assetpack.h"
+#include <thread>
+#include <atomic>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
 
 using namespace std;
 
+/** A decoded image, four bytes per pixel in RGBA order, or in BGRA
+ * order when the driver takes it directly.
+ */
+struct ImageData {
+    vector<unsigned char> pixels;
+    GLsizei width = 0;
+    GLsizei height = 0;
+    //! GL_RGBA or GL_BGRA_EXT, used as both formats of the upload.
+    GLenum format = GL_RGBA;
+};
+
 /* \class CreateImage : Using Free Image Plus, this class loads an 
  * image into memory, converts it to a 32 bit format with alpha, 
  * and then passes it to an array of unsigned characters, which 
@@ -27,8 +48,11 @@ public:
     //! Free the storage used by the pixels array.
     ~CreateImage();
     /* Functions */
-    //!  Load image and convert it.
-    bool setImage(string imagefile);
+    /** \brief Load image and convert it.
+     * tier : Decode at 1/2, 1/4 or 1/8 size for 1, 2 or 3, 0 for the full
+     * size, -1 for decodeTier and decodeLimit.
+     */
+    bool setImage(string imagefile, int tier = -1);
     //! Accessor functions for the given image's dimensions and data.
     //! Image width in pixels.
     GLsizei getWidth();
@@ -36,28 +60,94 @@ public:
     GLsizei getHeight();
     //! The overall size of the image in bytes.
     GLsizei getSize();
-    //! The void* blob containing the picture data.
+    //! The void* blob containing the picture data, decoded again if it was released.
     GLvoid *getData();
-    //! Return an OpenGL buffer object.
+    //! Return an OpenGL buffer object, releasing the pixels unless keepPixels is set.
     GLuint textureObject();
-    //! Return an OpenGL sky box object.
+    //! \brief Free the pixels of the last image loaded, the size is kept.
+    void releaseImage();
+    //! \brief Return an OpenGL buffer object of a compressed texture.
+    GLuint textureObject(CompressedImage &texture);
+    /** Return an OpenGL sky box object, compressed through the
+     * texture cache files unless TextureCompressor is turned off.
+     */
     void createSkyBoxTex(GLuint &textureID, string filenames[6]);
     //! Create an array of images for an OpenGL Texture2DArray object.
     void create2DTexArray(GLuint &textureID, vector<string>filenames);
+    /** \brief Load and convert an image without touching OpenGL or
+     * the class, so it can run on a loader thread.
+     * tier : As for setImage().
+     */
+    static bool decodeImage(string imagefile, ImageData &image, int tier = -1);
+    /** \brief The times an image of the given size is halved when it is
+     * decoded, from a tier or from decodeTier and decodeLimit for -1.
+     */
+    static int decodeHalvings(GLsizei width, GLsizei height, int tier = -1);
+    /** \brief Set decodeLimit to the largest power of two side at which the
+     * given number of textures, with their mipmaps, fit in a video memory budget.
+     */
+    static void setDecodeBudget(long budget, int textures);
+    /** \brief Decode several images at once, one thread each.  Returns
+     * false if any of them will not load.
+     * images : One for each file, in the same order.
+     */
+    static bool decodeImages(vector<string> imagefiles, ImageData *images);
+    /** \brief Copy a line of FreeImage BGRA pixels, clearing the color of
+     * those with no alpha, four pixels at a time where SSE2 is there.
+     * swap : Reorder to RGBA, otherwise the BGRA order is kept.
+     */
+    static void convertLine(const BYTE *source, unsigned char *target, int count, bool swap);
+    //! \brief Halve a decoded image in each direction, averaging each two by two box of pixels.
+    static void halveImage(ImageData &image);
+    /** \brief Create a one pixel texture of the given color, to be drawn
+     * until the real image is put into it by uploadTexture().
+     * target : GL_TEXTURE_2D or GL_TEXTURE_CUBE_MAP.
+     */
+    GLuint placeholderTexture(GLenum target, const unsigned char color[4]);
+    //! \brief Put a decoded image into an existing texture and build its mipmaps.
+    static void uploadTexture(GLuint textureID, ImageData &image);
+    //! \brief Put six decoded faces, in file order, into an existing sky box.
+    static void uploadSkyBoxTex(GLuint textureID, ImageData faces[6]);
+    /** \brief Return the texture of an image from the texture cache,
+     * making it the first time.  Returns 0 when the image will not load.
+     * loader : Decode the image in the background, the texture is one
+     * pixel of the placeholder color until it is in.
+     * placeholder : The RGBA color drawn while loading.
+     * streamed : Leave the levels to the TextureStreamer when it is on, the
+     * texture is the placeholder until its instances ask for it.
+     */
+    GLuint loadTexture(string imagefile, AssetLoader *loader = nullptr, const unsigned char *placeholder = nullptr, bool streamed = false);
+    //! \brief As loadTexture(), for a sky box of six images.
+    void loadSkyBox(GLuint &textureID, string filenames[6], AssetLoader *loader = nullptr, const unsigned char *placeholder = nullptr);
+    //! \brief Give back a texture from loadTexture() or loadSkyBox().
+    static void releaseTexture(GLuint textureID);
+    //! \brief The video memory of an RGBA texture with its mipmaps.
+    static long textureBytes(GLsizei width, GLsizei height, int faces = 1);
+    //! \brief The sky box files in OpenGL face order.
+    static vector<string> skyBoxOrder(string filenames[6]);
+    /* Variables */
+    //! The quality of every decode, 0 for the full size to 3 for 1/8.
+    static int decodeTier;
+    //! The largest side decoded, the image is halved until it fits, 0 for no limit.
+    static GLsizei decodeLimit;
+    //! Keep the pixels of setImage() after textureObject(), for reading them back.
+    bool keepPixels = false;
 protected:
     /* Variables */
     //! Class global variables.
-    //! The Free Image Plus image object.
-    fipImage txtImage;
-    //! A line of image data.
-    BYTE *picLine;
     //! Image dimensions.
     GLsizei width;
     GLsizei height;
     //! The size in bytes.
     int size = 0;
-    //! Image data.
+    //! The video memory of the last texture made.
+    long bytes = 0;
+    //! Image data, pointing into image.
     unsigned char *pixels = nullptr;
+    //! The last image loaded by setImage(), and its file and tier to decode it again.
+    ImageData image;
+    string imagefile;
+    int tier = -1;
     //! Byte and line counters.
     int count, line;
     //! A little tiny bit of debug info.
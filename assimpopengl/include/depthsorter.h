@@ -0,0 +1,50 @@
+/**********************************************************
+ *   DepthSorter:  A class to put a list of depths in order
+ *   without moving the things they belong to.  Each depth
+ *   becomes a 32 bit key that sorts as an unsigned integer,
+ *   and the keys are radix sorted eight bits at a time along
+ *   with their indices.  The buffers are kept between calls
+ *   so sorting does not allocate once they have grown.
+ *   Created by: Edward Charles Eberle <eberdeed@eberdeed.net>
+ *   October 2026 San Diego, California USA
+ * ********************************************************/
+
+#ifndef DEPTHSORTER_H
+#define DEPTHSORTER_H
+
+#include "commonheader.h"
+
+/** \class DepthSorter Sort depths into an index order.  After
+ * sort(), order[0] is the index of the nearest depth, or of the
+ * farthest when descending is set.  Equal depths keep the order
+ * they were given in.
+ */
+class DepthSorter
+{
+public:
+    //! \brief Echo the creation of the class.
+    DepthSorter();
+    //! \brief Echo the destruction of the class.
+    ~DepthSorter();
+    /* Functions */
+    /** \brief Sort the depths and leave their indices in order.
+     * depths : The depth of each item.
+     * count : The number of items.
+     * descending : Farthest first instead of nearest first.
+     */
+    void sort(const float *depths, int count, bool descending = false);
+    /** \brief The key of a depth, ordered as an unsigned integer the
+     * way the depths are ordered as floats, negative depths included.
+     */
+    static unsigned int floatKey(float value);
+    /* Variables */
+    //! The indices of the items in sorted order.
+    vector<unsigned int> order;
+    //! Debug flag.
+    bool debug1 = false;
+protected:
+    //! The keys and the second key and index buffers of each pass.
+    vector<unsigned int> keys, keyScratch, indexScratch;
+};
+
+#endif // DEPTHSORTER_H
@@ -0,0 +1,82 @@
+/**********************************************************
+ *   FrameGovernor:  A class to hold the frame time to a
+ *   budget on slower hosts.  It watches the recent frame
+ *   times and moves a quality level between 0 and 1, and
+ *   the quality sets the render resolution, the level of
+ *   detail bias and the impostor distance.  Below full
+ *   resolution the frame is drawn into an offscreen
+ *   framebuffer and blitted up to the window.
+ *   Created by: Edward Charles Eberle <eberdeed@eberdeed.net>
+ *   October 2026 San Diego, California USA
+ * ********************************************************/
+
+#ifndef FRAMEGOVERNOR_H
+#define FRAMEGOVERNOR_H
+
+#include "commonheader.h"
+#include "resourceregistry.h"
+
+/** \class FrameGovernor Call beginFrame() before the frame is
+ * drawn and endFrame() before the window is swapped.  The window
+ * size comes from resize().  The level of detail bias and the
+ * impostor scale are read after beginFrame() and passed on to
+ * the models.
+ */
+class FrameGovernor
+{
+public:
+    /** \brief Set the budget and the window size.
+     * budget : The target frame time in milliseconds.
+     * width, height : The window size in pixels.
+     */
+    FrameGovernor(float budget, int width, int height);
+    //! \brief Delete the offscreen framebuffer.
+    ~FrameGovernor();
+    /* Functions */
+    //! \brief Record the last frame time, adjust the quality and bind the render target.
+    void beginFrame();
+    //! \brief Blit the offscreen frame up to the window, if one was drawn.
+    void endFrame();
+    //! \brief Follow a change of the window size.
+    void resize(int width, int height);
+    /* Variables */
+    //! The target frame time in milliseconds.
+    float budget;
+    //! The quality level, 1 is full resolution and full detail.
+    float quality = 1.0f;
+    //! The quality change per adjustment.
+    float step = 0.05f;
+    //! The lowest render scale and the highest level of detail bias and impostor scale.
+    float minScale = 0.5f, maxLodBias = 2.0f, maxImpostorScale = 3.0f;
+    //! The values set by the quality level.
+    float renderScale = 1.0f, lodBias = 1.0f, impostorScale = 1.0f;
+    //! The frames averaged per adjustment.
+    int window = 30;
+    //! The quiet windows at budget before a step up is tried.
+    int probeWindows = 8;
+    //! The average frame time of the last window in milliseconds.
+    float average = 0.0f;
+    //! Adjust the quality, or hold it where it is.
+    bool enabled = true;
+    //! Debug flag.
+    bool debug1 = false;
+protected:
+    //! \brief Set the render scale, the bias and the impostor scale from the quality.
+    void applyQuality();
+    //! \brief Create or resize the offscreen framebuffer.
+    void allocate(int width, int height);
+    //! The window size and the render size.
+    int width, height, renderWidth = 0, renderHeight = 0;
+    //! The offscreen framebuffer and its color and depth buffers.
+    GLuint FBO = 0, colorBuffer = 0, depthBuffer = 0;
+    //! Whether the current frame is drawn offscreen.
+    bool offscreen = false;
+    //! The start of the last frame.
+    chrono::steady_clock::time_point last;
+    bool started = false;
+    //! The frame times of the current window.
+    float total = 0.0f;
+    int frames = 0, calm = 0;
+};
+
+#endif // FRAMEGOVERNOR_H
@@ -0,0 +1,49 @@
+/**********************************************************
+ *   GlbLoader:  A class to read binary glTF 2.0 (.glb)
+ *   assets.  The file is mapped, and a mesh whose accessors
+ *   are laid out as a Vertex or Vertex1 array, with 32 bit
+ *   indices, is used where it is in the binary chunk and
+ *   goes from there to its vertex and index buffers.  The
+ *   parsing is only of the short JSON header, so the time
+ *   to load one is the time to read it.
+ *   Created by: Edward Charles Eberle <eberdeed@eberdeed.net>
+ *   October 2026 San Diego, California USA
+ * ********************************************************/
+
+#ifndef GLBLOADER_H
+#define GLBLOADER_H
+
+#include "commonheader.h"
+
+struct AssetData;
+
+/** \class GlbLoader Each primitive of each mesh becomes a mesh,
+ * as Assimp makes them, with the level of detail it was exported
+ * with.  The textures of a material go in the slots of MeshTex:
+ * the base color as diffuse, the metallic roughness as specular,
+ * and the normal map as normal.  A file using a feature the loader
+ * leaves out, such as a required extension, missing normals or
+ * primitives other than triangles, is read by Assimp instead.
+ */
+class GlbLoader
+{
+public:
+    /* Functions */
+    //! \brief Whether a file is one the loader reads, by its extension.
+    static bool handles(string path);
+    /** \brief Map a .glb file, from the asset pack or the disk, and
+     * make its asset, with new meshes pointing into the mapping where
+     * the layouts allow.  Returns nullptr when the loader can not read it.
+     * The glTF texture coordinates start at the top of the image, they
+     * are turned to start at the bottom, as the other assets do, in
+     * the private mapping.
+     */
+    static AssetData *read(string path);
+    /* Variables */
+    //! Turn the loader off, every .glb file is then read by Assimp.
+    static bool enabled;
+    //! Debug flag.
+    static bool debug1;
+};
+
+#endif // GLBLOADER_H
@@ -0,0 +1,82 @@
+/**********************************************************
+ *   Impostor:  A class to draw distant instances of an asset
+ *   as camera facing quads.  The meshes of the asset are
+ *   rendered once from a set of view directions into an
+ *   atlas texture, and each quad shows the atlas tile whose
+ *   view direction is closest to the one the camera sees.
+ *   Created by: Edward Charles Eberle <eberdeed@eberdeed.net>
+ *   October 2026 San Diego, California USA
+ * ********************************************************/
+
+#ifndef IMPOSTOR_H
+#define IMPOSTOR_H
+
+#include "commonheader.h"
+#include "shader.h"
+#include "mesh.h"
+
+//! The most view directions held in an atlas.
+#define MAX_IMPOSTOR_VIEWS 16
+
+//! Forward declarations so it can be used as a library.
+struct MeshInfo;
+struct PointLight;
+struct SpotLight;
+class Mesh;
+class Shader;
+
+/** \class Impostor Holds the atlas of one asset and draws any
+ * number of its instances in a single instanced draw.  The
+ * instance matrices are passed as per instance attributes, not
+ * through the itemData uniform block, so the count is not limited
+ * by NUM_INSTANCES.
+ */
+class Impostor
+{
+public:
+    /** \brief Create the quad and the instance buffer.
+     * shader : The impostor shader (impostor.vs and impostor.frag).
+     * tileSize : The width and height of one atlas tile in pixels.
+     * views : The number of view directions, at most MAX_IMPOSTOR_VIEWS.
+     */
+    Impostor(Shader *shader, int tileSize = 128, int views = MAX_IMPOSTOR_VIEWS);
+    //! \brief Delete the atlas and the buffers.
+    ~Impostor();
+    /* Functions */
+    /** \brief Render the meshes of an asset into the atlas.
+     * meshes : The meshes of the asset.
+     * meshShader : The shader the meshes are drawn with.
+     * radius : The bounding radius of the asset about its origin.
+     * diffOnly : The diffuse only flag of the asset.
+     * gamma : The brightness of the asset.
+     */
+    void capture(vector<MeshInfo> meshes, Shader *meshShader, float radius, bool diffOnly, float gamma);
+    /** \brief Draw one quad per instance matrix.
+     * view : The position and orientation of the camera.
+     * projection : The perspective of the camera.
+     * instances : The position and orientation of each instance.
+     * viewPos : The camera position.
+     */
+    void Draw(mat4 view, mat4 projection, vector<mat4> &instances, vec3 viewPos);
+    /* Variables */
+    //! The atlas texture.
+    GLuint atlas = 0;
+    //! The framebuffer and depth buffer used to render the atlas.
+    GLuint FBO = 0, depthBuffer = 0;
+    //! The quad vertex array and its corner and instance buffers.
+    GLuint VAO = 0, VBO[2] = {0, 0};
+    //! The instances the instance buffer holds, it grows only when a draw has more.
+    size_t capacity = 0;
+    //! The view direction and up vector of each tile, in model space.
+    vec3 tileDir[MAX_IMPOSTOR_VIEWS], tileUp[MAX_IMPOSTOR_VIEWS];
+    //! The tile size, the number of views and the atlas width in tiles.
+    int tileSize, views, columns;
+    //! The bounding radius the atlas was rendered with.
+    float radius = 1.0f;
+    //! The impostor shader.
+    Shader *shader;
+    //! Debug flag.
+    bool debug1 = false;
+};
+
+#endif // IMPOSTOR_H
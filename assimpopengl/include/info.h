@@ -10,12 +10,47 @@
 #define INFO_H
 #include "assimpopengl.h"
 #include "mesh.h"
+#include "occlusionculler.h"
+
+class MeshOptimizer;
+class VertexQuantizer;
+class MeshSimplifier;
 //! The mesh and associated textures.
 struct MeshInfo {
     Mesh* mesh;
     //! For Texture see the "commonheader.h" file.
     vector<Texture>textures;
 };
+/** \brief The CPU side of one mesh, made on a loader thread.  The
+ * mesh has its levels of detail and any packed vertices, and gets
+ * its buffers and textures from setData() on the context thread.
+ */
+struct MeshData {
+    Mesh *mesh = nullptr;
+    bool textured = false;
+    Vertex *vertices = nullptr;
+    Vertex1 *vertices1 = nullptr;
+    GLuint *indices = nullptr;
+    int vertSize = 0, indexSize = 0;
+    vec3 color = vec3(0.0f);
+    float opacity = 1.0f;
+    //! The image file and texture type of each material texture.
+    vector<pair<string, string>> images;
+};
+//! The CPU side of one asset, and the import stages of the thread making it.
+struct AssetData {
+    vector<MeshData> meshes;
+    float radius = 0.0f;
+    Occluder occluder;
+    bool quantize = false;
+    string directory;
+    MeshOptimizer *optimizer = nullptr;
+    VertexQuantizer *quantizer = nullptr;
+    MeshSimplifier *simplifier = nullptr;
+    //! The mesh cache file the arrays are in, when they were read from one.
+    void *mapped = nullptr;
+    size_t mappedSize = 0;
+};
 //! The blender objects definition in the program.
 /** \brief A series of structures to encapsulate:
  * 1.  The meshes and textures of a blender object
@@ -33,7 +68,7 @@ struct MeshInfo {
  * vec3 location:
  * 5. A distance variable so the vector can
  * be sorted by distance:
- * int dist = 0;
+ * float dist = 0.0f;
  * 6. An identification value so the vector
  * can be sorted into it's original order:
  * int idval = 0;
@@ -41,16 +76,26 @@ struct MeshInfo {
  * bool diffOnly = true;
  * 8. A gamma variable to control brightness:
  * float gamma = 1.0f;
+ * 9. A boolean to store the meshes in the packed
+ * 16 bit vertex layout when the precision allows:
+ * bool quantize = false;
+ * 10. The bounding radius of the object about its origin,
+ * set on import and used to choose the level of detail:
+ * float radius = 0.0f;
  */
 struct ModelInfo {
     string path;
     vector<MeshInfo> meshes;
     mat4 model;
     vec3 location;
-    int dist = 0;
+    float dist = 0.0f;
     int idval = 0;
     bool diffOnly = true;
     float gamma = 1.0f;
+    bool quantize = false;
+    float radius = 0.0f;
+    //! Keep the vertex and index arrays after they are in OpenGL, for collision or picking.
+    bool keepArrays = false;
 };
 
 #endif // INFO_H
@@ -16,8 +16,12 @@
 
 #include "commonheader.h"
 #include "shader.h"
+#include "resourceregistry.h"
 #include <vector>
 
+//! The most levels of detail a mesh holds, the full mesh included.
+#define MAX_LODS 4
+
 //! Forward declarations so it can be used as a library.
 struct Vertex;
 struct Vertex1;
@@ -33,8 +37,8 @@ class Mesh {
 public:
     //! \brief Constructor echoing its creation (should not occur).
     Mesh();
-    //! \brief Destructor echoing its destruction (should not occur).
-    ~Mesh();
+    //! \brief Destructor echoing its destruction, virtual so a mesh is deleted through its pointer.
+    virtual ~Mesh();
     /*  Functions  */
     /** \brief Set data for MeshTex.
      * vertices : The vertex array.
@@ -85,10 +89,11 @@ public:
      * startIndex is the current index of the textures being used.
      * diffOnly when set to true will provide an image without specular highlights.
      * gamma controls brightness of the textured mesh.
+     * lod is the level of detail drawn, one instance is drawn per model matrix.
      */
     virtual void DrawInstanced(mat4 view, mat4 projection, vector<mat4>model, 
     vector<PointLight> lights, vector<SpotLight>spotLights, vec3 viewPos, 
-    bool diffOnly = true, float gamma = 1.0f);
+    bool diffOnly = true, float gamma = 1.0f, int lod = 0);
     //! \brief A convenience function to pass messages.
     string getType();
     //! \brief A convenience function to post messages.
@@ -97,6 +102,29 @@ public:
     void dumpData();
     //! \brief Set the vertex array and index buffer.
     virtual void setupMesh();
+    //! \brief Pass the packed vertex decode values to a shader, the mesh shader by default.
+    void setPacking(Shader *target = nullptr);
+    /** \brief Copy the positions out of the vertex array into a position
+     * only buffer for the depth pre-pass, sharing the index buffer.
+     * vertices : The vertex array, packed or not, positions first.
+     * vertSize : The number of vertices.
+     * stride : The size of one vertex.
+     * EBO : The index buffer of the mesh.
+     */
+    void setupDepthMesh(const void *vertices, int vertSize, int stride, GLuint EBO);
+    /** \brief Write the depth of the instances with the position only stream.
+     * depthShader : The depth only shader (depthonly.vs and depthonly.frag).
+     * view, projection : The camera.
+     * model : The position and orientation of each instance.
+     * lod : The level of detail drawn.
+     */
+    void DrawDepth(Shader *depthShader, mat4 view, mat4 projection, vector<mat4> &model, int lod = 0);
+    //! \brief Make the whole index array the only level of detail, unless levels were set.
+    void setLods(int indexSize);
+    //! \brief The number of indices in a level of detail.
+    GLsizei lodIndexCount(int lod);
+    //! \brief The index buffer offset of a level of detail.
+    GLvoid *lodIndexOffset(int lod);
     /* Variables */
     //! Message data.
     string type;
@@ -112,6 +140,20 @@ public:
     int quantity = 1, dataIndex = 0;
     //! The instancing shader.
     Shader *shader = nullptr;
+    //! Whether the vertices are stored in the packed layout.
+    bool packed = false;
+    //! Whether the vertex and index arrays are in a mapped mesh cache file, and not to be deleted.
+    bool mapped = false;
+    //! The decode values for packed positions:  offset + value * scale.
+    vec3 posOffset = vec3(0.0f), posScale = vec3(1.0f);
+    //! The decode values for packed texture coordinates.
+    vec2 uvOffset = vec2(0.0f), uvScale = vec2(1.0f);
+    //! The levels of detail stored one after the other in the index buffer.
+    int lodLevels = 0;
+    //! The first index and the number of indices of each level of detail.
+    GLuint lodOffset[MAX_LODS], lodCount[MAX_LODS];
+    //! The position only vertex array, its buffer and its instance block for the depth pre-pass.
+    GLuint depthVAO = 0, depthVBO = 0, depthUBO = 0;
 public:
     //! Sampler values.
     unsigned intdummyTex = 500;
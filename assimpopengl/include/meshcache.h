@@ -0,0 +1,50 @@
+/**********************************************************
+ *   MeshCache:  A class to keep the meshes of an asset, as
+ *   the Model class leaves them after importing, optimizing,
+ *   simplifying and packing, in a binary file.  A warm start
+ *   maps the file and points the meshes at its vertex and
+ *   index arrays instead of running Assimp and the import
+ *   stages again.
+ *   Created by: Edward Charles Eberle <eberdeed@eberdeed.net>
+ *   October 2026 San Diego, California USA
+ * ********************************************************/
+
+#ifndef MESHCACHE_H
+#define MESHCACHE_H
+
+#include "commonheader.h"
+
+struct AssetData;
+
+/** \class MeshCache The file of an asset is named by a hash of
+ * the asset's files and the import settings, so an edited model
+ * or a change of settings makes a new file.  The arrays of a read
+ * asset live in the mapping, which is given back with unmap() once
+ * its meshes are gone.
+ */
+class MeshCache
+{
+public:
+    /* Functions */
+    /** \brief The cache file of an asset.
+     * path : The model file, hashed with the material files beside it.
+     * settings : Everything else that changes the imported meshes.
+     */
+    static string cachePath(string path, string settings);
+    //! \brief Write the meshes, occluder and bounds of an imported asset.
+    static bool write(string cachePath, AssetData &asset);
+    /** \brief Map a cache file and make its asset, with new meshes
+     * pointing into the mapping.  Returns nullptr when there is no
+     * usable file.
+     */
+    static AssetData *read(string cachePath);
+    //! \brief Give back the mapping of a read asset.
+    static void unmap(void *mapped, size_t mappedSize);
+    /* Variables */
+    //! Turn the cache off, every asset is then imported.
+    static bool enabled;
+    //! Debug flag.
+    static bool debug1;
+};
+
+#endif // MESHCACHE_H
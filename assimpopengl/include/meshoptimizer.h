@@ -0,0 +1,91 @@
+/**********************************************************
+ *   MeshOptimizer:  A class to reorder the vertex and index
+ *   arrays of a mesh when it is imported, so that the GPU
+ *   reuses transformed vertices and shades fewer hidden
+ *   fragments.  It works on the interleaved float arrays
+ *   built by the Model class (Vertex and Vertex1).
+ *   Created by: Edward Charles Eberle <eberdeed@eberdeed.net>
+ *   October 2026 San Diego, California USA
+ * ********************************************************/
+
+#ifndef MESHOPTIMIZER_H
+#define MESHOPTIMIZER_H
+
+#include "commonheader.h"
+#include <unordered_map>
+#include <algorithm>
+
+/** \class MeshOptimizer A mesh optimization stage for the
+ * Model class.  The stages are run in order by optimize():
+ * 1. Vertex welding:  identical vertices are merged.
+ * 2. Vertex cache reordering:  triangles are ordered so the
+ * post-transform cache is reused (Forsyth's algorithm).
+ * 3. Overdraw reordering:  clusters of triangles facing outward
+ * are drawn first, within a bound on the cache efficiency lost.
+ * 4. Vertex fetch reordering:  vertices are stored in the order
+ * they are first used.
+ * The average cache miss ratio (ACMR) is reported before and
+ * after, where 3.0 is the worst and 0.5 is about the best.
+ */
+class MeshOptimizer
+{
+public:
+    //! \brief Echo the creation of the class.
+    MeshOptimizer();
+    //! \brief Echo the destruction of the class.
+    ~MeshOptimizer();
+    /* Functions */
+    /** \brief Run all the stages on a mesh and report the ACMR.
+     * vertices : The interleaved vertex array, rewritten in place.
+     * vertSize : The number of vertices.
+     * stride : The number of floats in one vertex (position first).
+     * indices : The index array, rewritten in place.
+     * indexSize : The number of indices.
+     * Returns the new number of vertices.
+     */
+    int optimize(float *vertices, int vertSize, int stride, GLuint *indices, int indexSize);
+    /** \brief Merge vertices that are identical in every float.
+     * Returns the new number of vertices.
+     */
+    int weldVertices(float *vertices, int vertSize, int stride, GLuint *indices, int indexSize);
+    /** \brief Order the triangles for the post-transform vertex cache.
+     */
+    void optimizeVertexCache(GLuint *indices, int indexSize, int vertSize);
+    /** \brief Order clusters of triangles to reduce overdraw.  The
+     * threshold is the ACMR allowed relative to the input, 1.05 allows 5% worse.
+     */
+    void optimizeOverdraw(GLuint *indices, int indexSize, float *vertices, int vertSize, int stride, float threshold);
+    /** \brief Store the vertices in the order they are first used,
+     * dropping unused ones.  Returns the new number of vertices.
+     */
+    int optimizeVertexFetch(float *vertices, int vertSize, int stride, GLuint *indices, int indexSize);
+    /** \brief The average cache miss ratio:  vertex shader invocations
+     * per triangle with a FIFO cache of cacheSize entries.
+     */
+    float calcACMR(GLuint *indices, int indexSize, int vertSize);
+    //! \brief Zero the running totals.
+    void resetStats();
+    //! \brief Print the running totals for an asset.
+    void printStats(string name);
+    /* Variables */
+    //! The FIFO cache size used to measure the ACMR.
+    int cacheSize = 16;
+    //! The ACMR loss allowed to the overdraw stage.
+    float overdrawThreshold = 1.05f;
+    //! Running totals since the last resetStats().
+    long totalTriangles = 0, totalVertsBefore = 0, totalVertsAfter = 0;
+    double totalMissesBefore = 0.0, totalMissesAfter = 0.0;
+    //! Debug flag.
+    bool debug1 = false;
+protected:
+    /** \brief Count the cache misses of one triangle with a
+     * timestamp FIFO cache.
+     */
+    int cacheMisses(GLuint *tri, vector<unsigned int> &stamps, unsigned int &timestamp);
+    //! \brief The Forsyth score of a vertex.
+    float vertexScore(int cachePos, int valence);
+    //! The cache size that the Forsyth scores are tuned for.
+    static const int maxCache = 32;
+};
+
+#endif // MESHOPTIMIZER_H
@@ -0,0 +1,79 @@
+/**********************************************************
+ *   MeshSimplifier:  A class to build the simplified levels
+ *   of detail of a mesh when it is imported.  Each level is
+ *   an index array over the same vertices, so all the levels
+ *   of a mesh share one vertex buffer and one index buffer.
+ *   Created by: Edward Charles Eberle <eberdeed@eberdeed.net>
+ *   October 2026 San Diego, California USA
+ * ********************************************************/
+
+#ifndef MESHSIMPLIFIER_H
+#define MESHSIMPLIFIER_H
+
+#include "commonheader.h"
+#include <unordered_map>
+#include <algorithm>
+
+/** \class MeshSimplifier Quadric error edge collapse after
+ * Garland and Heckbert "Surface Simplification Using Quadric
+ * Error Metrics".  Vertices are collapsed onto a neighbouring
+ * vertex rather than a new position, so only the indices change.
+ * Vertices that share a position with other vertices (texture
+ * or normal seams) are collapsed in pairs along the seam, while
+ * open borders and more complex seams are left in place.
+ */
+class MeshSimplifier
+{
+public:
+    //! \brief Echo the creation of the class.
+    MeshSimplifier();
+    //! \brief Echo the destruction of the class.
+    ~MeshSimplifier();
+    /* Functions */
+    /** \brief Simplify a mesh into a new index array.
+     * vertices : The interleaved vertex array (position first).
+     * vertSize : The number of vertices.
+     * stride : The number of floats in one vertex.
+     * indices : The source index array.
+     * indexSize : The number of source indices.
+     * destination : Receives the new indices, at least indexSize long.
+     * targetIndexSize : The number of indices wanted.
+     * targetError : The largest error allowed as a fraction of the mesh size.
+     * Returns the number of indices written to destination.
+     */
+    int simplify(const float *vertices, int vertSize, int stride, const GLuint *indices, int indexSize,
+        GLuint *destination, int targetIndexSize, float targetError);
+    /* Variables */
+    //! The error of the last simplify() call as a fraction of the mesh size.
+    float lastError = 0.0f;
+    //! Debug flag.
+    bool debug1 = false;
+protected:
+    //! \brief A symmetric 4x4 quadric stored as its ten unique values.
+    struct Quadric
+    {
+        double a2 = 0, b2 = 0, c2 = 0, d2 = 0, ab = 0, ac = 0, ad = 0, bc = 0, bd = 0, cd = 0;
+    };
+    //! \brief A candidate collapse of vertex "from" onto vertex "to".
+    struct Collapse
+    {
+        GLuint from, to;
+        double cost;
+    };
+    //! The kinds of vertex, which decide the collapses allowed.
+    enum Kind { manifold, seam, locked };
+    //! \brief Add the plane of a triangle to a quadric, weighted by area.
+    void addPlane(Quadric &q, const vec3 &p0, const vec3 &p1, const vec3 &p2);
+    //! \brief Add one quadric to another.
+    void addQuadric(Quadric &q, const Quadric &r);
+    //! \brief The squared distance error of a position under a quadric.
+    double quadricError(const Quadric &q, const vec3 &p);
+    //! \brief Whether moving a vertex flips any of its triangles.
+    bool flips(const vector<GLuint> &triangles, const GLuint *indices, GLuint from, GLuint to);
+    //! The positions of the vertices.
+    vector<vec3> positions;
+    //! The first vertex that shares each vertex's position.
+    vector<GLuint> positionRemap;
+};
+
+#endif // MESHSIMPLIFIER_H
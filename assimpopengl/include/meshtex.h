@@ -18,6 +18,7 @@
 
 //! Forward declarations so it can be used as a library.
 struct Vertex;
+struct VertexPacked;
 struct Texture;
 struct PointLight;
 struct SpotLight;
@@ -70,10 +71,11 @@ public:
      * startIndex is the current index of the textures being used.
      * diffOnly when set to true will provide an image without specular highlights.
      * gamma controls brightness of the textured mesh.
+     * lod is the level of detail drawn, one instance is drawn per model matrix.
      */
     void DrawInstanced(mat4 view, mat4 projection, vector<mat4>model, 
     vector<PointLight> lights, vector<SpotLight>spotLights, vec3 viewPos, 
-    bool diffOnly = true, float gamma = 1.0f);
+    bool diffOnly = true, float gamma = 1.0f, int lod = 0);
     //! \brief For debugging.
     void dumpData();
     //! \brief Debug instance data.
@@ -82,6 +84,12 @@ public:
     void setupMesh();
     //! \brief Create the mesh data as an instanced OpenGL buffer object.
     void setupInstancedMesh();
+    /** \brief Free the vertex and index arrays once they are in OpenGL,
+     * or let go of them when they are in a mapped file.
+     */
+    void releaseArrays();
+    //! \brief Take the arrays of the same mesh read again, after releaseArrays().
+    void adoptArrays(MeshTex *source);
     //! \brief For debugging:  Print a vector of three floats.
     void printVec3(vec3 vecVal);
     //! \brief For debugging:  Print a 4x4 matrix of floats.
@@ -90,18 +98,18 @@ public:
     /*  Mesh Data  */
     //! Class global variables.
     //! The Vertex array.
-    Vertex *vertices;
-    //! The indexed Vertex array.
-    Vertex *verticesIndexed;
+    Vertex *vertices = nullptr;
+    //! The packed Vertex array, when the mesh has been quantized.
+    VertexPacked *packedVertices = nullptr;
     //! The index array.
-    GLuint *indices;
+    GLuint *indices = nullptr;
     //! The associated textures as a vector.
     vector<Texture>textures;
     //! The instance location array.
     mat4 *instanceArray;
     /*  Render data  */
     //! The buffer object handles.
-    GLuint VAO, VBO[2], EBO;
+    GLuint VAO = 0, VBO[2] = {0, 0}, EBO = 0;
     //! The upper bounds of the various buffers.
     int vertSize, indexSize, texSize, total;
     //! Copious debug data.
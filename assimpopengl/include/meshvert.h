@@ -17,6 +17,7 @@
 
 //! Forward declarations so it can be used as a library.
 struct Vertex1;
+struct Vertex1Packed;
 struct PointLight;
 struct SpotLight;
 
@@ -69,20 +70,23 @@ public:
      * startIndex is the current index of the textures being used.
      * diffOnly when set to true will provide an image without specular highlights.
      * gamma controls brightness of the textured mesh.
+     * lod is the level of detail drawn, one instance is drawn per model matrix.
      */
-    void DrawInstanced(mat4 view, mat4 projection, vector<mat4>model, vector<PointLight> lights, vector<SpotLight>spotLights, vec3 viewPos, bool diffOnly = true, float gamma = 1.0f);
+    void DrawInstanced(mat4 view, mat4 projection, vector<mat4>model, vector<PointLight> lights, vector<SpotLight>spotLights, vec3 viewPos, bool diffOnly = true, float gamma = 1.0f, int lod = 0);
     //! Class global variables.
     /* Variables */
     /*  Mesh Data  */
     //! The vertex array.
-    Vertex1 *vertices;
+    Vertex1 *vertices = nullptr;
+    //! The packed vertex array, when the mesh has been quantized.
+    Vertex1Packed *packedVertices = nullptr;
     //! The index array.
-    GLuint *indices;
+    GLuint *indices = nullptr;
     //! \brief Debugging function.
     void dumpData();
     /*  Render data  */
     //! The OpenGL buffer object handles.
-    GLuint VAO, VBO[2], EBO;
+    GLuint VAO = 0, VBO[2] = {0, 0}, EBO = 0;
     //! The instance data location.
     mat4 *modelData;
     //! The upper bounds of the vertex and index arrays respectively.
@@ -92,6 +96,12 @@ public:
     /*  Functions    */
     //! \brief Create the vertex array buffer, buffer object and index buffers.
     void setupMesh();
+    /** \brief Free the vertex and index arrays once they are in OpenGL,
+     * or let go of them when they are in a mapped file.
+     */
+    void releaseArrays();
+    //! \brief Take the arrays of the same mesh read again, after releaseArrays().
+    void adoptArrays(MeshVert *source);
     //! Debug flag.
     bool debug1 = false;
 };
@@ -14,6 +14,16 @@
 #include "meshvert.h"
 #include "meshtex.h"
 #include "createimage.h"
+#include "meshoptimizer.h"
+#include "vertexquantizer.h"
+#include "meshsimplifier.h"
+#include "meshcache.h"
+#include "objparser.h"
+#include "glbloader.h"
+#include "impostor.h"
+#include "occlusionculler.h"
+#include "depthsorter.h"
+#include "assetloader.h"
 #include "info.h"
 #include "shader.h"
 
@@ -23,6 +33,8 @@ struct Texture;
 struct SpotLight;
 struct ModelInfo;
 struct MeshInfo;
+struct MeshData;
+struct AssetData;
 class Mesh;
 /** \class Model A class to extract 3D asset data from a 
  * resource file and pass it along to the mesh files for 
@@ -33,13 +45,17 @@ class Model
 public:
     /** \brief Pass a vector containing file names of asset files 
      * and their associated positions and orientations.
+     * loader : Read the assets and textures in the background, each
+     * asset is drawn once it is resident and each texture is a flat
+     * color until it is decoded.  Without one they load here.
      */
-    Model(vector<ModelInfo> modelinfo, Shader *shader, int startIndex);
+    Model(vector<ModelInfo> modelinfo, Shader *shader, int startIndex, AssetLoader *loader = nullptr);
     /** \brief Pass a vector containing file names of asset files 
      * and their associated positions and orientations.
      * quantity : The number of instanced objects from each object.
+     * loader : As above.
      */
-    Model(vector<ModelInfo> modelinfo, int quantity, Shader *shader, int startIndex);
+    Model(vector<ModelInfo> modelinfo, int quantity, Shader *shader, int startIndex, AssetLoader *loader = nullptr);
     /** \brief Destructor, signals destruction of the class.
      * It deletes the textures and meshes.
      */
@@ -76,33 +92,92 @@ public:
     void DrawInstanced(mat4 view, mat4 projection, vector<ModelInfo>model, vector<mat4>instanceData, vector<PointLight>lights, vector<SpotLight>spotLights, vec3 viewPos);
     //! \brief Accessor function to let the calling class know whether there are textures or not.
     bool hasTextures();
+    /** \brief Render each asset into an impostor atlas, so that distant
+     * instances are drawn as quads by DrawInstanced.
+     * impostorShader : The impostor shader (impostor.vs and impostor.frag).
+     * tileSize : The size of one view in the atlas in pixels.
+     * views : The number of view directions.
+     */
+    void buildImpostors(Shader *impostorShader, int tileSize = 128, int views = MAX_IMPOSTOR_VIEWS);
+    /** \brief Switch the depth pre-pass of DrawInstanced on or off.  The
+     * meshes are first drawn depth only from their position streams, then
+     * shaded with GL_EQUAL so each pixel is shaded once.
+     * enabled : Use the pre-pass, only once a depth shader has been given.
+     * depthShader : The depth only shader (depthonly.vs and depthonly.frag).
+     */
+    void setDepthPrepass(bool enabled, Shader *depthShader = nullptr);
+    /** \brief Trade detail for speed, from FrameGovernor.
+     * lodBias : Divides the projected size before a level of detail is
+     * chosen, above 1 the coarser levels are used sooner.
+     * impostorScale : Multiplies the projected size below which an
+     * instance is drawn as an impostor.
+     */
+    void setQuality(float lodBias, float impostorScale);
+    /** \brief Make the vertex and index arrays of an asset resident
+     * again once they were released after upload, reading the asset as
+     * on loading, from the mesh cache or the mapped glTF file when they
+     * are on.  Returns false when the asset is not loaded or reads
+     * differently.
+     * x : The index of the asset in the modelinfo vector.
+     */
+    bool restoreArrays(int x);
+    //! \brief Free the vertex and index arrays of an asset, they are kept by restoreArrays() or keepArrays.
+    void releaseArrays(int x);
 protected:
     /*  Functions   */
+    //! \brief Read every asset on the loader threads, then make their meshes here or in the loader's pump().
+    void loadModels(AssetLoader *loader);
     //! \brief Open the asset for extraction. Uses the Assimp library to obtain the data.
-    void loadModel(string path);
+    static const aiScene *readScene(Assimp::Importer *importer, string path);
+    /** \brief Read an asset and make everything but its buffers and
+     * textures.  It may run on any thread, each thread has its own
+     * Assimp importer and import stages.
+     */
+    AssetData *importAsset(string path, bool quantize);
+    //! \brief Make the buffers and textures of one asset on the context thread, and delete its data.
+    void addModel(int x, AssetData *asset);
     //! \brief Process a node and all its subnodes, extracting meshes and textures.
-    void processNode(aiNode* node, const aiScene* scene);
-    //! \brief Extract the textures, vertices, indices, texture coordinates and others.
-    MeshInfo processMesh(aiMesh* mesh, const aiScene* scene);
-    //! \brief Compare distances
-    static bool cmpdist(const ModelInfo &a, const ModelInfo &b);
+    void processNode(aiNode* node, const aiScene* scene, AssetData &asset);
+    //! \brief Extract the vertices, indices, texture file names and others.
+    MeshData processMesh(aiMesh* mesh, const aiScene* scene, AssetData &asset);
+    /** \brief Weld and reorder the vertices of an extracted mesh, make its
+     * Mesh class, levels of detail and any packed vertices.
+     */
+    void finishMesh(MeshData &item, AssetData &asset);
+    /** \brief Append the simplified levels of detail of a mesh to the index
+     * array, record them on the mesh and grow the bounding radius of the asset.
+     */
+    void buildLods(MeshData &item, float *vertices, int stride, AssetData &asset);
+    //! \brief Append the coarsest level of detail of a mesh to the occluder of the asset.
+    void addOccluder(MeshData &item, float *vertices, int stride, AssetData &asset);
+    /** \brief Fill the level of detail buckets of one asset with its
+     * visible instances, each bucket nearest first.
+     */
+    void bucketInstances(int y, mat4 projection, vector<mat4> &instanceData, vec3 viewPos);
+    //! \brief Choose a level of detail from the projected size of an instance, MAX_LODS for an impostor.
+    int selectLod(mat4 projection, mat4 instance, vec3 viewPos, float radius);
+    //! \brief The bounding radius over the distance of an instance, a fraction of half the screen height.
+    float projectedSize(mat4 projection, mat4 instance, vec3 viewPos, float radius);
+    //! \brief Ask the TextureStreamer for the textures of a mesh of an asset at a projected size.
+    void requestTextures(int y, int x, float size);
+    /** \brief Rasterize the largest instances as occluders and mark
+     * the instances hidden behind them in the visible vector.
+     */
+    void cullOcclusion(mat4 view, mat4 projection, vector<mat4> &instanceData, vec3 viewPos);
+    //! \brief Order the instances of one draw nearest first.
+    void sortFrontToBack(vector<mat4> &instances, vec3 viewPos);
     /** \brief Sort the objects by their distance from the
-     *  camera.  Furthest first, closest last.
+     *  camera into the order of the depth sorter.  Furthest first,
+     *  closest last.
      */
     void sortDists(vec3 viewPos);
-    //! \brief Compares ID values for sorting.
-    static bool cmpid(const ModelInfo &a, const ModelInfo &b);
-    /** \breif Sort the objects by idval.  We use this to reassign
-     *  the meshes to each object when the draw function is called.
-     */
-    void sortIDs();
     /* Variables */
-    //! \brief Get the texture from the assimp material file.
-    vector<Texture> loadMaterialTextures(aiMaterial* mat, aiTextureType type, string typeName);
+    //! \brief Name the image files of one texture type in the assimp material.
+    void loadMaterialTextures(aiMaterial* mat, aiTextureType type, string typeName, MeshData &item, string directory);
     /** \brief Get the image data from the file containing the texture, it
      *  uses Free Image Plus and the CreateImage class and creates an OpenGL bufferobject.
      */
-    GLint TextureFromFile(string filename);
+    GLint TextureFromFile(string filename, string typeName);
     //! \breif Print the instance data info.
     void debug(vector<mat4>instanceData);
     //! \breif Prints a three float vector. For debugging
@@ -116,38 +191,74 @@ protected:
     vector<MeshInfo> meshes;
     //! The textures vector, one for each textured mesh. Texture is defined in "commonheader.h."
     vector<Texture>textures;
-    //! The current mesh being worked on.
-    aiMesh* mesh;
     //! The texture count start index.
     int startIndex;
-    //! The index array.
-    GLuint *indices = nullptr;
-    //! The textured mesh vertex array.
-    Vertex *vertices = nullptr;
-    //! The untextured mesh vertex array.
-    Vertex1 *vertices1 = nullptr;
     //! The image management class.
     CreateImage * imageMkr;
-    //! The Assimp library importer.
-    Assimp::Importer *import;
-    //! The size of the Vertex, Index and Texture arrays respectively.
-    int vertSize, indexSize;
+    //! Weld and reorder the meshes for the vertex cache and overdraw.
+    bool optimizeMeshes = true;
+    //! Build the simplified levels of detail of each mesh.
+    bool generateLods = true;
+    //! The largest error of each level of detail as a fraction of the mesh size.
+    float lodError[MAX_LODS] = {0.0f, 0.01f, 0.025f, 0.06f};
+    /** The projected size, as a fraction of half the screen height, below
+     *  which each level of detail gives way to the next.
+     */
+    float lodScreenSize[MAX_LODS - 1] = {0.2f, 0.08f, 0.03f};
+    //! The instances of one asset bucketed by level of detail, the last bucket holds the impostors.
+    struct LodBuckets
+    {
+        vector<mat4>lods[MAX_LODS + 1];
+    };
+    //! The buckets of each asset, filled once a frame.
+    vector<LodBuckets>lodData;
+    //! The impostor of each asset, empty until buildImpostors() is called.
+    vector<Impostor*>impostors;
+    //! The projected size below which an instance is drawn as an impostor.
+    float impostorScreenSize = 0.015f;
+    //! The quality settings from setQuality().
+    float lodBias = 1.0f, impostorScale = 1.0f;
+    //! The software depth buffer culler, for instanced models only.
+    OcclusionCuller *culler = nullptr;
+    //! Cull the instances hidden behind the largest nearby instances.
+    bool occlusionCulling = true;
+    //! The occluder mesh of each asset, from its coarsest level of detail.
+    vector<Occluder>occluders;
+    //! The most instances rasterized as occluders in a frame.
+    int maxOccluders = 24;
+    //! The projected size above which an instance may be an occluder.
+    float occluderScreenSize = 0.1f;
+    //! Whether each instance passed the occlusion test this frame.
+    vector<bool>visible;
+    //! Draw the instances of each draw nearest first for the early depth test.
+    bool frontToBack = true;
+    //! Write the depth of every mesh before shading, see setDepthPrepass().
+    bool depthPrepass = false;
+    //! The depth only shader of the pre-pass.
+    Shader *depthShader = nullptr;
+    //! The radix sort of objects and instances by distance.
+    DepthSorter *sorter;
+    //! The distance of each item being sorted, and the sorted instances.
+    vector<float>sortDepths;
+    vector<mat4>sortScratch;
+    //! The background loader, or nullptr once the constructor has loaded everything.
+    AssetLoader *loader = nullptr;
+    //! Whether the meshes of each asset have been made.
+    vector<bool>resident;
+    //! The mesh cache or glTF file the meshes of each asset point into, if any.
+    vector<pair<void*, size_t>>mappings;
+    //! Whether the meshes of each asset hold their vertex and index arrays.
+    vector<bool>holdsArrays;
     //! Texture flag.
-    bool hasTex;
-    //! Variables to hold the directory and filename for image access.
-    string directory, filename;
+    bool hasTex = false;
     //! Book keeping variables.
     GLuint texcount = 0, vertcount = 0, count1 = 0, limit = 0;
-    //! The alpha value for the shader.
-    float opacity = 1.0f;
     //! The number of instances of each object.
     int quantity = -1;
     //! The number of instances per object.
     int span = 0;
     //! The instance shader.
     Shader *shader;
-    //! The instance array.
-    vector<mat4>modelData;
     //! Copious debug info to be had a the price of a single boolean value.
     bool debug1 = false;
     
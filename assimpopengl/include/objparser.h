@@ -0,0 +1,53 @@
+/**********************************************************
+ *   ObjParser:  A class to read the Wavefront OBJ files and
+ *   their MTL material libraries that Blender exports, the
+ *   format of every asset the program ships, without going
+ *   through Assimp.  The file is mapped and read once from
+ *   front to back, the numbers are parsed eight digits at a
+ *   time, and each mesh comes out as the Vertex or Vertex1
+ *   and index arrays the import stages take.  Other formats,
+ *   and any OBJ file it will not read, go through Assimp.
+ *   Created by: Edward Charles Eberle <eberdeed@eberdeed.net>
+ *   October 2026 San Diego, California USA
+ * ********************************************************/
+
+#ifndef OBJPARSER_H
+#define OBJPARSER_H
+
+#include "commonheader.h"
+
+struct MeshData;
+
+/** \class ObjParser The meshes match those of Assimp with the
+ * aiProcess_Triangulate and aiProcess_GenNormals flags of
+ * Model::readScene():  one mesh for each material of each object
+ * or group, polygons split into fans and flat normals for the faces
+ * without any.  A corner used by several faces is one vertex, where
+ * Assimp makes a vertex of every corner.
+ */
+class ObjParser
+{
+public:
+    /* Functions */
+    //! \brief Whether a file is one the parser reads, by its extension.
+    static bool handles(string path);
+    /** \brief Read an OBJ file and its material libraries, from the
+     * asset pack or the disk, into meshes with no Mesh class yet.
+     * Returns false and no meshes when the file will not read.
+     */
+    static bool read(string path, vector<MeshData> &meshes);
+    /** \brief Parse a number as strtof() does, moving the text past it
+     * and leaving it where it was when there is none.  A number of more
+     * than 15 digits may round to the float beside the one strtof() gives.
+     */
+    static float parseFloat(const char *&text, const char *end);
+    /* Variables */
+    //! Turn the parser off, every file is then read by Assimp.
+    static bool enabled;
+    //! Changes with the meshes the parser makes, so older mesh cache files are not used.
+    static const int revision = 2;
+    //! Debug flag.
+    static bool debug1;
+};
+
+#endif // OBJPARSER_H
@@ -0,0 +1,92 @@
+/**********************************************************
+ *   OcclusionCuller:  A class to drop instances hidden
+ *   behind nearer ones before they are drawn.  The largest
+ *   nearby instances are rasterized on the CPU into a small
+ *   depth buffer, a hierarchy of farthest depths is built
+ *   from it, and the bounding sphere of every instance is
+ *   tested against that hierarchy.
+ *   Created by: Edward Charles Eberle <eberdeed@eberdeed.net>
+ *   October 2026 San Diego, California USA
+ * ********************************************************/
+
+#ifndef OCCLUSIONCULLER_H
+#define OCCLUSIONCULLER_H
+
+#include "commonheader.h"
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+/** \brief A simplified mesh used to fill the depth buffer,
+ * positions in model space and an index array of triangles.
+ */
+struct Occluder {
+    vector<vec3> positions;
+    vector<GLuint> indices;
+};
+
+/** \class OcclusionCuller A software hierarchical depth buffer.
+ * Per frame:  beginFrame(), addOccluder() for each occluder,
+ * endFrame() to rasterize and build the hierarchy, then
+ * isVisible() for each instance.  The rows of the depth buffer
+ * are split into bands, one per worker thread, so the threads
+ * never write the same pixel.
+ */
+class OcclusionCuller
+{
+public:
+    /** \brief Create the depth buffer and start the workers.
+     * width, height : The depth buffer size in pixels.
+     * threads : The number of worker threads, 0 for the hardware count.
+     */
+    OcclusionCuller(int width = 256, int height = 128, int threads = 0);
+    //! \brief Stop the workers.
+    ~OcclusionCuller();
+    /* Functions */
+    //! \brief Clear the depth buffer and set the camera for the frame.
+    void beginFrame(mat4 view, mat4 projection);
+    /** \brief Queue an occluder for rasterization.
+     * occluder : The occluder mesh.
+     * model : The instance matrix.
+     */
+    void addOccluder(Occluder &occluder, mat4 model);
+    //! \brief Rasterize the occluders on the workers and build the hierarchy.
+    void endFrame();
+    /** \brief Whether any of a sphere may be seen past the occluders.
+     * center : The sphere center in world space.
+     * radius : The sphere radius.
+     */
+    bool isVisible(vec3 center, float radius);
+    /* Variables */
+    //! The occluders are shrunk by this much so they never cover more than the mesh.
+    float occluderShrink = 0.9f;
+    //! Counts for the last frame.
+    int occluderTriangles = 0, tested = 0, culled = 0;
+    //! Debug flag.
+    bool debug1 = false;
+protected:
+    //! \brief A worker thread loop, rasterizing one band per frame.
+    void worker(int band);
+    //! \brief Rasterize the queued triangles into the rows of one band.
+    void rasterBand(int band);
+    //! \brief Build the mip levels of farthest depth.
+    void buildHierarchy();
+    //! The camera for the frame.
+    mat4 view, viewProjection;
+    float projScaleX, projScaleY, projDepthA, projDepthB;
+    //! The depth buffer size.
+    int width, height;
+    //! The mip levels, level 0 is the depth buffer itself.
+    vector<vector<float>> levels;
+    vector<int> levelWidth, levelHeight;
+    //! The screen space triangles of the frame, three x, y, depth corners each.
+    vector<vec3> triangles;
+    //! The worker threads and their hand off.
+    vector<thread> workers;
+    mutex lock;
+    condition_variable wake, done;
+    int generation = 0, pending = 0;
+    bool quit = false;
+};
+
+#endif // OCCLUSIONCULLER_H
@@ -0,0 +1,68 @@
+/**********************************************************
+ *   OverdrawCounter:  A class to count the fragments that
+ *   are shaded in a frame.  The frame is drawn into an
+ *   offscreen framebuffer with the stencil buffer set to
+ *   increment wherever a fragment passes the depth test, so
+ *   each pixel ends up holding the number of times it was
+ *   shaded.  The stencil values are then resolved into the
+ *   color buffer and read back.  This is a debugging aid,
+ *   a measurement costs a read back of the whole frame.
+ *   Created by: Edward Charles Eberle <eberdeed@eberdeed.net>
+ *   October 2026 San Diego, California USA
+ * ********************************************************/
+
+#ifndef OVERDRAWCOUNTER_H
+#define OVERDRAWCOUNTER_H
+
+#include "commonheader.h"
+#include "shader.h"
+
+class Shader;
+
+/** \class OverdrawCounter Wrap the drawing of a frame in begin()
+ * and end() and the counts for that frame are left in fragments
+ * and pixels.  The framebuffer is sized from the viewport when
+ * begin() is called.
+ */
+class OverdrawCounter
+{
+public:
+    /** \brief Create the resolve vertex array.
+     * shader : The resolve shader (overdraw.vs and overdraw.frag).
+     */
+    OverdrawCounter(Shader *shader);
+    //! \brief Delete the framebuffer and its attachments.
+    ~OverdrawCounter();
+    /* Functions */
+    //! \brief Redirect drawing to the counting framebuffer and clear it.
+    void begin();
+    /** \brief Resolve the stencil counts, read them back and return
+     * to the framebuffer that was bound before begin().
+     * Returns the number of fragments shaded.
+     */
+    long end();
+    /* Variables */
+    //! The fragments shaded and the pixels covered in the last measurement.
+    long fragments = 0, pixels = 0;
+    //! The largest count resolved per pixel, deeper layers are clamped to it.
+    int maxLayers = 32;
+    //! Debug flag.
+    bool debug1 = false;
+protected:
+    //! \brief Create or resize the framebuffer attachments.
+    void allocate(int width, int height);
+    //! The framebuffer, its color texture and its depth and stencil buffer.
+    GLuint FBO = 0, colorTex = 0, depthStencil = 0;
+    //! An empty vertex array for the full screen triangle.
+    GLuint VAO = 0;
+    //! The framebuffer size.
+    int width = 0, height = 0;
+    //! The framebuffer and viewport to return to.
+    GLint previous = 0, viewport[4];
+    //! The resolve shader.
+    Shader *shader;
+    //! The read back buffer.
+    vector<unsigned char> readBack;
+};
+
+#endif // OVERDRAWCOUNTER_H
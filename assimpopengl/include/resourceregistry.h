@@ -0,0 +1,86 @@
+/**********************************************************
+ *   ResourceRegistry:  A class to count the memory held by
+ *   each part of the program, in heap arrays, OpenGL
+ *   buffers and OpenGL textures and renderbuffers.  Each
+ *   allocation is recorded with its subsystem and size
+ *   when it is made and forgotten when it is freed, so the
+ *   report shows what every subsystem holds now and at its
+ *   peak, and what is still held at exit is a leak.
+ *   Created by: Edward Charles Eberle <eberdeed@eberdeed.net>
+ *   October 2026 San Diego, California USA
+ * ********************************************************/
+
+#ifndef RESOURCEREGISTRY_H
+#define RESOURCEREGISTRY_H
+
+#include "commonheader.h"
+#include <map>
+#include <unordered_map>
+#include <mutex>
+#include <array>
+
+/** \class ResourceRegistry The one registry is shared().  Record an
+ * allocation with trackHeap() or trackGL() and its release with
+ * releaseHeap() or releaseGL().  Recording a handle again changes its
+ * size, as for a buffer given new data.  Any thread may use it.
+ */
+class ResourceRegistry
+{
+public:
+    /** The kinds of memory counted.  Textures and renderbuffers are
+     *  apart because OpenGL names them from separate pools.
+     */
+    enum Kind { HEAP, BUFFER, TEXTURE, RENDERBUFFER, KINDS };
+    //! \brief Echo the creation of the class.
+    ResourceRegistry();
+    //! \brief Print the report and flag what was never released as leaked.
+    ~ResourceRegistry();
+    /* Functions */
+    //! \brief The registry of the program.
+    static ResourceRegistry &shared();
+    //! \brief Record a heap array, or any other handle to host memory.
+    void trackHeap(const void *pointer, string subsystem, long bytes);
+    //! \brief Forget a heap array when it is deleted.
+    void releaseHeap(const void *pointer);
+    /** \brief Record an OpenGL buffer, or a texture or renderbuffer.
+     * kind : BUFFER, TEXTURE or RENDERBUFFER.
+     */
+    void trackGL(Kind kind, GLuint name, string subsystem, long bytes);
+    //! \brief Forget an OpenGL object when it is deleted.
+    void releaseGL(Kind kind, GLuint name);
+    //! \brief The bytes held now by a subsystem, of one kind or of all for KINDS.
+    long held(string subsystem, Kind kind = KINDS);
+    /** \brief Print the count and bytes held now and at their peak by
+     * each subsystem and kind.
+     * leaks : Print them as leaks, as at exit.
+     */
+    void report(bool leaks = false);
+    /* Variables */
+    //! Turn the counting off.
+    bool enabled = true;
+    //! Debug flag.
+    bool debug1 = false;
+protected:
+    //! One allocation.
+    struct Record {
+        string subsystem;
+        long bytes = 0;
+    };
+    //! The totals of one subsystem and kind.
+    struct Total {
+        int count = 0;
+        long bytes = 0, peak = 0;
+    };
+    //! \brief Record a handle of any kind, the lock held.
+    void track(Kind kind, uintptr_t handle, string subsystem, long bytes);
+    //! \brief Forget a handle of any kind, the lock held.
+    void release(Kind kind, uintptr_t handle);
+    //! The live allocations of each kind by handle.
+    unordered_map<uintptr_t, Record> live[KINDS];
+    //! The totals by subsystem.
+    map<string, array<Total, KINDS>> totals;
+    //! Guards the maps, the loader threads make arrays too.
+    mutex lock;
+};
+
+#endif // RESOURCEREGISTRY_H
@@ -9,8 +9,11 @@
 #define SHADER_H
 
 #include "commonheader.h"
+#include "assetpack.h"
 #include <iostream>
 #include <string>
+#include <vector>
+#include <map>
 // GLM The OpenGL math library
 #define GLM_FORCE_RADIANS
 #include <glm.hpp>
@@ -21,8 +24,12 @@ using namespace glm;
 
 /** \class Shader A class to encapsulate the uploading, compiling, 
  * linking and use of a shader.  This class will create a shader 
- * binary and reload it.  The binary will be recreated if it ceases 
- * to validate as a shader program.
+ * binary and reload it.  The binary is keyed on a hash of the
+ * shader sources, the definitions and the renderer and driver
+ * version, so an edited shader or a new driver compiles afresh.
+ * Programs started with startShader() compile in the background
+ * where the driver supports GL_KHR_parallel_shader_compile, and
+ * are finished the first time they are used.
  */
 
 class Shader
@@ -42,6 +49,8 @@ public:
      *  vertexPath : The vertex shader's location in the file structure.
      *  fragmentPath : The fragment shader's location in the file structure.
      *  outputFile : The name given to the output binary.
+     *  defines : Preprocessor definitions, "NAME" or "NAME VALUE",
+     *  placed after the #version line of both shaders.
      */
     /* Functions */
     /** \brief A function to create the shader program from the
@@ -51,12 +60,44 @@ public:
      * fragmentPath:  The file location for the fragment shader code.
      * outputFile: The name of the resulting binary to be
      * stored in the "~/.config" directory.
+     * defines:  The preprocessor definitions of this variant.
      */
     void initShader(string vertexPath, string fragmentPath, 
-    string outputFile);
-    /** \brief Create either the vertex or fragment shader from a file.
+    string outputFile, vector<string> defines = vector<string>());
+    /** \brief Start building the program without waiting for the
+     * compiler.  The arguments are those of initShader().  The program
+     * is finished by finishShader(), Use(), variant() or finishAll().
      */
-    unsigned int createShader(unsigned int type, string fpath);
+    void startShader(string vertexPath, string fragmentPath, 
+    string outputFile, vector<string> defines = vector<string>());
+    /** \brief Wait for the program to link, report any errors and
+     * save the binary.  Does nothing unless the program is compiling.
+     */
+    void finishShader();
+    //! \brief Finish every program that has been started.
+    static void finishAll();
+    /** \brief Return the variant of this shader compiled with more
+     * definitions, compiling it the first time it is asked for.
+     * The variants are owned and deleted by this shader, and each
+     * keeps its own binary next to the binary of this shader.
+     * extra : The definitions added to those of this shader.
+     */
+    Shader *variant(vector<string> extra);
+    /** \brief Set an integer uniform in this program and in every
+     * variant, making each current in turn.
+     */
+    void setIntAll(const string name, int value);
+    /** \brief Read a shader file, from the asset pack when it is
+     * there, and put the definitions after its #version line.
+     */
+    string readSource(string fpath);
+    //! \brief Put the definitions after the #version line of the code.
+    string addDefines(string shaderCode);
+    /** \brief Create either the vertex or fragment shader from its
+     * source and start it compiling.  Errors are reported when the
+     * program is finished.
+     */
+    unsigned int createShader(unsigned int type, string code);
     /** \brief Use the program object for display.
      */
     void Use();
@@ -64,6 +105,10 @@ public:
      * and delete the binary pointer afterward.
      */
     bool createBinary();
+    /** \brief Map the cached binary and load it into the program.
+     * Returns false when there is none or it does not match the key.
+     */
+    bool loadBinary();
     /** \breif Error reporting. 
      */
     string getError();
@@ -80,7 +125,21 @@ public:
     /** Variables **/
     //! The shader program object.
     GLuint Program;
+    //! The preprocessor definitions the program was compiled with.
+    vector<string> defines;
 protected:
+    //! \brief Print the compile log of a shader, returning whether it compiled.
+    bool shaderLog(GLuint shaderobj, string fpath);
+    /** \brief The header at the front of a cached binary.  The key
+     * must match before the binary is handed to the driver.
+     */
+    struct BinaryHeader {
+        char magic[4];
+        uint32_t version;
+        uint64_t key;
+        uint32_t format;
+        uint32_t length;
+    };
     /** Interesting that the shader code has to be wrapped
      *  inside an array.
      */
@@ -91,13 +150,11 @@ protected:
     //! Length of an OpenGL error message.
     int infoLength = 0;
     //! Handles for vertex and fragment shaders respectively.
-    GLuint vertex, fragment;
+    GLuint vertex = 0, fragment = 0;
     //! The length of the program in bytes.
     int progLength = 0;
     //! The length of the program binary in bytes.
     int progLenRet = 0;
-    //! Formats for the stored binary program.
-    GLenum *valFormats;
     //! The value of an individual format type.
     GLenum format = 0;
     //! A name for the shader.
@@ -107,9 +164,19 @@ protected:
     //! The binary program pointer.
     unsigned char *binary;
     /** The output file name.  The final stored binary is stored
-     * int the .config directory of the user's home directory (~/.config).
+     * in the .config directory of the user's home directory (~/.config).
      */
     string outputFile;
+    //! The cache key, a hash of the sources, definitions, renderer and version.
+    uint64_t key = 0;
+    //! Whether the program is being compiled and not yet checked.
+    bool compiling = false;
+    //! The programs started and not yet finished.
+    static vector<Shader*> pending;
+    //! The shader sources, kept to compile the variants.
+    string vertexPath, fragmentPath;
+    //! The variants of this shader by their extra definitions.
+    map<string, Shader*> variants;
     //! Debugging information.
     bool debug1 = false;
 };
@@ -0,0 +1,70 @@
+/**********************************************************
+ *   TextureCache:  A class to share the textures made from
+ *   image files across the whole program.  A texture is
+ *   keyed by the canonical paths of its images and by its
+ *   sampler settings, so an image used by several meshes
+ *   or models is decoded and uploaded once.  The textures
+ *   are reference counted and deleted with the last user.
+ *   Created by: Edward Charles Eberle <eberdeed@eberdeed.net>
+ *   October 2026 San Diego, California USA
+ * ********************************************************/
+
+#ifndef TEXTURECACHE_H
+#define TEXTURECACHE_H
+
+#include "commonheader.h"
+#include "resourceregistry.h"
+#include <map>
+
+/** \class TextureCache The one cache is shared().  Look a texture
+ * up with acquire(), and add it with insert() when it is not there.
+ * Every acquire() and insert() is paired with a release().  Only
+ * the context thread uses the cache.
+ */
+class TextureCache
+{
+public:
+    //! \brief Echo the creation of the class.
+    TextureCache();
+    //! \brief Echo the destruction of the class, the textures go with the context.
+    ~TextureCache();
+    /* Functions */
+    //! \brief The cache of the program.
+    static TextureCache &shared();
+    /** \brief The key of a texture made from the image files with the
+     * given sampler settings.
+     */
+    static string makeKey(vector<string> files, GLenum target, GLint wrap, GLint minFilter);
+    //! \brief The texture of the key with one more user, or 0 when it is not cached.
+    GLuint acquire(string key);
+    /** \brief Add a texture with one user.
+     * bytes : Its size in video memory, 0 until it is known.
+     */
+    void insert(string key, GLuint textureID, long bytes);
+    //! \brief Set the size of a texture once its image is in.
+    void setBytes(GLuint textureID, long bytes);
+    /** \brief Drop a user, deleting the texture with the last one.  Textures
+     * not in the cache are deleted.  Returns whether it was deleted.
+     */
+    bool release(GLuint textureID);
+    //! \brief Print the hits, the misses and the video memory saved.
+    void report();
+    /* Variables */
+    //! Lookups found and not found.
+    int hits = 0, misses = 0;
+    //! Debug flag.
+    bool debug1 = false;
+protected:
+    //! One cached texture.
+    struct Entry {
+        GLuint id = 0;
+        //! The current users and every user it has had.
+        int refs = 0, uses = 0;
+        long bytes = 0;
+    };
+    //! The textures by key, and the keys by texture.
+    map<string, Entry> entries;
+    map<GLuint, string> keys;
+};
+
+#endif // TEXTURECACHE_H
@@ -0,0 +1,90 @@
+/**********************************************************
+ *   TextureCompressor:  A class to turn decoded images into
+ *   ETC2 textures with their mipmaps, and to keep them in a
+ *   KTX file cache.  ETC2 is part of OpenGL ES 3.0, so the
+ *   blocks go to the driver as they are.  An opaque texture
+ *   takes half a byte a pixel and one with alpha a byte, an
+ *   eighth and a quarter of RGBA8, and a warm start reads
+ *   the blocks and the mipmaps instead of decoding the image
+ *   and building them.
+ *   Created by: Edward Charles Eberle <eberdeed@eberdeed.net>
+ *   October 2026 San Diego, California USA
+ * ********************************************************/
+
+#ifndef TEXTURECOMPRESSOR_H
+#define TEXTURECOMPRESSOR_H
+
+#include "commonheader.h"
+
+struct ImageData;
+
+//! A texture of ETC2 blocks with its mipmaps.
+struct CompressedImage {
+    //! GL_COMPRESSED_RGB8_ETC2 or GL_COMPRESSED_RGBA8_ETC2_EAC.
+    GLenum format = 0;
+    GLsizei width = 0;
+    GLsizei height = 0;
+    //! 1, or 6 for a sky box in OpenGL face order.
+    int faces = 1;
+    //! The blocks of each level, largest first, with the faces one after another.
+    vector<vector<unsigned char>> levels;
+    //! The finer levels left out, levels[0] is this level of the full width and height.
+    int base = 0;
+    //! \brief The video memory of all of the levels.
+    long bytes();
+};
+
+/** \class TextureCompressor Use load() to get the texture of some
+ * image files, from the cache when it is there and by decoding and
+ * compressing them when it is not.  The functions touch neither
+ * OpenGL nor shared state except upload(), so the rest run on the
+ * loader threads.
+ */
+class TextureCompressor
+{
+public:
+    /* Functions */
+    /** \brief Read the compressed texture of the image files, making
+     * and caching it the first time.  Returns false when an image will
+     * not load.
+     * imagefiles : One file, or six sky box faces in OpenGL face order.
+     */
+    static bool load(vector<string> imagefiles, CompressedImage &texture);
+    /** \brief Build the mipmaps of decoded images of one size and
+     * compress every level.
+     */
+    static void compress(vector<ImageData*> images, CompressedImage &texture);
+    /** \brief Put a compressed texture into an existing texture object.
+     * target : GL_TEXTURE_2D or GL_TEXTURE_CUBE_MAP.
+     */
+    static void upload(GLuint textureID, GLenum target, CompressedImage &texture);
+    //! \brief The cache file of the image files, named by their paths, sizes and times.
+    static string cachePath(vector<string> imagefiles);
+    //! \brief Write a KTX file.
+    static bool writeKTX(string path, CompressedImage &texture);
+    /** \brief Read a KTX file of ETC2 blocks.
+     * want : The size of the largest level used, the finer levels are
+     * skipped without being read.  0 reads every level.
+     */
+    static bool readKTX(string path, CompressedImage &texture, GLsizei want = 0);
+    //! \brief The bytes of one face of one level of ETC2 blocks.
+    static long levelSize(GLenum format, GLsizei width, GLsizei height);
+    /* Variables */
+    //! Turn the compressed textures off, for drivers without ETC2.
+    static bool enabled;
+    //! Debug flag.
+    static bool debug1;
+protected:
+    /** \brief Compress a 4x4 block of RGBA pixels to the 8 byte ETC2 color
+     * block in individual or differential mode.
+     */
+    static void encodeColor(const unsigned char block[64], unsigned char *output);
+    //! \brief Compress the alpha of a 4x4 block of RGBA pixels to an 8 byte EAC block.
+    static void encodeAlpha(const unsigned char block[64], unsigned char *output);
+    /** \brief The best table for a half block in its base color, with its
+     * modifier choices.  Returns the squared error.
+     */
+    static int fitHalf(const unsigned char block[64], const int pixels[8], const int base[3], int &table, int selectors[8]);
+};
+
+#endif // TEXTURECOMPRESSOR_H
@@ -0,0 +1,131 @@
+/**********************************************************
+ *   TextureStreamer:  A class to keep the textures of the
+ *   models within a video memory budget.  Each streamed
+ *   texture holds only the mipmap levels its largest
+ *   instance on screen can show, read again from the image
+ *   or its compressed cache file as the instances come
+ *   closer, and the levels of the textures least seen are
+ *   dropped first when the budget is passed.
+ *   Created by: Edward Charles Eberle <eberdeed@eberdeed.net>
+ *   October 2026 San Diego, California USA
+ * ********************************************************/
+
+#ifndef TEXTURESTREAMER_H
+#define TEXTURESTREAMER_H
+
+#include "commonheader.h"
+#include "assetloader.h"
+#include "texturecompressor.h"
+#include <map>
+
+struct ImageData;
+
+/** \class TextureStreamer The one streamer is shared().  A texture
+ * made by CreateImage::loadTexture() with streaming asked for is
+ * added with add(), and is its placeholder until it is asked for.
+ * Each frame the draws call request() with the projected size of
+ * the instances using a texture, and update() then changes the
+ * levels that are resident.  OpenGL ES 3.0 has no partial textures,
+ * so a change puts the texture in again from a finer or coarser level,
+ * under the same name.  Only the context thread uses the streamer.
+ */
+class TextureStreamer
+{
+public:
+    //! \brief Echo the creation of the class.
+    TextureStreamer();
+    //! \brief Echo the destruction of the class, the textures go with the context.
+    ~TextureStreamer();
+    /* Functions */
+    //! \brief The streamer of the program.
+    static TextureStreamer &shared();
+    //! \brief Stream an image into a texture holding its placeholder.
+    void add(GLuint textureID, string imagefile);
+    //! \brief Forget a texture once it is deleted.
+    void remove(GLuint textureID);
+    /** \brief Ask for a texture to be resident for an instance this frame.
+     * size : The projected size of the instance from Model::projectedSize(),
+     * a fraction of half the screen height.
+     */
+    void request(GLuint textureID, float size);
+    /** \brief Read the levels for an instance of a given size in pixels
+     * now, as for the impostors, unless a read is already running.
+     */
+    void prefetch(GLuint textureID, GLsizei pixels);
+    /** \brief Choose the levels of every texture for the frame and load
+     * or drop them, once a frame after the draws.
+     * loader : Read the images in the background, or here without one.
+     */
+    void update(AssetLoader *loader = nullptr);
+    //! \brief Set the video memory budget in bytes and turn streaming on.
+    void setBudget(long bytes);
+    //! \brief Print the textures, their resident bytes and the loads and drops so far.
+    void report();
+    /* Variables */
+    //! Stream the textures asked for, otherwise they load whole.
+    bool enabled = false;
+    //! The video memory of the streamed textures, in bytes.
+    long budget = 64L * 1024 * 1024;
+    //! Texels across the texture for each pixel across an instance.
+    float detail = 2.0f;
+    //! The finer levels being read at once.
+    int maxLoads = 2;
+    //! The frames a texture goes unseen before it is left its coarse levels.
+    long idleFrames = 300;
+    //! The size of the coarse levels an unseen texture keeps.
+    GLsizei idleSize = 32;
+    //! The levels read for finer textures and for dropped ones.
+    int loads = 0, drops = 0;
+    //! Debug flag.
+    bool debug1 = false;
+protected:
+    //! The levels read for one change, from the worker to the context thread.
+    struct Levels {
+        //! The levels from the first one kept, compressed or a decoded image.
+        CompressedImage compressed;
+        shared_ptr<ImageData> image;
+        //! The first level kept, counting from the full size.
+        int base = 0;
+        //! The full size and the video memory of each of its levels.
+        GLsizei width = 0, height = 0;
+        vector<long> levelBytes;
+        bool loaded = false;
+    };
+    //! One streamed texture.
+    struct Entry {
+        string file;
+        //! Tells this texture from a later one given the same name.
+        int serial = 0;
+        //! The full size and the video memory of each level, empty until first read.
+        GLsizei width = 0, height = 0;
+        vector<long> levelBytes;
+        //! The first resident level, -1 for the placeholder, and the levels in OpenGL.
+        int base = -1, count = 1;
+        //! The level chosen this frame and the one being read, -1 for none.
+        int target = -1, pending = -1;
+        //! The texels wanted across the texture, the frame it was last asked for.
+        float need = 0.0f;
+        long seen = -1;
+        //! Whether the budget moved the target.
+        bool pressed = false;
+    };
+    /** \brief Read an image from the first level no smaller than the
+     * given size, on any thread.
+     */
+    static bool read(string file, GLsizei want, Levels &levels);
+    //! \brief Put read levels into their texture and drop the levels past them.
+    void finish(GLuint textureID, int serial, Levels &levels);
+    //! \brief The video memory of a texture from a level down.
+    static long bytesFrom(const vector<long> &levelBytes, int level);
+    //! \brief The level chosen for a texture by its size on screen.
+    int chooseLevel(Entry &entry);
+    //! The textures by name.
+    map<GLuint, Entry> entries;
+    //! The frames counted by update(), and the serial of the next texture.
+    long frame = 0;
+    int serials = 0;
+    //! The finer levels being read now.
+    int loading = 0;
+};
+
+#endif // TEXTURESTREAMER_H
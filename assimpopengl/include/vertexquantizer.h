@@ -0,0 +1,69 @@
+/**********************************************************
+ *   VertexQuantizer:  A class to compress the Vertex and
+ *   Vertex1 arrays of a mesh into the VertexPacked and
+ *   Vertex1Packed layouts, halving the vertex bandwidth
+ *   and memory of a mesh.
+ *   Created by: Edward Charles Eberle <eberdeed@eberdeed.net>
+ *   October 2026 San Diego, California USA
+ * ********************************************************/
+
+#ifndef VERTEXQUANTIZER_H
+#define VERTEXQUANTIZER_H
+
+#include "commonheader.h"
+#include "mesh.h"
+
+//! Forward declarations so it can be used as a library.
+struct Vertex;
+struct Vertex1;
+struct VertexPacked;
+struct Vertex1Packed;
+class Mesh;
+
+/** \class VertexQuantizer Decides per mesh whether the
+ * compressed layout keeps enough precision and builds it.
+ * Positions and texture coordinates are stored as normalized
+ * 16 bit values relative to their bounds, which are handed to
+ * the mesh as posOffset, posScale, uvOffset and uvScale so the
+ * vertex shader can decode them.  Normals are octahedral encoded.
+ */
+class VertexQuantizer
+{
+public:
+    //! \brief Echo the creation of the class.
+    VertexQuantizer();
+    //! \brief Echo the destruction of the class.
+    ~VertexQuantizer();
+    /* Functions */
+    /** \brief Whether a textured mesh keeps its precision when packed.
+     */
+    bool canPack(Vertex *vertices, int vertSize);
+    /** \brief Whether an untextured mesh keeps its precision when packed.
+     */
+    bool canPack(Vertex1 *vertices, int vertSize);
+    /** \brief Pack a textured mesh and set the decode values on the mesh.
+     */
+    VertexPacked *pack(Vertex *vertices, int vertSize, Mesh *mesh);
+    /** \brief Pack an untextured mesh and set the decode values on the mesh.
+     */
+    Vertex1Packed *pack(Vertex1 *vertices, int vertSize, Mesh *mesh);
+    /** \brief Encode a unit normal into two signed normalized shorts.
+     */
+    void octEncode(const float *normal, short *encoded);
+    /* Variables */
+    //! The largest position error allowed, in model units.
+    float positionTolerance = 0.001f;
+    //! The largest texture coordinate error allowed.
+    float texTolerance = 1.0f / 8192.0f;
+    //! Debug flag.
+    bool debug1 = false;
+protected:
+    //! \brief Find the bounds of a strided float array.
+    void bounds(const float *data, int count, int stride, int width, float *low, float *high);
+    //! \brief Whether the normals of a strided float array are usable.
+    bool validNormals(const float *data, int count, int stride);
+    //! \brief A value in [low, high] as a normalized unsigned short.
+    unsigned short unorm16(float value, float low, float range);
+};
+
+#endif // VERTEXQUANTIZER_H
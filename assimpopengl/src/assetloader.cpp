@@ -0,0 +1,165 @@
+/**********************************************************
+ *   AssetLoader:  A class to load assets on worker threads
+ *   and upload them to OpenGL a slice at a time.
+ *   Created by: Edward Charles Eberle <eberdeed@eberdeed.net>
+ *   October 2026 San Diego, California USA
+ * ********************************************************/
+
+#include "../include/assetloader.h"
+
+AssetLoader::AssetLoader(int workers)
+{
+    cout << "\n\n\tCreating AssetLoader.\n\n";
+    start = chrono::steady_clock::now();
+    if (workers < 1)
+    {
+        workers = std::max(1, (int) thread::hardware_concurrency() - 1);
+    }
+    for (int x = 0; x < workers; x++)
+    {
+        this->workers.push_back(thread(&AssetLoader::work, this));
+    }
+    cout << "\n\n\tStarted " << workers << " loader threads.\n\n";
+}
+
+AssetLoader::~AssetLoader()
+{
+    cout << "\n\n\tDestroying AssetLoader.\n\n";
+    {
+        lock_guard<mutex> guard(lock);
+        stopping = true;
+        jobs.clear();
+    }
+    wake.notify_all();
+    for (unsigned int x = 0; x < workers.size(); x++)
+    {
+        workers[x].join();
+    }
+}
+
+void AssetLoader::submit(string name, Job job)
+{
+    {
+        lock_guard<mutex> guard(lock);
+        jobs.push_back(make_pair(name, job));
+    }
+    wake.notify_one();
+}
+
+void AssetLoader::post(Upload upload)
+{
+    {
+        lock_guard<mutex> guard(lock);
+        uploads.push_back(upload);
+    }
+    ready.notify_all();
+}
+
+void AssetLoader::work()
+{
+    while (true)
+    {
+        pair<string, Job> item;
+        {
+            unique_lock<mutex> guard(lock);
+            wake.wait(guard, [this]() { return (stopping) || (jobs.size() > 0); });
+            if (stopping)
+            {
+                return;
+            }
+            item = jobs.front();
+            jobs.pop_front();
+            running++;
+        }
+        if (debug1)
+        {
+            cout << "\n\tLoading " << item.first << ".";
+        }
+        Upload upload;
+        try
+        {
+            upload = item.second();
+        }
+        catch (exception exc)
+        {
+            cout << "\n\n\tError loading " << item.first << ":  " << exc.what() << "\n\n";
+        }
+        lock_guard<mutex> guard(lock);
+        if (upload)
+        {
+            uploads.push_back(upload);
+        }
+        running--;
+        jobsDone++;
+        ready.notify_all();
+    }
+}
+
+int AssetLoader::pump(float budget)
+{
+    chrono::steady_clock::time_point begin = chrono::steady_clock::now();
+    int ran = 0;
+    while (true)
+    {
+        Upload upload;
+        {
+            lock_guard<mutex> guard(lock);
+            if (uploads.size() < 1)
+            {
+                break;
+            }
+            upload = uploads.front();
+            uploads.pop_front();
+        }
+        //! An upload may queue more jobs or uploads, so the lock is not held.
+        upload();
+        ran++;
+        uploadsDone++;
+        if (chrono::duration<float, milli>(chrono::steady_clock::now() - begin).count() >= budget)
+        {
+            break;
+        }
+    }
+    if ((debug1) && (ran > 0))
+    {
+        cout << "\n\tUploaded " << ran << " assets in "
+        << chrono::duration<float, milli>(chrono::steady_clock::now() - begin).count() << " ms.";
+    }
+    return ran;
+}
+
+bool AssetLoader::idle()
+{
+    lock_guard<mutex> guard(lock);
+    return (jobs.size() < 1) && (uploads.size() < 1) && (running == 0);
+}
+
+void AssetLoader::finish()
+{
+    while (true)
+    {
+        pump(numeric_limits<float>::max());
+        unique_lock<mutex> guard(lock);
+        ready.wait(guard, [this]() { return (uploads.size() > 0) || ((jobs.size() < 1) && (running == 0)); });
+        if (uploads.size() < 1)
+        {
+            return;
+        }
+    }
+}
+
+void AssetLoader::frameDrawn()
+{
+    float elapsed = chrono::duration<float, milli>(chrono::steady_clock::now() - start).count();
+    if (firstFrame < 0.0f)
+    {
+        firstFrame = elapsed;
+        cout << "\n\n\tTime to first frame:  " << firstFrame << " ms.\n\n";
+    }
+    if ((fullQuality < 0.0f) && (idle()))
+    {
+        fullQuality = elapsed;
+        cout << "\n\n\tTime to full quality:  " << fullQuality << " ms, "
+        << jobsDone << " jobs and " << uploadsDone << " uploads.\n\n";
+    }
+}
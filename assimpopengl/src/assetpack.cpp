@@ -0,0 +1,564 @@
+/**********************************************************
+ *   AssetPack:  A class to serve the program's files out of
+ *   one mapped archive, stored or LZ4 compressed.
+ *   Created by: Edward Charles Eberle <eberdeed@eberdeed.net>
+ *   October 2026 San Diego, California USA
+ * ********************************************************/
+
+#include "../include/assetpack.h"
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+//! The start of a pack, the table of contents follows it.
+struct PackHeader {
+    char magic[4];
+    uint32_t version;
+    uint32_t entryCount;
+    uint32_t reserved;
+    uint64_t tocSize;
+    uint64_t length;
+};
+
+//! One file in the table of contents, its name follows it.
+struct PackRecord {
+    uint64_t offset, size, rawSize, hash;
+    uint32_t compressed, nameLength;
+};
+
+//! A path without "..", "." or a trailing slash, which normalizes to "/.".
+static string normalPath(string path)
+{
+    string normal = boost::filesystem::path(path).lexically_normal().string();
+    while ((normal.size() > 1) && ((normal.back() == '/') || ((normal.back() == '.') && (normal[normal.size() - 2] == '/'))))
+    {
+        normal.pop_back();
+    }
+    return normal;
+}
+
+AssetPack::AssetPack()
+{
+    cout << "\n\n\tCreating AssetPack.\n\n";
+}
+
+AssetPack::~AssetPack()
+{
+    cout << "\n\n\tDestroying AssetPack.\n\n";
+    if (mapped != nullptr)
+    {
+        munmap(mapped, mappedSize);
+    }
+}
+
+AssetPack &AssetPack::shared()
+{
+    static AssetPack pack;
+    return pack;
+}
+
+bool AssetPack::open(string packPath, string root)
+{
+    int fd = ::open(packPath.c_str(), O_RDONLY);
+    if (fd < 0)
+    {
+        cout << "\n\n\tNo asset pack at " << packPath << ", the files are read one by one.\n\n";
+        return false;
+    }
+    struct stat info;
+    if ((fstat(fd, &info) != 0) || (info.st_size < (off_t) sizeof(PackHeader)))
+    {
+        close(fd);
+        cout << "\n\n\tThe asset pack " << packPath << " is too short.\n\n";
+        return false;
+    }
+    size_t fileSize = info.st_size;
+    void *data = mmap(nullptr, fileSize, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (data == MAP_FAILED)
+    {
+        cout << "\n\n\tError mapping file " << packPath << ".\n\n";
+        return false;
+    }
+    //! Start reading the whole pack now, in order.
+    madvise(data, fileSize, MADV_WILLNEED);
+    const unsigned char *bytes = (const unsigned char*) data;
+    PackHeader header;
+    memcpy(&header, bytes, sizeof(header));
+    bool response = (memcmp(header.magic, "ACPK", 4) == 0) && (header.version == 1)
+    && (header.length == fileSize) && (header.tocSize <= fileSize - sizeof(header));
+    map<string, Entry> found;
+    size_t offset = sizeof(header), end = sizeof(header) + header.tocSize;
+    for (uint32_t x = 0; (response) && (x < header.entryCount); x++)
+    {
+        PackRecord record;
+        if (offset + sizeof(record) > end)
+        {
+            response = false;
+            break;
+        }
+        memcpy(&record, bytes + offset, sizeof(record));
+        offset += sizeof(record);
+        if ((record.nameLength > end - offset) || (record.offset > fileSize) || (record.size > fileSize - record.offset)
+            || ((!record.compressed) && (record.size != record.rawSize)))
+        {
+            response = false;
+            break;
+        }
+        Entry entry;
+        entry.offset = record.offset;
+        entry.size = record.size;
+        entry.rawSize = record.rawSize;
+        entry.hash = record.hash;
+        entry.compressed = record.compressed;
+        found[string((const char*) bytes + offset, record.nameLength)] = entry;
+        offset += record.nameLength;
+    }
+    if (!response)
+    {
+        munmap(data, fileSize);
+        cout << "\n\n\tThe asset pack " << packPath << " is damaged.\n\n";
+        return false;
+    }
+    if (mapped != nullptr)
+    {
+        munmap(mapped, mappedSize);
+    }
+    mapped = (unsigned char*) data;
+    mappedSize = fileSize;
+    entries.swap(found);
+    this->root = normalPath(root);
+    cout << "\n\n\tMapped the asset pack " << packPath << ", " << entries.size()
+    << " files in " << fileSize / 1024 << " KB.\n\n";
+    return true;
+}
+
+string AssetPack::packName(string path)
+{
+    if (mapped == nullptr)
+    {
+        return "";
+    }
+    string full = normalPath(path);
+    if ((full.size() <= root.size() + 1) || (full.compare(0, root.size(), root) != 0) || (full[root.size()] != '/'))
+    {
+        return "";
+    }
+    return full.substr(root.size() + 1);
+}
+
+bool AssetPack::contains(string path)
+{
+    string name = packName(path);
+    return (name.size() > 0) && (entries.count(name) > 0);
+}
+
+bool AssetPack::has(string path)
+{
+    return (contains(path)) || (exists(boost::filesystem::path(path)));
+}
+
+bool AssetPack::view(string path, PackView &contents)
+{
+    string name = packName(path);
+    auto found = (name.size() > 0) ? entries.find(name) : entries.end();
+    if (found == entries.end())
+    {
+        return false;
+    }
+    Entry &entry = found->second;
+    contents.owned.reset();
+    if (!entry.compressed)
+    {
+        //! A stored file is read where it is in the mapping.
+        contents.data = mapped + entry.offset;
+        contents.size = entry.size;
+        return true;
+    }
+    contents.owned = make_shared<vector<unsigned char>>(entry.rawSize);
+    if (!decompressLZ4(mapped + entry.offset, entry.size, contents.owned->data(), entry.rawSize))
+    {
+        cout << "\n\n\tThe packed file " << name << " is damaged.\n\n";
+        contents.owned.reset();
+        return false;
+    }
+    contents.data = contents.owned->data();
+    contents.size = entry.rawSize;
+    if (debug1)
+    {
+        cout << "\n\tDecompressed " << name << " from " << entry.size << " to " << entry.rawSize << " bytes.";
+    }
+    return true;
+}
+
+bool AssetPack::contentHash(string path, uint64_t &hash)
+{
+    string name = packName(path);
+    auto found = (name.size() > 0) ? entries.find(name) : entries.end();
+    if (found == entries.end())
+    {
+        return false;
+    }
+    hash = found->second.hash;
+    return true;
+}
+
+vector<string> AssetPack::list(string directory)
+{
+    vector<string> files;
+    if (mapped == nullptr)
+    {
+        return files;
+    }
+    string prefix;
+    if (normalPath(directory) != root)
+    {
+        prefix = packName(directory);
+        if (prefix.size() == 0)
+        {
+            return files;
+        }
+        prefix += "/";
+    }
+    for (auto item = entries.lower_bound(prefix); item != entries.end(); item++)
+    {
+        if (item->first.compare(0, prefix.size(), prefix) != 0)
+        {
+            break;
+        }
+        if (item->first.find('/', prefix.size()) == string::npos)
+        {
+            files.push_back(root + "/" + item->first);
+        }
+    }
+    return files;
+}
+
+bool AssetPack::build(string root, string packPath, bool compress)
+{
+    boost::system::error_code error;
+    boost::filesystem::path base = canonical(boost::filesystem::path(root), error);
+    if (error)
+    {
+        cout << "\n\n\tError:  No directory " << root << " to pack.\n\n";
+        return false;
+    }
+    boost::filesystem::path output = boost::filesystem::absolute(boost::filesystem::path(packPath)).lexically_normal();
+    vector<string> names;
+    for (boost::filesystem::recursive_directory_iterator item(base, error), end; (!error) && (item != end); item.increment(error))
+    {
+        if ((is_regular_file(item->path())) && (item->path().lexically_normal() != output))
+        {
+            names.push_back(item->path().lexically_relative(base).string());
+        }
+    }
+    sort(names.begin(), names.end());
+    vector<PackRecord> records(names.size());
+    vector<vector<unsigned char>> blobs(names.size());
+    uint64_t tocSize = 0, rawTotal = 0;
+    for (unsigned int x = 0; x < names.size(); x++)
+    {
+        boost::filesystem::path file = base / names[x];
+        vector<unsigned char> raw(file_size(file, error));
+        boost::filesystem::ifstream input(file, ios_base::in | ios_base::binary);
+        if ((error) || (!input.is_open()) || (!input.read((char*) raw.data(), raw.size())))
+        {
+            cout << "\n\n\tError reading " << file.string() << ".\n\n";
+            return false;
+        }
+        PackRecord &record = records[x];
+        record.rawSize = raw.size();
+        record.nameLength = names[x].size();
+        record.hash = 14695981039346656037ull;
+        for (size_t y = 0; y < raw.size(); y++)
+        {
+            record.hash = (record.hash ^ raw[y]) * 1099511628211ull;
+        }
+        record.compressed = 0;
+        if (compress)
+        {
+            vector<unsigned char> packed = compressLZ4(raw.data(), raw.size());
+            //! Compressed images and the like are stored as they are.
+            if (packed.size() <= raw.size() - raw.size() / 8)
+            {
+                raw.swap(packed);
+                record.compressed = 1;
+            }
+        }
+        record.size = raw.size();
+        blobs[x].swap(raw);
+        tocSize += sizeof(PackRecord) + names[x].size();
+        rawTotal += record.rawSize;
+    }
+    //! The files start on 64 byte boundaries after the table of contents.
+    uint64_t offset = sizeof(PackHeader) + tocSize;
+    for (unsigned int x = 0; x < records.size(); x++)
+    {
+        offset = (offset + 63) & ~(uint64_t) 63;
+        records[x].offset = offset;
+        offset += records[x].size;
+    }
+    PackHeader header;
+    memcpy(header.magic, "ACPK", 4);
+    header.version = 1;
+    header.entryCount = records.size();
+    header.reserved = 0;
+    header.tocSize = tocSize;
+    header.length = offset;
+    string partial = packPath + "." + to_string(getpid());
+    boost::filesystem::ofstream pack(partial, ios_base::out | ios_base::binary);
+    if (!pack.is_open())
+    {
+        cout << "\n\n\tError opening " << partial << ".\n\n";
+        return false;
+    }
+    pack.write((const char*) &header, sizeof(header));
+    for (unsigned int x = 0; x < records.size(); x++)
+    {
+        pack.write((const char*) &records[x], sizeof(PackRecord));
+        pack.write(names[x].data(), names[x].size());
+    }
+    uint64_t written = sizeof(PackHeader) + tocSize;
+    const char padding[64] = {0};
+    for (unsigned int x = 0; x < records.size(); x++)
+    {
+        pack.write(padding, records[x].offset - written);
+        pack.write((const char*) blobs[x].data(), blobs[x].size());
+        written = records[x].offset + records[x].size;
+    }
+    pack.close();
+    if (pack.fail())
+    {
+        cout << "\n\n\tError writing " << partial << ".\n\n";
+        remove(boost::filesystem::path(partial), error);
+        return false;
+    }
+    rename(boost::filesystem::path(partial), boost::filesystem::path(packPath), error);
+    if (error)
+    {
+        cout << "\n\n\tError naming the pack " << packPath << ".\n\n";
+        return false;
+    }
+    cout << "\n\n\tPacked " << records.size() << " files of " << rawTotal / 1024 << " KB into "
+    << written / 1024 << " KB at " << packPath << ".\n\n";
+    return true;
+}
+
+//! \brief Write an LZ4 length past the 15 held in the token.
+static void lz4Length(vector<unsigned char> &output, size_t length)
+{
+    while (length >= 255)
+    {
+        output.push_back(255);
+        length -= 255;
+    }
+    output.push_back((unsigned char) length);
+}
+
+vector<unsigned char> AssetPack::compressLZ4(const unsigned char *source, size_t size)
+{
+    vector<unsigned char> output;
+    output.reserve(size + size / 255 + 16);
+    //! The last match starts 12 bytes from the end and the last 5 bytes are literals.
+    const size_t endMatch = 12, lastLiterals = 5;
+    vector<int64_t> table(1 << 16, -1);
+    size_t anchor = 0, position = 0;
+    while ((size > endMatch) && (position < size - endMatch))
+    {
+        uint32_t sequence;
+        memcpy(&sequence, source + position, 4);
+        uint32_t hash = (sequence * 2654435761u) >> 16;
+        int64_t reference = table[hash];
+        table[hash] = position;
+        uint32_t previous = 0;
+        if (reference >= 0)
+        {
+            memcpy(&previous, source + reference, 4);
+        }
+        if ((reference < 0) || (position - reference > 65535) || (previous != sequence))
+        {
+            position++;
+            continue;
+        }
+        size_t length = 4, longest = size - lastLiterals - position;
+        while ((length < longest) && (source[reference + length] == source[position + length]))
+        {
+            length++;
+        }
+        size_t literals = position - anchor;
+        output.push_back((unsigned char) ((std::min(literals, (size_t) 15) << 4) | std::min(length - 4, (size_t) 15)));
+        if (literals >= 15)
+        {
+            lz4Length(output, literals - 15);
+        }
+        output.insert(output.end(), source + anchor, source + position);
+        size_t distance = position - reference;
+        output.push_back((unsigned char) (distance & 0xFF));
+        output.push_back((unsigned char) (distance >> 8));
+        if (length - 4 >= 15)
+        {
+            lz4Length(output, length - 4 - 15);
+        }
+        position += length;
+        anchor = position;
+    }
+    size_t literals = size - anchor;
+    output.push_back((unsigned char) (std::min(literals, (size_t) 15) << 4));
+    if (literals >= 15)
+    {
+        lz4Length(output, literals - 15);
+    }
+    output.insert(output.end(), source + anchor, source + size);
+    return output;
+}
+
+bool AssetPack::decompressLZ4(const unsigned char *source, size_t size, unsigned char *target, size_t targetSize)
+{
+    size_t input = 0, output = 0;
+    while (input < size)
+    {
+        unsigned char token = source[input++];
+        size_t literals = token >> 4;
+        if (literals == 15)
+        {
+            unsigned char more;
+            do
+            {
+                if (input >= size)
+                {
+                    return false;
+                }
+                more = source[input++];
+                literals += more;
+            } while (more == 255);
+        }
+        if ((literals > size - input) || (literals > targetSize - output))
+        {
+            return false;
+        }
+        memcpy(target + output, source + input, literals);
+        input += literals;
+        output += literals;
+        //! The last sequence has only literals.
+        if (input >= size)
+        {
+            break;
+        }
+        if (size - input < 2)
+        {
+            return false;
+        }
+        size_t distance = source[input] | (source[input + 1] << 8);
+        input += 2;
+        if ((distance == 0) || (distance > output))
+        {
+            return false;
+        }
+        size_t length = token & 15;
+        if (length == 15)
+        {
+            unsigned char more;
+            do
+            {
+                if (input >= size)
+                {
+                    return false;
+                }
+                more = source[input++];
+                length += more;
+            } while (more == 255);
+        }
+        length += 4;
+        if (length > targetSize - output)
+        {
+            return false;
+        }
+        //! The match may overlap what it is copying, so it goes a byte at a time.
+        for (size_t x = 0; x < length; x++, output++)
+        {
+            target[output] = target[output - distance];
+        }
+    }
+    return output == targetSize;
+}
+
+PackIOStream::PackIOStream(PackView contents)
+{
+    this->contents = contents;
+}
+
+size_t PackIOStream::Read(void *buffer, size_t size, size_t count)
+{
+    if (size == 0)
+    {
+        return 0;
+    }
+    size_t items = std::min(count, (contents.size - position) / size);
+    memcpy(buffer, contents.data + position, items * size);
+    position += items * size;
+    return items;
+}
+
+size_t PackIOStream::Write(const void *buffer, size_t size, size_t count)
+{
+    return 0;
+}
+
+aiReturn PackIOStream::Seek(size_t offset, aiOrigin origin)
+{
+    size_t target = offset;
+    if (origin == aiOrigin_CUR)
+    {
+        target = position + offset;
+    }
+    else if (origin == aiOrigin_END)
+    {
+        target = contents.size - offset;
+    }
+    if (target > contents.size)
+    {
+        return aiReturn_FAILURE;
+    }
+    position = target;
+    return aiReturn_SUCCESS;
+}
+
+size_t PackIOStream::Tell() const
+{
+    return position;
+}
+
+size_t PackIOStream::FileSize() const
+{
+    return contents.size;
+}
+
+void PackIOStream::Flush()
+{
+}
+
+bool PackIOSystem::Exists(const char *file) const
+{
+    return (AssetPack::shared().contains(file)) || (DefaultIOSystem::Exists(file));
+}
+
+Assimp::IOStream *PackIOSystem::Open(const char *file, const char *mode)
+{
+    PackView contents;
+    if ((strchr(mode, 'w') == nullptr) && (AssetPack::shared().view(file, contents)))
+    {
+        return new PackIOStream(contents);
+    }
+    return DefaultIOSystem::Open(file, mode);
+}
+
+void PackIOSystem::Close(Assimp::IOStream *file)
+{
+    if (dynamic_cast<PackIOStream*>(file) != nullptr)
+    {
+        delete file;
+        return;
+    }
+    DefaultIOSystem::Close(file);
+}
@@ -9,6 +9,9 @@
 
 #include "../include/createimage.h"
 
+int CreateImage::decodeTier = 0;
+GLsizei CreateImage::decodeLimit = 0;
+
 CreateImage::CreateImage()
 {
     cout << "\n\n\tCreating CreateImage.\n\n";
@@ -17,23 +20,66 @@ CreateImage::CreateImage()
 CreateImage::~CreateImage()
 {
     cout << "\n\n\tDestroying CreateImage.\n\n";
+    ResourceRegistry::shared().releaseHeap(&image);
 }
 
-bool CreateImage::setImage(string imagefile)
+bool CreateImage::setImage(string imagefile, int tier)
 {
     cout << "\n\n\tIn setImage().\n\n";
-    //imagefile = "../images/" + imagefile;
+    if (!decodeImage(imagefile, image, tier))
+    {
+        return false;
+    }
+    this->imagefile = imagefile;
+    this->tier = tier;
+    width = image.width;
+    height = image.height;
+    size = width * height * 4;
+    line = width * 4;
+    pixels = image.pixels.data();
+    ResourceRegistry::shared().trackHeap(&image, "Images", image.pixels.capacity());
+    return true;
+}
+
+bool CreateImage::decodeImage(string imagefile, ImageData &image, int tier)
+{
+    fipImage txtImage;
+    //! The largest side wanted, 0 for the full size.
+    GLsizei target = 0;
     try
     {
-        //! Free Image Plus Image loads standard picture.
-        if (!txtImage.load(imagefile.c_str()))
+        //! Free Image Plus Image loads standard picture, from the pack in place.
+        PackView packed;
+        bool inPack = AssetPack::shared().view(imagefile, packed), loaded;
+        FREE_IMAGE_FORMAT format = (inPack) ? fipMemoryIO((BYTE*) packed.data, packed.size).getFileType()
+        : fipImage::identifyFIF(imagefile.c_str());
+        int flag = 0;
+        if ((format == FIF_JPEG) && ((decodeHalvings(1, 1, tier) > 0) || ((tier < 0) && (decodeLimit > 0))))
         {
-            cout << "\n\n\tImage file " << imagefile << " failed to load in createimage.\n";
-            return false;
+            //! The JPEG decoder scales its DCT to 1/2, 1/4 or 1/8 of the size in the
+            //! header, given the size wanted above the flags.
+            fipImage header;
+            fipMemoryIO memory((BYTE*) packed.data, packed.size);
+            if ((inPack) ? header.loadFromMemory(memory, FIF_LOAD_NOPIXELS) : header.load(imagefile.c_str(), FIF_LOAD_NOPIXELS))
+            {
+                GLsizei largest = std::max(header.getWidth(), header.getHeight());
+                target = largest >> decodeHalvings(header.getWidth(), header.getHeight(), tier);
+                flag = (target < largest) ? (target << 16) : 0;
+            }
         }
-        else if (debug1)
+        if (inPack)
         {
-            cout << "\n\n\tImage file " << imagefile << " successfully loaded.\n\n";
+            fipMemoryIO memory((BYTE*) packed.data, packed.size);
+            loaded = txtImage.loadFromMemory(memory, flag);
+        }
+        else
+        {
+            loaded = txtImage.load(imagefile.c_str(), flag);
+        }
+        if (!loaded)
+        {
+            cout << "\n\n\tImage file " << imagefile << " failed to load in createimage.\n";
+            return false;
         }
     }
     catch (exception exc)
@@ -41,44 +87,205 @@ bool CreateImage::setImage(string imagefile)
         cout << "\n\n\tError loading file " << imagefile << " : " << exc.what() << "\n\n";
         return false;
     }
-    size = 0;
-    int counter = 0;
-    //! Convert image to four 8 bit fields RGBA.
+    //! Convert image to four 8 bit fields, BGRA in memory.
     txtImage.convertTo32Bits();
-    width = (GLsizei) txtImage.getWidth();
-    height = (GLsizei) txtImage.getHeight();
-    size = width * height * 4;
-    line = width * 4;
-    ivec4 test;
-    // Load the image into an unsigned char array.
-    pixels = new unsigned char[size];
-    for (unsigned int y = 0; y < height; y++)
+    image.width = (GLsizei) txtImage.getWidth();
+    image.height = (GLsizei) txtImage.getHeight();
+    //! Where the driver takes BGRA the bytes go as they are.
+    bool swap = !GLEW_EXT_texture_format_BGRA8888;
+    image.format = (swap) ? GL_RGBA : GL_BGRA_EXT;
+    int line = image.width * 4;
+    //! Resizing keeps the capacity, so a reused ImageData is not reallocated.
+    image.pixels.resize(image.height * line);
+    unsigned char *pixels = image.pixels.data();
+    for (unsigned int y = 0; y < image.height; y++)
+    {
+        convertLine(txtImage.getScanLine(y), pixels + y * line, image.width, swap);
+    }
+    txtImage.clear();
+    //! Other formats, or a JPEG decoder that did not scale, are boxed down to the size.
+    if (target == 0)
+    {
+        target = std::max(image.width, image.height) >> decodeHalvings(image.width, image.height, tier);
+    }
+    while ((std::max(image.width, image.height) / 2 >= target) && (std::max(image.width, image.height) > 1))
+    {
+        halveImage(image);
+    }
+    return true;
+}
+
+int CreateImage::decodeHalvings(GLsizei width, GLsizei height, int tier)
+{
+    int halvings = std::min(std::max((tier < 0) ? decodeTier : tier, 0), 3);
+    GLsizei largest = std::max(width, height);
+    while ((tier < 0) && (decodeLimit > 0) && (halvings < 3) && ((largest >> halvings) > decodeLimit))
     {
-        picLine = txtImage.getScanLine(y);
-        for (unsigned int x = 0; x < line; x += 4)
+        halvings++;
+    }
+    return halvings;
+}
+
+void CreateImage::setDecodeBudget(long budget, int textures)
+{
+    //! A texture with its mipmaps takes four thirds of four bytes a texel.
+    long share = budget / std::max(textures, 1);
+    decodeLimit = 1;
+    while ((long) decodeLimit * 2 * decodeLimit * 2 * 16 / 3 <= share)
+    {
+        decodeLimit *= 2;
+    }
+    cout << "\n\n\tImages decoded to at most " << decodeLimit << " pixels a side.\n\n";
+}
+
+bool CreateImage::decodeImages(vector<string> imagefiles, ImageData *images)
+{
+    vector<thread> decoders;
+    //! Not vector<bool>, the threads write their own elements.
+    vector<char> loaded(imagefiles.size(), 0);
+    //! No more threads than cores, each takes the next image until none are left.
+    //! The AssetLoader workers are not used, this is often called from one of them.
+    int threads = std::min(std::max(1, (int) thread::hardware_concurrency()), (int) imagefiles.size());
+    atomic<int> next(0);
+    auto decode = [&imagefiles, images, &loaded, &next]()
+    {
+        for (int x = next++; x < (int) imagefiles.size(); x = next++)
         {
-            if (counter > size)
-            {
-                continue;
-            }
-            test.x = counter;
-            pixels[counter++] = (unsigned char) picLine[x + 2];
-            test.y = counter;
-            pixels[counter++] = (unsigned char) picLine[x + 1];
-            test.z = counter;
-            pixels[counter++] = (unsigned char) picLine[x];
-            test.w = counter;
-            pixels[counter++] = (unsigned char) picLine[x + 3];
-            if (int(pixels[test.w]) == 0)
+            loaded[x] = decodeImage(imagefiles[x], images[x]);
+        }
+    };
+    for (int x = 1; x < threads; x++)
+    {
+        decoders.push_back(thread(decode));
+    }
+    decode();
+    for (unsigned int x = 0; x < decoders.size(); x++)
+    {
+        decoders[x].join();
+    }
+    bool result = true;
+    for (unsigned int x = 0; x < loaded.size(); x++)
+    {
+        result = (result) && (loaded[x]);
+    }
+    return result;
+}
+
+void CreateImage::convertLine(const BYTE *source, unsigned char *target, int count, bool swap)
+{
+    int x = 0;
+#ifdef __SSE2__
+    const __m128i greenAlpha = _mm_set1_epi32((int) 0xFF00FF00);
+    const __m128i redBlue = _mm_set1_epi32(0x00FF00FF);
+    const __m128i zero = _mm_setzero_si128();
+    for (; x + 4 <= count; x += 4)
+    {
+        __m128i pixel = _mm_loadu_si128((const __m128i*) (source + x * 4));
+        if (swap)
+        {
+            //! Blue and red trade places, green and alpha stay.
+            __m128i swapped = _mm_and_si128(pixel, redBlue);
+            swapped = _mm_or_si128(_mm_srli_epi32(swapped, 16), _mm_slli_epi32(swapped, 16));
+            pixel = _mm_or_si128(_mm_and_si128(pixel, greenAlpha), _mm_and_si128(swapped, redBlue));
+        }
+        //! Pixels with no alpha become all zero.
+        __m128i clear = _mm_cmpeq_epi32(_mm_srli_epi32(pixel, 24), zero);
+        pixel = _mm_andnot_si128(clear, pixel);
+        _mm_storeu_si128((__m128i*) (target + x * 4), pixel);
+    }
+#endif
+    for (; x < count; x++)
+    {
+        uint32_t pixel;
+        memcpy(&pixel, source + x * 4, 4);
+        if (swap)
+        {
+            pixel = (pixel & 0xFF00FF00) | ((pixel >> 16) & 0xFF) | ((pixel & 0xFF) << 16);
+        }
+        if ((pixel >> 24) == 0)
+        {
+            pixel = 0;
+        }
+        memcpy(target + x * 4, &pixel, 4);
+    }
+}
+
+void CreateImage::halveImage(ImageData &image)
+{
+    GLsizei width = std::max(1, image.width / 2), height = std::max(1, image.height / 2);
+    //! An odd last row or column is left out, and a side of one pixel is taken twice.
+    int stepX = (image.width > 1) ? 4 : 0, stepY = (image.height > 1) ? image.width * 4 : 0;
+    unsigned char *pixels = image.pixels.data();
+    for (GLsizei y = 0; y < height; y++)
+    {
+        const unsigned char *row = pixels + (size_t) y * 2 * image.width * 4;
+        unsigned char *target = pixels + (size_t) y * width * 4;
+        for (GLsizei x = 0; x < width; x++, row += 8, target += 4)
+        {
+            //! In place, each output pixel is behind the inputs still to be read.
+            for (int c = 0; c < 4; c++)
             {
-                pixels[test.x] = pixels[test.y] = pixels[test.z] = 0;
+                target[c] = (row[c] + row[c + stepX] + row[c + stepY] + row[c + stepX + stepY] + 2) >> 2;
             }
-            
-                
         }
     }
-    txtImage.clear();
-    return true;
+    image.width = width;
+    image.height = height;
+    image.pixels.resize((size_t) width * height * 4);
+}
+
+GLuint CreateImage::placeholderTexture(GLenum target, const unsigned char color[4])
+{
+    GLuint textureID;
+    glGenTextures(1, &textureID);
+    glBindTexture(target, textureID);
+    if (target == GL_TEXTURE_CUBE_MAP)
+    {
+        for (int i = 0; i < 6; i++)
+        {
+            glTexImage2D(GL_TEXTURE_CUBE_MAP_POSITIVE_X + i, 0, GL_RGBA, 1, 1, 0, GL_RGBA, GL_UNSIGNED_BYTE, color);
+        }
+        glTexParameteri(target, GL_TEXTURE_WRAP_R, GL_CLAMP_TO_EDGE);
+    }
+    else
+    {
+        glTexImage2D(target, 0, GL_RGBA, 1, 1, 0, GL_RGBA, GL_UNSIGNED_BYTE, color);
+    }
+    //! No mipmaps yet, so the placeholder must not ask for them.
+    glTexParameteri(target, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(target, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glBindTexture(target, 0);
+    return textureID;
+}
+
+void CreateImage::uploadTexture(GLuint textureID, ImageData &image)
+{
+    glBindTexture(GL_TEXTURE_2D, textureID);
+    glTexImage2D(GL_TEXTURE_2D, 0, image.format, image.width, image.height, 0, image.format, GL_UNSIGNED_BYTE, image.pixels.data());
+    glGenerateMipmap(GL_TEXTURE_2D);    
+    glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT );
+    glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT );
+    glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR );
+    glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glBindTexture(GL_TEXTURE_2D, 0);
+}
+
+void CreateImage::uploadSkyBoxTex(GLuint textureID, ImageData faces[6])
+{
+    glBindTexture(GL_TEXTURE_CUBE_MAP, textureID);
+    for (int i = 0; i < 6; i++)
+    {
+        //! The order of images in a skybox is reversed.
+        glTexImage2D(GL_TEXTURE_CUBE_MAP_POSITIVE_X + i, 0, faces[5 - i].format, faces[5 - i].width, faces[5 - i].height, 
+        0, faces[5 - i].format, GL_UNSIGNED_BYTE, faces[5 - i].pixels.data());
+    }
+    glGenerateMipmap(GL_TEXTURE_CUBE_MAP);    
+    glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+    glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_R, GL_CLAMP_TO_EDGE);
+    glBindTexture(GL_TEXTURE_CUBE_MAP, 0);
 }
 
 //! Accessor functions to pass along the data.
@@ -99,28 +306,44 @@ GLsizei CreateImage::getSize()
 
 GLvoid *CreateImage::getData()
 {
+    if ((pixels == nullptr) && (!imagefile.empty()))
+    {
+        setImage(imagefile, tier);
+    }
     return (GLvoid*) pixels;
 }
 
+void CreateImage::releaseImage()
+{
+    ResourceRegistry::shared().releaseHeap(&image);
+    vector<unsigned char>().swap(image.pixels);
+    pixels = nullptr;
+}
+
 //! Use the CreateImage class to turn an image into a texture.
 GLuint CreateImage::textureObject()
 {
     //Generate texture ID and load texture data 
     GLuint textureID;
     glGenTextures(1, &textureID);
-    GLsizei width, height;
-    width = getWidth();
-    height = getHeight();
-    GLvoid *image = getData();
-    glBindTexture(GL_TEXTURE_2D, textureID);
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, image);
-    glGenerateMipmap(GL_TEXTURE_2D);    
-    // Parameters
-    glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT );
-    glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT );
-    glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR );
-    glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-    glBindTexture(GL_TEXTURE_2D, 0);
+    uploadTexture(textureID, image);
+    bytes = textureBytes(width, height);
+    //! OpenGL has its own copy now.
+    if (!keepPixels)
+    {
+        releaseImage();
+    }
+    return textureID;
+}
+
+GLuint CreateImage::textureObject(CompressedImage &texture)
+{
+    GLuint textureID;
+    glGenTextures(1, &textureID);
+    TextureCompressor::upload(textureID, GL_TEXTURE_2D, texture);
+    width = texture.width;
+    height = texture.height;
+    bytes = texture.bytes();
     return textureID;
 }
 
@@ -134,64 +357,68 @@ void CreateImage::createSkyBoxTex(GLuint &textureID, string filenames[6])
     // -Y (bottom)
     // +Z (front) 
     // -Z (back)
-    GLsizei width, height;
-    void *pixel_data = nullptr;
-    glGenTextures(1, &textureID);
-    glBindTexture(GL_TEXTURE_CUBE_MAP, textureID);
-    //! Six images, one texture ID.
-    for (int i = 0; i < 6; i++)
+    if (TextureCompressor::enabled)
     {
-        //! The order of images in a skybox is reversed.\n\n';
-        if (setImage(filenames[5 - i]))
-        {
-            width = getWidth();
-            height = getHeight();
-            pixel_data = getData();
-            glTexImage2D(GL_TEXTURE_CUBE_MAP_POSITIVE_X + i, 0, GL_RGBA, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, pixel_data);
-        }
-        else
+        //! The compressed faces are kept in OpenGL order, the reverse of the files.
+        CompressedImage texture;
+        if (!TextureCompressor::load(skyBoxOrder(filenames), texture))
         {
             cout << "\n\n\tImage load failure.  "
             << "Only a partial load is present.\n\n";
             exit(-1);
         }
+        glGenTextures(1, &textureID);
+        TextureCompressor::upload(textureID, GL_TEXTURE_CUBE_MAP, texture);
+        width = texture.width;
+        height = texture.height;
+        bytes = texture.bytes();
+        return;
     }
-    glGenerateMipmap(GL_TEXTURE_CUBE_MAP);    
-    glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-    glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
-    glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-    glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-    glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_R, GL_CLAMP_TO_EDGE);
-    glBindTexture(GL_TEXTURE_CUBE_MAP, 0);
-    
+    ImageData faces[6];
+    //! The six faces are decoded side by side.
+    if (!decodeImages(vector<string>(filenames, filenames + 6), faces))
+    {
+        cout << "\n\n\tImage load failure.  "
+        << "Only a partial load is present.\n\n";
+        exit(-1);
+    }
+    width = faces[0].width;
+    height = faces[0].height;
+    bytes = textureBytes(width, height, 6);
+    glGenTextures(1, &textureID);
+    uploadSkyBoxTex(textureID, faces);
     return;
 }
 void CreateImage::create2DTexArray(GLuint &textureID,  vector<string>filenames)
 {
     glGenTextures(1, &textureID);
     glBindTexture(GL_TEXTURE_2D_ARRAY, textureID);
-    int count = 0;
-    if (setImage(filenames[0]))
+    vector<ImageData> layers(filenames.size());
+    if (decodeImages(filenames, layers.data()))
     {
+        width = layers[0].width;
+        height = layers[0].height;
+        size = width * height * 4;
         unsigned char *pixel_data = new unsigned char[size * filenames.size()];
-        for (int x = 0 * size; x < size; x++)
+        //! BGRA is only taken by glTexImage2D(), so the layers go as RGBA.
+        for (int i = 0; i < filenames.size(); i++)
         {
-            pixel_data[count++] = pixels[x];
-        }
-        for (int i = 1; i < filenames.size(); i++)
-        {
-            setImage(filenames[i]);
-            for (int x = 0; x < size; x++)
+            if (layers[i].format == GL_BGRA_EXT)
+            {
+                convertLine(layers[i].pixels.data(), pixel_data + i * size, width * height, true);
+            }
+            else
             {
-                pixel_data[count++] = pixels[x];
+                memcpy(pixel_data + i * size, layers[i].pixels.data(), size);
             }
         }
         if (debug1)
         {
-            cout << "\n\n\tPixels loaded:  " << count 
+            cout << "\n\n\tPixels loaded:  " << size * filenames.size() 
             << "  Pixels calculated:  " << filenames.size() * size << "\n\n";
         }
         glTexImage3D(GL_TEXTURE_2D_ARRAY, 0, GL_RGBA, width, height, filenames.size(), 0, GL_RGBA, GL_UNSIGNED_BYTE, (GLvoid*) pixel_data);
+        delete[] pixel_data;
         glGenerateMipmap(GL_TEXTURE_2D_ARRAY);
         glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
         glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
@@ -207,3 +434,170 @@ void CreateImage::create2DTexArray(GLuint &textureID,  vector<string>filenames)
     }
     return;
 }
+
+GLuint CreateImage::loadTexture(string imagefile, AssetLoader *loader, const unsigned char *placeholder, bool streamed)
+{
+    static const unsigned char grey[4] = {128, 128, 128, 255};
+    TextureCache &cache = TextureCache::shared();
+    streamed = (streamed) && (TextureStreamer::shared().enabled);
+    string key = TextureCache::makeKey({imagefile}, GL_TEXTURE_2D, GL_REPEAT, GL_LINEAR_MIPMAP_LINEAR);
+    //! A streamed texture is not the whole one asked for by others.
+    if (streamed)
+    {
+        key += ":streamed";
+    }
+    GLuint textureID = cache.acquire(key);
+    if (textureID > 0)
+    {
+        return textureID;
+    }
+    if (streamed)
+    {
+        textureID = placeholderTexture(GL_TEXTURE_2D, (placeholder != nullptr) ? placeholder : grey);
+        cache.insert(key, textureID, 0);
+        TextureStreamer::shared().add(textureID, imagefile);
+        return textureID;
+    }
+    if ((loader == nullptr) && (TextureCompressor::enabled))
+    {
+        CompressedImage texture;
+        if (!TextureCompressor::load({imagefile}, texture))
+        {
+            return 0;
+        }
+        textureID = textureObject(texture);
+        cache.insert(key, textureID, bytes);
+        return textureID;
+    }
+    if (loader == nullptr)
+    {
+        if (!setImage(imagefile))
+        {
+            return 0;
+        }
+        textureID = textureObject();
+        cache.insert(key, textureID, bytes);
+        return textureID;
+    }
+    //! A flat color is drawn until the image is decoded and put in its place.
+    textureID = placeholderTexture(GL_TEXTURE_2D, (placeholder != nullptr) ? placeholder : grey);
+    cache.insert(key, textureID, 0);
+    loader->submit(imagefile, [imagefile, textureID]() -> AssetLoader::Upload
+    {
+        if (TextureCompressor::enabled)
+        {
+            shared_ptr<CompressedImage> texture = make_shared<CompressedImage>();
+            if (!TextureCompressor::load({imagefile}, *texture))
+            {
+                return AssetLoader::Upload();
+            }
+            return [textureID, texture]()
+            {
+                TextureCompressor::upload(textureID, GL_TEXTURE_2D, *texture);
+                TextureCache::shared().setBytes(textureID, texture->bytes());
+            };
+        }
+        shared_ptr<ImageData> image = make_shared<ImageData>();
+        if (!decodeImage(imagefile, *image))
+        {
+            return AssetLoader::Upload();
+        }
+        return [textureID, image]()
+        {
+            uploadTexture(textureID, *image);
+            TextureCache::shared().setBytes(textureID, textureBytes(image->width, image->height));
+        };
+    });
+    return textureID;
+}
+
+void CreateImage::loadSkyBox(GLuint &textureID, string filenames[6], AssetLoader *loader, const unsigned char *placeholder)
+{
+    static const unsigned char black[4] = {0, 0, 0, 255};
+    TextureCache &cache = TextureCache::shared();
+    vector<string> files(filenames, filenames + 6);
+    string key = TextureCache::makeKey(files, GL_TEXTURE_CUBE_MAP, GL_CLAMP_TO_EDGE, GL_LINEAR_MIPMAP_LINEAR);
+    textureID = cache.acquire(key);
+    if (textureID > 0)
+    {
+        return;
+    }
+    if (loader == nullptr)
+    {
+        createSkyBoxTex(textureID, filenames);
+        cache.insert(key, textureID, bytes);
+        return;
+    }
+    //! The faces go into the same cube map, so its users keep their sampler.
+    textureID = placeholderTexture(GL_TEXTURE_CUBE_MAP, (placeholder != nullptr) ? placeholder : black);
+    cache.insert(key, textureID, 0);
+    GLuint target = textureID;
+    if (TextureCompressor::enabled)
+    {
+        vector<string> ordered = skyBoxOrder(filenames);
+        loader->submit("sky box", [ordered, target]() -> AssetLoader::Upload
+        {
+            shared_ptr<CompressedImage> texture = make_shared<CompressedImage>();
+            if (!TextureCompressor::load(ordered, *texture))
+            {
+                cout << "\n\n\tImage load failure for the sky box.\n\n";
+                exit(-1);
+            }
+            return [target, texture]()
+            {
+                TextureCompressor::upload(target, GL_TEXTURE_CUBE_MAP, *texture);
+                TextureCache::shared().setBytes(target, texture->bytes());
+                cout << "\n\n\tThe sky box is resident.\n\n";
+            };
+        });
+        return;
+    }
+    //! Each face is its own job, and the last one done uploads them all.
+    shared_ptr<vector<ImageData>> faces = make_shared<vector<ImageData>>(6);
+    shared_ptr<atomic<int>> remaining = make_shared<atomic<int>>(6);
+    for (int i = 0; i < 6; i++)
+    {
+        string file = files[i];
+        loader->submit(file, [file, i, target, faces, remaining]() -> AssetLoader::Upload
+        {
+            if (!decodeImage(file, (*faces)[i]))
+            {
+                cout << "\n\n\tImage load failure for the sky box.\n\n";
+                exit(-1);
+            }
+            if (--(*remaining) > 0)
+            {
+                return AssetLoader::Upload();
+            }
+            return [target, faces]()
+            {
+                uploadSkyBoxTex(target, faces->data());
+                TextureCache::shared().setBytes(target, textureBytes((*faces)[0].width, (*faces)[0].height, 6));
+                cout << "\n\n\tThe sky box is resident.\n\n";
+            };
+        });
+    }
+}
+
+vector<string> CreateImage::skyBoxOrder(string filenames[6])
+{
+    //! The order of images in a skybox is reversed.
+    return vector<string>({filenames[5], filenames[4], filenames[3], filenames[2], filenames[1], filenames[0]});
+}
+
+void CreateImage::releaseTexture(GLuint textureID)
+{
+    if (textureID > 0)
+    {
+        if (TextureCache::shared().release(textureID))
+        {
+            TextureStreamer::shared().remove(textureID);
+        }
+    }
+}
+
+long CreateImage::textureBytes(GLsizei width, GLsizei height, int faces)
+{
+    //! The mipmaps add a third to the base level.
+    return ((long) width * height * 4 * faces * 4) / 3;
+}
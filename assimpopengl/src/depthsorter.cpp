@@ -0,0 +1,86 @@
+/**********************************************************
+ *   DepthSorter:  A class to put a list of depths in order
+ *   with a radix sort of their keys and indices.
+ *   Created by: Edward Charles Eberle <eberdeed@eberdeed.net>
+ *   October 2026 San Diego, California USA
+ * ********************************************************/
+
+#include "../include/depthsorter.h"
+
+DepthSorter::DepthSorter()
+{
+    cout << "\n\n\tCreating DepthSorter.\n\n";
+}
+
+DepthSorter::~DepthSorter()
+{
+    cout << "\n\n\tDestroying DepthSorter.\n\n";
+}
+
+unsigned int DepthSorter::floatKey(float value)
+{
+    unsigned int bits;
+    memcpy(&bits, &value, sizeof(bits));
+    //! Positive floats order as their bits once the sign is set,
+    //! negative floats order backwards so all their bits are flipped.
+    return (bits & 0x80000000u) ? ~bits : (bits | 0x80000000u);
+}
+
+void DepthSorter::sort(const float *depths, int count, bool descending)
+{
+    keys.resize(count);
+    keyScratch.resize(count);
+    order.resize(count);
+    indexScratch.resize(count);
+    unsigned int flip = (descending) ? 0xFFFFFFFFu : 0u;
+    unsigned int histogram[4][256];
+    memset(histogram, 0, sizeof(histogram));
+    //! One pass to make the keys and count every byte of them.
+    for (int x = 0; x < count; x++)
+    {
+        unsigned int key = floatKey(depths[x]) ^ flip;
+        keys[x] = key;
+        order[x] = x;
+        histogram[0][key & 0xFF]++;
+        histogram[1][(key >> 8) & 0xFF]++;
+        histogram[2][(key >> 16) & 0xFF]++;
+        histogram[3][key >> 24]++;
+    }
+    unsigned int *sourceKey = keys.data(), *sourceIndex = order.data();
+    unsigned int *targetKey = keyScratch.data(), *targetIndex = indexScratch.data();
+    for (int pass = 0; pass < 4; pass++)
+    {
+        unsigned int *counts = histogram[pass];
+        int shift = pass * 8;
+        //! A byte all the keys share leaves the order as it is.
+        if ((count < 1) || (counts[(sourceKey[0] >> shift) & 0xFF] == (unsigned int) count))
+        {
+            continue;
+        }
+        unsigned int offset = 0;
+        for (int x = 0; x < 256; x++)
+        {
+            unsigned int size = counts[x];
+            counts[x] = offset;
+            offset += size;
+        }
+        for (int x = 0; x < count; x++)
+        {
+            unsigned int key = sourceKey[x];
+            unsigned int slot = counts[(key >> shift) & 0xFF]++;
+            targetKey[slot] = key;
+            targetIndex[slot] = sourceIndex[x];
+        }
+        std::swap(sourceKey, targetKey);
+        std::swap(sourceIndex, targetIndex);
+    }
+    //! An odd number of passes leaves the result in the scratch buffers.
+    if (sourceIndex != order.data())
+    {
+        memcpy(order.data(), sourceIndex, count * sizeof(unsigned int));
+    }
+    if (debug1)
+    {
+        cout << "\n\tSorted " << count << " depths.";
+    }
+}
@@ -0,0 +1,141 @@
+/**********************************************************
+ *   FrameGovernor:  A class to hold the frame time to a
+ *   budget by scaling the render resolution and the detail.
+ *   Created by: Edward Charles Eberle <eberdeed@eberdeed.net>
+ *   October 2026 San Diego, California USA
+ * ********************************************************/
+
+#include "../include/framegovernor.h"
+
+FrameGovernor::FrameGovernor(float budget, int width, int height)
+{
+    cout << "\n\n\tCreating FrameGovernor.\n\n";
+    this->budget = budget;
+    this->width = width;
+    this->height = height;
+    applyQuality();
+}
+
+FrameGovernor::~FrameGovernor()
+{
+    cout << "\n\n\tDestroying FrameGovernor.\n\n";
+    if (FBO != 0)
+    {
+        glDeleteRenderbuffers(1, &colorBuffer);
+        glDeleteRenderbuffers(1, &depthBuffer);
+        glDeleteFramebuffers(1, &FBO);
+        ResourceRegistry::shared().releaseGL(ResourceRegistry::RENDERBUFFER, colorBuffer);
+        ResourceRegistry::shared().releaseGL(ResourceRegistry::RENDERBUFFER, depthBuffer);
+    }
+}
+
+void FrameGovernor::resize(int width, int height)
+{
+    this->width = width;
+    this->height = height;
+    applyQuality();
+}
+
+void FrameGovernor::applyQuality()
+{
+    quality = glm::clamp(quality, 0.0f, 1.0f);
+    renderScale = minScale + (1.0f - minScale) * quality;
+    lodBias = 1.0f + (maxLodBias - 1.0f) * (1.0f - quality);
+    impostorScale = 1.0f + (maxImpostorScale - 1.0f) * (1.0f - quality);
+}
+
+void FrameGovernor::allocate(int width, int height)
+{
+    renderWidth = width;
+    renderHeight = height;
+    if (FBO == 0)
+    {
+        glGenFramebuffers(1, &FBO);
+        glGenRenderbuffers(1, &colorBuffer);
+        glGenRenderbuffers(1, &depthBuffer);
+    }
+    glBindRenderbuffer(GL_RENDERBUFFER, colorBuffer);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, width, height);
+    glBindRenderbuffer(GL_RENDERBUFFER, depthBuffer);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH24_STENCIL8, width, height);
+    glBindRenderbuffer(GL_RENDERBUFFER, 0);
+    ResourceRegistry::shared().trackGL(ResourceRegistry::RENDERBUFFER, colorBuffer, "Frame governor", (long) width * height * 4);
+    ResourceRegistry::shared().trackGL(ResourceRegistry::RENDERBUFFER, depthBuffer, "Frame governor", (long) width * height * 4);
+    glBindFramebuffer(GL_FRAMEBUFFER, FBO);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, colorBuffer);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_RENDERBUFFER, depthBuffer);
+    if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
+    {
+        cout << "\n\n\tError:  The governor framebuffer is not complete.\n\n";
+        exit(-1);
+    }
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+}
+
+void FrameGovernor::beginFrame()
+{
+    chrono::steady_clock::time_point now = chrono::steady_clock::now();
+    if ((started) && (enabled))
+    {
+        total += chrono::duration<float, milli>(now - last).count();
+        frames++;
+        if (frames >= window)
+        {
+            average = total / frames;
+            float previous = quality;
+            if (average > budget * 1.1f)
+            {
+                quality -= step;
+                calm = 0;
+            }
+            else if (average < budget * 0.85f)
+            {
+                quality += step;
+            }
+            //! A frame held at the budget may be waiting on the swap, so try a step up now and then.
+            else if (++calm >= probeWindows)
+            {
+                quality += step;
+                calm = 0;
+            }
+            applyQuality();
+            if ((debug1) || (quality != previous))
+            {
+                cout << "\n\tFrame time " << average << " ms, quality " << quality
+                << " render scale " << renderScale << ".";
+            }
+            total = 0.0f;
+            frames = 0;
+        }
+    }
+    last = now;
+    started = true;
+    int targetWidth = std::max(1, (int) (width * renderScale));
+    int targetHeight = std::max(1, (int) (height * renderScale));
+    offscreen = (targetWidth < width) || (targetHeight < height);
+    if (!offscreen)
+    {
+        glBindFramebuffer(GL_FRAMEBUFFER, 0);
+        glViewport(0, 0, width, height);
+        return;
+    }
+    if ((targetWidth != renderWidth) || (targetHeight != renderHeight))
+    {
+        allocate(targetWidth, targetHeight);
+    }
+    glBindFramebuffer(GL_FRAMEBUFFER, FBO);
+    glViewport(0, 0, renderWidth, renderHeight);
+}
+
+void FrameGovernor::endFrame()
+{
+    if (!offscreen)
+    {
+        return;
+    }
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, FBO);
+    glBindFramebuffer(GL_DRAW_FRAMEBUFFER, 0);
+    glBlitFramebuffer(0, 0, renderWidth, renderHeight, 0, 0, width, height, GL_COLOR_BUFFER_BIT, GL_LINEAR);
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    glViewport(0, 0, width, height);
+}
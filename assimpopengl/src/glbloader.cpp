@@ -0,0 +1,692 @@
+/**********************************************************
+ *   GlbLoader:  A class to map binary glTF 2.0 assets and
+ *   point their meshes into the mapping.
+ *   Created by: Edward Charles Eberle <eberdeed@eberdeed.net>
+ *   October 2026 San Diego, California USA
+ * ********************************************************/
+
+#include "../include/glbloader.h"
+#include "../include/info.h"
+#include "../include/meshtex.h"
+#include "../include/meshvert.h"
+#include "../include/assetpack.h"
+#include <algorithm>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+bool GlbLoader::enabled = true;
+bool GlbLoader::debug1 = false;
+
+//! The chunk and component type codes of the glTF 2.0 specification.
+static const uint32_t GLB_MAGIC = 0x46546C67, GLB_JSON = 0x4E4F534A, GLB_BIN = 0x004E4942;
+static const int GLTF_BYTE = 5120, GLTF_UNSIGNED_BYTE = 5121, GLTF_SHORT = 5122,
+    GLTF_UNSIGNED_SHORT = 5123, GLTF_UNSIGNED_INT = 5125, GLTF_FLOAT = 5126;
+
+/** \brief A value of the JSON chunk.  An object keeps its member
+ * names beside its values, an array only its values.
+ */
+struct JsonValue {
+    enum Kind {NONE, NUMBER, TEXT, BOOLEAN, ARRAY, OBJECT};
+    Kind kind = NONE;
+    double number = 0.0;
+    string text;
+    vector<string> names;
+    vector<JsonValue> items;
+    //! \brief A member of an object, or a value of kind NONE.
+    const JsonValue &operator[](const string &name) const
+    {
+        static const JsonValue none;
+        for (unsigned int x = 0; x < names.size(); x++)
+        {
+            if (names[x] == name)
+            {
+                return items[x];
+            }
+        }
+        return none;
+    }
+    //! \brief An item of an array, or a value of kind NONE.
+    const JsonValue &operator[](size_t index) const
+    {
+        static const JsonValue none;
+        return ((kind == ARRAY) && (index < items.size())) ? items[index] : none;
+    }
+    bool has(const string &name) const
+    {
+        return (*this)[name].kind != NONE;
+    }
+    //! \brief The value as a whole number, or the default when it is not one.
+    long integer(long otherwise = -1) const
+    {
+        return ((kind == NUMBER) && (number >= 0.0) && (number == (double) (long) number)) ? (long) number : otherwise;
+    }
+};
+
+static void skipSpace(const char *&text, const char *end)
+{
+    while ((text < end) && ((*text == ' ') || (*text == '\t') || (*text == '\n') || (*text == '\r')))
+    {
+        text++;
+    }
+}
+
+//! \brief Read a JSON string, the text is at its opening quote.
+static bool parseString(const char *&text, const char *end, string &result)
+{
+    text++;
+    result.clear();
+    while (text < end)
+    {
+        char letter = *text++;
+        if (letter == '"')
+        {
+            return true;
+        }
+        if (letter != '\\')
+        {
+            result += letter;
+            continue;
+        }
+        if (text >= end)
+        {
+            return false;
+        }
+        letter = *text++;
+        switch (letter)
+        {
+            case 'b': result += '\b'; break;
+            case 'f': result += '\f'; break;
+            case 'n': result += '\n'; break;
+            case 'r': result += '\r'; break;
+            case 't': result += '\t'; break;
+            case 'u':
+            {
+                if (end - text < 4)
+                {
+                    return false;
+                }
+                unsigned int code = (unsigned int) strtoul(string(text, 4).c_str(), nullptr, 16);
+                text += 4;
+                //! A surrogate pair makes one code point.
+                if ((code >= 0xD800) && (code < 0xDC00) && (end - text >= 6) && (text[0] == '\\') && (text[1] == 'u'))
+                {
+                    unsigned int low = (unsigned int) strtoul(string(text + 2, 4).c_str(), nullptr, 16);
+                    if ((low >= 0xDC00) && (low < 0xE000))
+                    {
+                        code = 0x10000 + ((code - 0xD800) << 10) + (low - 0xDC00);
+                        text += 6;
+                    }
+                }
+                if (code < 0x80)
+                {
+                    result += (char) code;
+                }
+                else if (code < 0x800)
+                {
+                    result += (char) (0xC0 | (code >> 6));
+                    result += (char) (0x80 | (code & 0x3F));
+                }
+                else if (code < 0x10000)
+                {
+                    result += (char) (0xE0 | (code >> 12));
+                    result += (char) (0x80 | ((code >> 6) & 0x3F));
+                    result += (char) (0x80 | (code & 0x3F));
+                }
+                else
+                {
+                    result += (char) (0xF0 | (code >> 18));
+                    result += (char) (0x80 | ((code >> 12) & 0x3F));
+                    result += (char) (0x80 | ((code >> 6) & 0x3F));
+                    result += (char) (0x80 | (code & 0x3F));
+                }
+                break;
+            }
+            default: result += letter; break;
+        }
+    }
+    return false;
+}
+
+//! \brief Read one JSON value, nested no deeper than a glTF file needs.
+static bool parseJson(const char *&text, const char *end, JsonValue &value, int depth)
+{
+    skipSpace(text, end);
+    if ((text >= end) || (depth > 64))
+    {
+        return false;
+    }
+    if (*text == '{')
+    {
+        value.kind = JsonValue::OBJECT;
+        text++;
+        skipSpace(text, end);
+        if ((text < end) && (*text == '}'))
+        {
+            text++;
+            return true;
+        }
+        while (text < end)
+        {
+            skipSpace(text, end);
+            string name;
+            if ((text >= end) || (*text != '"') || (!parseString(text, end, name)))
+            {
+                return false;
+            }
+            skipSpace(text, end);
+            if ((text >= end) || (*text++ != ':'))
+            {
+                return false;
+            }
+            value.names.push_back(name);
+            value.items.push_back(JsonValue());
+            if (!parseJson(text, end, value.items.back(), depth + 1))
+            {
+                return false;
+            }
+            skipSpace(text, end);
+            if ((text < end) && (*text == ','))
+            {
+                text++;
+                continue;
+            }
+            if ((text < end) && (*text == '}'))
+            {
+                text++;
+                return true;
+            }
+            return false;
+        }
+        return false;
+    }
+    if (*text == '[')
+    {
+        value.kind = JsonValue::ARRAY;
+        text++;
+        skipSpace(text, end);
+        if ((text < end) && (*text == ']'))
+        {
+            text++;
+            return true;
+        }
+        while (text < end)
+        {
+            value.items.push_back(JsonValue());
+            if (!parseJson(text, end, value.items.back(), depth + 1))
+            {
+                return false;
+            }
+            skipSpace(text, end);
+            if ((text < end) && (*text == ','))
+            {
+                text++;
+                continue;
+            }
+            if ((text < end) && (*text == ']'))
+            {
+                text++;
+                return true;
+            }
+            return false;
+        }
+        return false;
+    }
+    if (*text == '"')
+    {
+        value.kind = JsonValue::TEXT;
+        return parseString(text, end, value.text);
+    }
+    for (string word : {"true", "false", "null"})
+    {
+        if (((size_t) (end - text) >= word.size()) && (word.compare(0, word.size(), text, word.size()) == 0))
+        {
+            value.kind = (word == "null") ? JsonValue::NONE : JsonValue::BOOLEAN;
+            value.number = (word == "true") ? 1.0 : 0.0;
+            text += word.size();
+            return true;
+        }
+    }
+    //! The JSON chunk is copied into a string, so strtod() stops at its end.
+    char *stop = nullptr;
+    value.number = strtod(text, &stop);
+    if ((stop == text) || (stop > end))
+    {
+        return false;
+    }
+    value.kind = JsonValue::NUMBER;
+    text = stop;
+    return true;
+}
+
+//! A typed, strided range of the binary chunk.
+struct GlbAccessor {
+    unsigned char *data = nullptr;
+    size_t count = 0, stride = 0;
+    int componentType = 0, components = 0;
+    bool normalized = false;
+};
+
+static size_t componentSize(int componentType)
+{
+    switch (componentType)
+    {
+        case GLTF_BYTE:
+        case GLTF_UNSIGNED_BYTE: return 1;
+        case GLTF_SHORT:
+        case GLTF_UNSIGNED_SHORT: return 2;
+        case GLTF_UNSIGNED_INT:
+        case GLTF_FLOAT: return 4;
+    }
+    return 0;
+}
+
+//! \brief Find an accessor in the binary chunk, returning false when it is not all there.
+static bool findAccessor(const JsonValue &root, long index, unsigned char *binary, size_t binarySize, GlbAccessor &accessor)
+{
+    const JsonValue &item = root["accessors"][index];
+    const JsonValue &view = root["bufferViews"][item["bufferView"].integer()];
+    //! Sparse accessors and buffers outside the file are left to Assimp.
+    if ((item.kind != JsonValue::OBJECT) || (view.kind != JsonValue::OBJECT) || (item.has("sparse"))
+        || (view["buffer"].integer() != 0))
+    {
+        return false;
+    }
+    string type = item["type"].text;
+    accessor.components = (type == "SCALAR") ? 1 : (type == "VEC2") ? 2 : (type == "VEC3") ? 3 : (type == "VEC4") ? 4 : 0;
+    accessor.componentType = item["componentType"].integer();
+    accessor.normalized = item["normalized"].number != 0.0;
+    accessor.count = item["count"].integer(0);
+    size_t element = componentSize(accessor.componentType) * accessor.components;
+    long viewOffset = view["byteOffset"].integer(0), viewLength = view["byteLength"].integer(), offset = item["byteOffset"].integer(0);
+    accessor.stride = view["byteStride"].integer(element);
+    if ((element == 0) || (viewOffset < 0) || (viewLength < 0) || (offset < 0) || (accessor.stride < element)
+        || ((size_t) viewOffset + viewLength > binarySize) || (accessor.count == 0))
+    {
+        return false;
+    }
+    if ((size_t) offset + (accessor.count - 1) * accessor.stride + element > (size_t) viewLength)
+    {
+        return false;
+    }
+    accessor.data = binary + viewOffset + offset;
+    return true;
+}
+
+//! \brief One component of an element as a float, normalized integers scaled to 0 to 1 or -1 to 1.
+static float component(GlbAccessor &accessor, size_t element, int component)
+{
+    const unsigned char *source = accessor.data + element * accessor.stride + component * componentSize(accessor.componentType);
+    switch (accessor.componentType)
+    {
+        case GLTF_FLOAT:
+        {
+            float value;
+            memcpy(&value, source, sizeof(value));
+            return value;
+        }
+        case GLTF_UNSIGNED_BYTE:
+            return (accessor.normalized) ? *source / 255.0f : *source;
+        case GLTF_BYTE:
+            return (accessor.normalized) ? std::max(*(const signed char*) source / 127.0f, -1.0f) : *(const signed char*) source;
+        case GLTF_UNSIGNED_SHORT:
+        {
+            uint16_t value;
+            memcpy(&value, source, sizeof(value));
+            return (accessor.normalized) ? value / 65535.0f : value;
+        }
+        case GLTF_SHORT:
+        {
+            int16_t value;
+            memcpy(&value, source, sizeof(value));
+            return (accessor.normalized) ? std::max(value / 32767.0f, -1.0f) : value;
+        }
+    }
+    return 0.0f;
+}
+
+//! \brief The image file of a texture, empty when the image is inside the file.
+static string textureFile(const JsonValue &root, const JsonValue &reference, string directory)
+{
+    if (reference.kind != JsonValue::OBJECT)
+    {
+        return "";
+    }
+    const JsonValue &image = root["images"][root["textures"][reference["index"].integer()]["source"].integer()];
+    string uri = image["uri"].text;
+    if ((uri.size() == 0) || (uri.compare(0, 5, "data:") == 0))
+    {
+        cout << "\n\n\tWarning:  The glTF images inside the file are not read.\n\n";
+        return "";
+    }
+    //! Undo the percent encoding of a URI.
+    string name;
+    for (unsigned int x = 0; x < uri.size(); x++)
+    {
+        if ((uri[x] == '%') && (x + 2 < uri.size()) && (isxdigit((unsigned char) uri[x + 1])) && (isxdigit((unsigned char) uri[x + 2])))
+        {
+            name += (char) strtoul(uri.substr(x + 1, 2).c_str(), nullptr, 16);
+            x += 2;
+        }
+        else
+        {
+            name += uri[x];
+        }
+    }
+    return directory + "/" + name;
+}
+
+bool GlbLoader::handles(string path)
+{
+    string extension = boost::filesystem::path(path).extension().string();
+    transform(extension.begin(), extension.end(), extension.begin(), ::tolower);
+    return extension == ".glb";
+}
+
+AssetData *GlbLoader::read(string path)
+{
+    //! Private and writable, as the mesh cache is, so the texture coordinates turn without touching the file.
+    void *mapped = MAP_FAILED;
+    size_t fileSize = 0;
+    PackView contents;
+    if (AssetPack::shared().view(path, contents))
+    {
+        //! The pack is read only, so the packed file is copied once into memory of its own.
+        fileSize = contents.size;
+        if (fileSize > 0)
+        {
+            mapped = mmap(nullptr, fileSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        }
+        if (mapped != MAP_FAILED)
+        {
+            memcpy(mapped, contents.data, fileSize);
+        }
+        contents.owned.reset();
+    }
+    else
+    {
+        int fd = open(path.c_str(), O_RDONLY);
+        if (fd < 0)
+        {
+            return nullptr;
+        }
+        struct stat info;
+        if ((fstat(fd, &info) == 0) && (info.st_size > 0))
+        {
+            fileSize = info.st_size;
+            mapped = mmap(nullptr, fileSize, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+        }
+        close(fd);
+    }
+    if (mapped == MAP_FAILED)
+    {
+        cout << "\n\n\tError mapping file " << path << ".\n\n";
+        return nullptr;
+    }
+    unsigned char *data = (unsigned char*) mapped;
+    uint32_t header[5] = {0, 0, 0, 0, 0};
+    memcpy(header, data, std::min(fileSize, sizeof(header)));
+    //! The header, the JSON chunk, then the binary chunk on a four byte boundary.
+    bool response = (fileSize >= 20) && (header[0] == GLB_MAGIC) && (header[1] == 2) && (header[2] <= fileSize)
+    && (header[4] == GLB_JSON) && (header[3] <= header[2] - 20);
+    unsigned char *binary = nullptr;
+    size_t binarySize = 0;
+    JsonValue root;
+    if (response)
+    {
+        size_t binaryStart = 20 + ((header[3] + 3) & ~(size_t) 3);
+        uint32_t chunk[2] = {0, 0};
+        if (binaryStart + 8 <= header[2])
+        {
+            memcpy(chunk, data + binaryStart, sizeof(chunk));
+            if ((chunk[1] == GLB_BIN) && (chunk[0] <= header[2] - binaryStart - 8))
+            {
+                binary = data + binaryStart + 8;
+                binarySize = chunk[0];
+            }
+        }
+        string json((const char*) data + 20, header[3]);
+        const char *text = json.c_str();
+        response = (parseJson(text, text + json.size(), root, 0)) && (root.kind == JsonValue::OBJECT)
+        && (root["extensionsRequired"].items.size() == 0);
+        //! Buffer 0 is the binary chunk, and the only buffer read here.
+        response = (response) && (root["buffers"].items.size() == 1) && (!root["buffers"][0].has("uri")) && (binary != nullptr)
+        && (root["buffers"][0]["byteLength"].integer() >= 0) && ((size_t) root["buffers"][0]["byteLength"].integer() <= binarySize);
+    }
+    string directory = path.substr(0, path.find_last_of('/'));
+    AssetData *asset = new AssetData();
+    int mappedMeshes = 0;
+    vector<unsigned char*> turned;
+    vector<bool> inMapping;
+    const JsonValue &meshes = root["meshes"];
+    for (unsigned int x = 0; (response) && (x < meshes.items.size()); x++)
+    {
+        const JsonValue &primitives = meshes[x]["primitives"];
+        for (unsigned int y = 0; (response) && (y < primitives.items.size()); y++)
+        {
+            const JsonValue &primitive = primitives[y];
+            const JsonValue &attributes = primitive["attributes"];
+            GlbAccessor position, normal, texCoord, index;
+            response = (primitive["mode"].integer(4) == 4)
+            && (findAccessor(root, attributes["POSITION"].integer(), binary, binarySize, position))
+            && (findAccessor(root, attributes["NORMAL"].integer(), binary, binarySize, normal))
+            && (position.componentType == GLTF_FLOAT) && (position.components == 3)
+            && (normal.componentType == GLTF_FLOAT) && (normal.components == 3) && (normal.count == position.count)
+            && (position.count < (size_t) INT32_MAX);
+            if (!response)
+            {
+                break;
+            }
+            MeshData item;
+            item.textured = (attributes.has("TEXCOORD_0"))
+            && (findAccessor(root, attributes["TEXCOORD_0"].integer(), binary, binarySize, texCoord))
+            && (texCoord.components == 2) && (texCoord.count == position.count)
+            && ((texCoord.componentType == GLTF_FLOAT) || (texCoord.normalized));
+            item.vertSize = position.count;
+            //! In place when the accessors are one interleaved array of the vertex layout.
+            size_t vertexSize = (item.textured) ? sizeof(Vertex) : sizeof(Vertex1);
+            bool inPlace = (position.stride == vertexSize) && (normal.stride == vertexSize) && (normal.data == position.data + 12)
+            && (((uintptr_t) position.data & 3) == 0);
+            if (item.textured)
+            {
+                inPlace = (inPlace) && (texCoord.stride == vertexSize) && (texCoord.data == position.data + 24)
+                && (texCoord.componentType == GLTF_FLOAT);
+                if (inPlace)
+                {
+                    item.vertices = (Vertex*) position.data;
+                }
+                //! The coordinates of a view shared by several primitives are turned once.
+                bool turnedBefore = find(turned.begin(), turned.end(), texCoord.data) != turned.end();
+                if ((inPlace) && (!turnedBefore))
+                {
+                    turned.push_back(texCoord.data);
+                    for (int z = 0; z < item.vertSize; z++)
+                    {
+                        item.vertices[z].TexCoords[1] = 1.0f - item.vertices[z].TexCoords[1];
+                    }
+                }
+                else if (!inPlace)
+                {
+                    item.vertices = new Vertex[item.vertSize];
+                    for (int z = 0; z < item.vertSize; z++)
+                    {
+                        for (int w = 0; w < 3; w++)
+                        {
+                            item.vertices[z].Position[w] = component(position, z, w);
+                            item.vertices[z].Normal[w] = component(normal, z, w);
+                        }
+                        item.vertices[z].TexCoords[0] = component(texCoord, z, 0);
+                        item.vertices[z].TexCoords[1] = (turnedBefore) ? component(texCoord, z, 1) : 1.0f - component(texCoord, z, 1);
+                    }
+                }
+            }
+            else
+            {
+                if (inPlace)
+                {
+                    item.vertices1 = (Vertex1*) position.data;
+                }
+                else
+                {
+                    item.vertices1 = new Vertex1[item.vertSize];
+                    for (int z = 0; z < item.vertSize; z++)
+                    {
+                        for (int w = 0; w < 3; w++)
+                        {
+                            item.vertices1[z].Position[w] = component(position, z, w);
+                            item.vertices1[z].Normal[w] = component(normal, z, w);
+                        }
+                    }
+                }
+            }
+            //! The indices are used in place when they are tightly packed 32 bit values.
+            bool indexed = primitive.has("indices");
+            bool indicesInPlace = false;
+            if (indexed)
+            {
+                response = (findAccessor(root, primitive["indices"].integer(), binary, binarySize, index))
+                && (index.components == 1) && (index.count < (size_t) INT32_MAX)
+                && ((index.componentType == GLTF_UNSIGNED_BYTE) || (index.componentType == GLTF_UNSIGNED_SHORT)
+                || (index.componentType == GLTF_UNSIGNED_INT));
+                item.indexSize = index.count;
+                indicesInPlace = (response) && (index.componentType == GLTF_UNSIGNED_INT) && (index.stride == 4)
+                && (((uintptr_t) index.data & 3) == 0);
+            }
+            else
+            {
+                item.indexSize = item.vertSize;
+            }
+            item.indexSize -= item.indexSize % 3;
+            if ((response) && (indicesInPlace))
+            {
+                item.indices = (GLuint*) index.data;
+            }
+            else if (response)
+            {
+                item.indices = new GLuint[std::max(item.indexSize, 1)];
+                for (int z = 0; z < item.indexSize; z++)
+                {
+                    item.indices[z] = (indexed) ? (GLuint) component(index, z, 0) : z;
+                }
+            }
+            for (int z = 0; (response) && (z < item.indexSize); z++)
+            {
+                response = (item.indices[z] < (GLuint) item.vertSize);
+            }
+            //! The mesh is mapped only when both of its arrays are, so its arrays are all one or the other.
+            bool mapped = (inPlace) && (indicesInPlace);
+            if ((response) && (!mapped) && (indicesInPlace))
+            {
+                GLuint *copy = new GLuint[std::max(item.indexSize, 1)];
+                memcpy(copy, item.indices, item.indexSize * sizeof(GLuint));
+                item.indices = copy;
+            }
+            if ((response) && (!mapped) && (inPlace))
+            {
+                if (item.textured)
+                {
+                    Vertex *copy = new Vertex[item.vertSize];
+                    memcpy(copy, item.vertices, item.vertSize * sizeof(Vertex));
+                    item.vertices = copy;
+                }
+                else
+                {
+                    Vertex1 *copy = new Vertex1[item.vertSize];
+                    memcpy(copy, item.vertices1, item.vertSize * sizeof(Vertex1));
+                    item.vertices1 = copy;
+                }
+            }
+            if (!response)
+            {
+                if (!inPlace)
+                {
+                    delete [] item.vertices;
+                    delete [] item.vertices1;
+                }
+                if (!indicesInPlace)
+                {
+                    delete [] item.indices;
+                }
+                break;
+            }
+            //! The material, with the defaults of the specification.
+            const JsonValue &material = root["materials"][primitive["material"].integer()];
+            const JsonValue &pbr = material["pbrMetallicRoughness"];
+            const JsonValue &factor = pbr["baseColorFactor"];
+            for (int z = 0; z < 3; z++)
+            {
+                item.color[z] = (factor.items.size() == 4) ? factor[z].number : 1.0;
+            }
+            item.opacity = ((material["alphaMode"].text == "BLEND") && (factor.items.size() == 4)) ? factor[3].number : 1.0f;
+            if (item.textured)
+            {
+                vector<pair<string, const JsonValue*>> slots = {make_pair(string("diffuse"), &pbr["baseColorTexture"]),
+                    make_pair(string("specular"), &pbr["metallicRoughnessTexture"]),
+                    make_pair(string("emissive"), &material["emissiveTexture"]),
+                    make_pair(string("normal"), &material["normalTexture"])};
+                for (unsigned int z = 0; z < slots.size(); z++)
+                {
+                    string file = textureFile(root, *slots[z].second, directory);
+                    if (file.size() > 0)
+                    {
+                        item.images.push_back(make_pair(file, slots[z].first));
+                    }
+                }
+            }
+            inMapping.push_back(mapped);
+            mappedMeshes += (mapped) ? 1 : 0;
+            asset->meshes.push_back(item);
+        }
+    }
+    if ((!response) || (asset->meshes.size() == 0))
+    {
+        cout << "\n\n\tThe glTF file " << path << " is not one the loader reads, it is left to Assimp.\n\n";
+        for (unsigned int x = 0; x < asset->meshes.size(); x++)
+        {
+            MeshData &item = asset->meshes[x];
+            if (!inMapping[x])
+            {
+                delete [] item.vertices;
+                delete [] item.vertices1;
+                delete [] item.indices;
+            }
+        }
+        delete asset;
+        munmap(mapped, fileSize);
+        return nullptr;
+    }
+    //! The meshes are made once the whole file has been read.
+    for (unsigned int x = 0; x < asset->meshes.size(); x++)
+    {
+        MeshData &item = asset->meshes[x];
+        if (item.textured)
+        {
+            item.mesh = new MeshTex();
+        }
+        else
+        {
+            item.mesh = new MeshVert();
+        }
+        item.mesh->mapped = inMapping[x];
+        item.mesh->lodLevels = 1;
+        item.mesh->lodOffset[0] = 0;
+        item.mesh->lodCount[0] = item.indexSize;
+    }
+    if (mappedMeshes > 0)
+    {
+        asset->mapped = mapped;
+        asset->mappedSize = fileSize;
+    }
+    else
+    {
+        //! Every mesh was gathered into arrays of its own.
+        munmap(mapped, fileSize);
+    }
+    if (debug1)
+    {
+        cout << "\n\tRead " << asset->meshes.size() << " meshes, " << mappedMeshes
+        << " of them in place, from the glTF file " << path << ".";
+    }
+    return asset;
+}
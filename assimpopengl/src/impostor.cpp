@@ -0,0 +1,167 @@
+/**********************************************************
+ *   Impostor:  A class to draw distant instances of an asset
+ *   as camera facing quads textured from an atlas of views
+ *   rendered at start up.
+ *   Created by: Edward Charles Eberle <eberdeed@eberdeed.net>
+ *   October 2026 San Diego, California USA
+ * ********************************************************/
+
+#include "../include/impostor.h"
+#include "../include/assimpopengl.h"
+
+Impostor::Impostor(Shader *shader, int tileSize, int views)
+{
+    cout << "\n\n\tCreating Impostor.\n\n";
+    this->shader = shader;
+    this->tileSize = tileSize;
+    this->views = glm::clamp(views, 1, MAX_IMPOSTOR_VIEWS);
+    columns = (int) ceil(sqrt((float) this->views));
+    //! Spread the view directions evenly over the sphere (a Fibonacci spiral).
+    for (int x = 0; x < this->views; x++)
+    {
+        float y = 1.0f - (2.0f * (x + 0.5f) / this->views);
+        float ring = sqrt(std::max(0.0f, 1.0f - y * y));
+        float angle = x * 2.39996323f;
+        tileDir[x] = vec3(cos(angle) * ring, y, sin(angle) * ring);
+        tileUp[x] = (fabs(y) > 0.99f) ? vec3(0.0f, 0.0f, 1.0f) : vec3(0.0f, 1.0f, 0.0f);
+    }
+    float corners[8] = {-1.0f, -1.0f, 1.0f, -1.0f, -1.0f, 1.0f, 1.0f, 1.0f};
+    glGenVertexArrays(1, &VAO);
+    glGenBuffers(2, VBO);
+    glBindVertexArray(VAO);
+    glBindBuffer(GL_ARRAY_BUFFER, VBO[0]);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(corners), corners, GL_STATIC_DRAW);
+    ResourceRegistry::shared().trackGL(ResourceRegistry::BUFFER, VBO[0], "Impostors", sizeof(corners));
+    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 2 * sizeof(float), (GLvoid*)0);
+    glEnableVertexAttribArray(0);
+    //! The instance matrix takes four attribute locations, one per column.
+    glBindBuffer(GL_ARRAY_BUFFER, VBO[1]);
+    for (int x = 0; x < 4; x++)
+    {
+        glVertexAttribPointer(1 + x, 4, GL_FLOAT, GL_FALSE, sizeof(mat4), (GLvoid*)(x * sizeof(vec4)));
+        glEnableVertexAttribArray(1 + x);
+        glVertexAttribDivisor(1 + x, 1);
+    }
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    glBindVertexArray(0);
+}
+
+Impostor::~Impostor()
+{
+    cout << "\n\n\tDestroying Impostor.\n\n";
+    glDeleteVertexArrays(1, &VAO);
+    glDeleteBuffers(2, VBO);
+    glDeleteTextures(1, &atlas);
+    glDeleteRenderbuffers(1, &depthBuffer);
+    glDeleteFramebuffers(1, &FBO);
+    ResourceRegistry &registry = ResourceRegistry::shared();
+    registry.releaseGL(ResourceRegistry::BUFFER, VBO[0]);
+    registry.releaseGL(ResourceRegistry::BUFFER, VBO[1]);
+    registry.releaseGL(ResourceRegistry::TEXTURE, atlas);
+    registry.releaseGL(ResourceRegistry::RENDERBUFFER, depthBuffer);
+}
+
+void Impostor::capture(vector<MeshInfo> meshes, Shader *meshShader, float radius, bool diffOnly, float gamma)
+{
+    GLint viewport[4], previous;
+    int size = columns * tileSize;
+    vector<PointLight> lights;
+    vector<SpotLight> spotLights;
+    vector<mat4> identity(1, mat4(1.0f));
+    //! Leave a margin so the mipmaps of neighbouring tiles do not bleed together.
+    this->radius = std::max(radius, 0.0001f) * 1.05f;
+    glGetIntegerv(GL_VIEWPORT, viewport);
+    glGetIntegerv(GL_FRAMEBUFFER_BINDING, &previous);
+    glGenTextures(1, &atlas);
+    glBindTexture(GL_TEXTURE_2D, atlas);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, size, size, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glBindTexture(GL_TEXTURE_2D, 0);
+    glGenRenderbuffers(1, &depthBuffer);
+    glBindRenderbuffer(GL_RENDERBUFFER, depthBuffer);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT24, size, size);
+    glBindRenderbuffer(GL_RENDERBUFFER, 0);
+    //! The atlas with its mipmaps is a third larger.
+    ResourceRegistry::shared().trackGL(ResourceRegistry::TEXTURE, atlas, "Impostors", (long) size * size * 4 * 4 / 3);
+    ResourceRegistry::shared().trackGL(ResourceRegistry::RENDERBUFFER, depthBuffer, "Impostors", (long) size * size * 4);
+    glGenFramebuffers(1, &FBO);
+    glBindFramebuffer(GL_FRAMEBUFFER, FBO);
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, atlas, 0);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, depthBuffer);
+    if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
+    {
+        cout << "\n\n\tError:  The impostor framebuffer is not complete.\n\n";
+        exit(-1);
+    }
+    glViewport(0, 0, size, size);
+    glClearColor(0.0f, 0.0f, 0.0f, 0.0f);
+    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+    meshShader->Use();
+    for (int x = 0; x < views; x++)
+    {
+        //! Each tile is an orthographic view from outside the bounding sphere.
+        vec3 eye = tileDir[x] * (this->radius * 2.0f);
+        mat4 view = lookAt(eye, vec3(0.0f, 0.0f, 0.0f), tileUp[x]);
+        mat4 projection = ortho(-this->radius, this->radius, -this->radius, this->radius,
+            this->radius * 0.5f, this->radius * 3.5f);
+        glViewport((x % columns) * tileSize, (x / columns) * tileSize, tileSize, tileSize);
+        for (unsigned int y = 0; y < meshes.size(); y++)
+        {
+            meshes[y].mesh->DrawInstanced(view, projection, identity, lights, spotLights, eye, diffOnly, gamma, 0);
+        }
+    }
+    glBindTexture(GL_TEXTURE_2D, atlas);
+    glGenerateMipmap(GL_TEXTURE_2D);
+    glBindTexture(GL_TEXTURE_2D, 0);
+    glBindFramebuffer(GL_FRAMEBUFFER, previous);
+    glViewport(viewport[0], viewport[1], viewport[2], viewport[3]);
+    if (debug1)
+    {
+        cout << "\n\n\tCaptured " << views << " impostor views into a " << size
+        << " x " << size << " atlas.\n\n";
+    }
+}
+
+void Impostor::Draw(mat4 view, mat4 projection, vector<mat4> &instances, vec3 viewPos)
+{
+    if (instances.size() < 1)
+    {
+        return;
+    }
+    shader->Use();
+    shader->setMat4("view", view);
+    shader->setMat4("projection", projection);
+    shader->setVec3("viewPos", viewPos);
+    shader->setFloat("radius", radius);
+    shader->setInt("views", views);
+    shader->setInt("columns", columns);
+    for (int x = 0; x < views; x++)
+    {
+        stringstream ss;
+        ss << x;
+        shader->setVec3("tileDir[" + ss.str() + "]", tileDir[x]);
+        shader->setVec3("tileUp[" + ss.str() + "]", tileUp[x]);
+    }
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_2D, atlas);
+    shader->setInt("atlas", 0);
+    glBindVertexArray(VAO);
+    glBindBuffer(GL_ARRAY_BUFFER, VBO[1]);
+    if (instances.size() > capacity)
+    {
+        capacity = instances.size();
+        glBufferData(GL_ARRAY_BUFFER, capacity * sizeof(mat4), instances.data(), GL_STREAM_DRAW);
+        ResourceRegistry::shared().trackGL(ResourceRegistry::BUFFER, VBO[1], "Impostors", capacity * sizeof(mat4));
+    }
+    else
+    {
+        glBufferSubData(GL_ARRAY_BUFFER, 0, instances.size() * sizeof(mat4), instances.data());
+    }
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    glDrawArraysInstanced(GL_TRIANGLE_STRIP, 0, 4, instances.size());
+    glBindVertexArray(0);
+    glBindTexture(GL_TEXTURE_2D, 0);
+}
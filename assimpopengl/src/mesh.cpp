@@ -20,6 +20,14 @@ Mesh::Mesh()
 Mesh::~Mesh()
 {
     cout << "\n\n\tDestroying Mesh.\n\n";
+    if (depthVAO != 0)
+    {
+        glDeleteVertexArrays(1, &depthVAO);
+        glDeleteBuffers(1, &depthVBO);
+        glDeleteBuffers(1, &depthUBO);
+        ResourceRegistry::shared().releaseGL(ResourceRegistry::BUFFER, depthVBO);
+        ResourceRegistry::shared().releaseGL(ResourceRegistry::BUFFER, depthUBO);
+    }
     return;
 }
 
@@ -55,12 +63,107 @@ void Mesh::Draw(mat4 view, mat4 projection, mat4 model, vector<PointLight> light
     return;
 }
 
-void Mesh::DrawInstanced(mat4 view, mat4 projection, vector<mat4>model, vector<PointLight> lights, vector<SpotLight>spotLights, vec3 viewPos, bool diffOnly, float gamma) 
+void Mesh::DrawInstanced(mat4 view, mat4 projection, vector<mat4>model, vector<PointLight> lights, vector<SpotLight>spotLights, vec3 viewPos, bool diffOnly, float gamma, int lod) 
 {
     cout << "\n\nIn abstract class.\n";
     return;
 }
 
+void Mesh::setPacking(Shader *target)
+{
+    if (target == nullptr)
+    {
+        target = shader;
+    }
+    target->setBool("packedVertex", packed);
+    if (packed)
+    {
+        target->setVec3("posOffset", posOffset);
+        target->setVec3("posScale", posScale);
+        target->setVec2("uvOffset", uvOffset);
+        target->setVec2("uvScale", uvScale);
+    }
+}
+
+void Mesh::setupDepthMesh(const void *vertices, int vertSize, int stride, GLuint EBO)
+{
+    //! Every vertex layout starts with its position.
+    int positionSize = (packed) ? 4 * sizeof(unsigned short) : 3 * sizeof(float);
+    unsigned char *positions = new unsigned char[vertSize * positionSize];
+    for (int x = 0; x < vertSize; x++)
+    {
+        memcpy(&positions[x * positionSize], (const unsigned char*) vertices + x * stride, positionSize);
+    }
+    glGenVertexArrays(1, &depthVAO);
+    glGenBuffers(1, &depthVBO);
+    glGenBuffers(1, &depthUBO);
+    glBindVertexArray(depthVAO);
+    glBindBuffer(GL_ARRAY_BUFFER, depthVBO);
+    glBufferData(GL_ARRAY_BUFFER, vertSize * positionSize, positions, GL_STATIC_DRAW);
+    ResourceRegistry::shared().trackGL(ResourceRegistry::BUFFER, depthVBO, "Depth pre-pass", (long) vertSize * positionSize);
+    //! The instance block is made once at its largest, each draw fills the start of it.
+    glBindBuffer(GL_UNIFORM_BUFFER, depthUBO);
+    glBufferData(GL_UNIFORM_BUFFER, std::max(quantity, 1) * sizeof(mat4), nullptr, GL_STREAM_DRAW);
+    glBindBuffer(GL_UNIFORM_BUFFER, 0);
+    ResourceRegistry::shared().trackGL(ResourceRegistry::BUFFER, depthUBO, "Depth pre-pass", std::max(quantity, 1) * sizeof(mat4));
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
+    if (packed)
+    {
+        glVertexAttribPointer(0, 3, GL_UNSIGNED_SHORT, GL_TRUE, positionSize, (GLvoid*)0);
+    }
+    else
+    {
+        glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, positionSize, (GLvoid*)0);
+    }
+    glEnableVertexAttribArray(0);
+    glBindVertexArray(0);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    delete [] positions;
+}
+
+void Mesh::DrawDepth(Shader *depthShader, mat4 view, mat4 projection, vector<mat4> &model, int lod)
+{
+    int count = std::min((int) model.size(), quantity);
+    if ((depthVAO == 0) || (count < 1))
+    {
+        return;
+    }
+    depthShader->Use();
+    depthShader->setMat4("view", view);
+    depthShader->setMat4("projection", projection);
+    setPacking(depthShader);
+    GLuint blockIndex = glGetUniformBlockIndex(depthShader->Program, "itemData");
+    glUniformBlockBinding(depthShader->Program, blockIndex, 0);
+    glBindBuffer(GL_UNIFORM_BUFFER, depthUBO);
+    glBufferSubData(GL_UNIFORM_BUFFER, 0, count * sizeof(mat4), model.data());
+    //! The whole block is bound, a smaller level of detail only draws fewer instances.
+    glBindBufferRange(GL_UNIFORM_BUFFER, 0, depthUBO, 0, quantity * sizeof(mat4));
+    glBindBuffer(GL_UNIFORM_BUFFER, 0);
+    glBindVertexArray(depthVAO);
+    glDrawElementsInstanced(GL_TRIANGLES, lodIndexCount(lod), GL_UNSIGNED_INT, lodIndexOffset(lod), count);
+    glBindVertexArray(0);
+}
+
+void Mesh::setLods(int indexSize)
+{
+    if (lodLevels < 1)
+    {
+        lodLevels = 1;
+        lodOffset[0] = 0;
+        lodCount[0] = indexSize;
+    }
+}
+
+GLsizei Mesh::lodIndexCount(int lod)
+{
+    return lodCount[glm::clamp(lod, 0, lodLevels - 1)];
+}
+
+GLvoid *Mesh::lodIndexOffset(int lod)
+{
+    return (GLvoid*)(lodOffset[glm::clamp(lod, 0, lodLevels - 1)] * sizeof(GLuint));
+}
+
 void Mesh::setType(string val)
 {
     type = val;
@@ -0,0 +1,379 @@
+/**********************************************************
+ *   MeshCache:  A class to keep the imported meshes of an
+ *   asset in a binary file and map them back in.
+ *   Created by: Edward Charles Eberle <eberdeed@eberdeed.net>
+ *   October 2026 San Diego, California USA
+ * ********************************************************/
+
+#include "../include/meshcache.h"
+#include "../include/info.h"
+#include "../include/meshtex.h"
+#include "../include/meshvert.h"
+#include "../include/assetpack.h"
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+bool MeshCache::enabled = true;
+bool MeshCache::debug1 = false;
+
+//! The start of a cache file.
+struct MeshCacheHeader {
+    char magic[4];
+    uint32_t version;
+    uint64_t length;
+    uint32_t meshCount;
+    float radius;
+    uint32_t occluderPositions, occluderIndices;
+    uint64_t occluderOffset;
+};
+
+//! One mesh, its arrays are at the offsets from the start of the file, 0 for none.
+struct MeshRecord {
+    uint32_t textured, packed, vertSize, indexSize, lodLevels;
+    uint32_t lodOffset[MAX_LODS], lodCount[MAX_LODS];
+    float color[3], opacity;
+    float posOffset[3], posScale[3], uvOffset[2], uvScale[2];
+    uint32_t imageCount;
+    uint64_t vertexOffset, packedOffset, indexOffset, imageOffset;
+};
+
+//! \brief Add bytes to the end of a file image, starting at a multiple of 16.
+static uint64_t append(vector<unsigned char> &file, const void *data, size_t size)
+{
+    file.resize((file.size() + 15) & ~(size_t) 15);
+    uint64_t offset = file.size();
+    file.insert(file.end(), (const unsigned char*) data, (const unsigned char*) data + size);
+    return offset;
+}
+
+string MeshCache::cachePath(string path, string settings)
+{
+    //! FNV-1a over the format, the settings and the contents of the sources.
+    string keyText = "ACMC 1\n" + settings + '\n' + to_string(sizeof(Vertex)) + ' ' + to_string(sizeof(Vertex1)) + '\n';
+    uint64_t key = 14695981039346656037ull;
+    for (unsigned int x = 0; x < keyText.size(); x++)
+    {
+        key = (key ^ (unsigned char) keyText[x]) * 1099511628211ull;
+    }
+    //! The model and its material libraries, the ones Assimp reads with it.
+    vector<boost::filesystem::path> sources;
+    sources.push_back(boost::filesystem::path(path));
+    boost::filesystem::path directory = sources[0].parent_path();
+    AssetPack &pack = AssetPack::shared();
+    if (pack.contains(path))
+    {
+        //! The pack has the hash of each file already.
+        vector<string> files = pack.list(directory.string());
+        for (unsigned int x = 0; x < files.size(); x++)
+        {
+            if (boost::filesystem::path(files[x]).extension() == ".mtl")
+            {
+                sources.push_back(boost::filesystem::path(files[x]));
+            }
+        }
+        sort(sources.begin() + 1, sources.end());
+        for (unsigned int x = 0; x < sources.size(); x++)
+        {
+            uint64_t hash = 0;
+            pack.contentHash(sources[x].string(), hash);
+            string text = sources[x].filename().string() + '\0' + to_string(hash) + '\n';
+            for (unsigned int y = 0; y < text.size(); y++)
+            {
+                key = (key ^ (unsigned char) text[y]) * 1099511628211ull;
+            }
+        }
+    }
+    else
+    {
+        boost::system::error_code error;
+        if (directory.empty())
+        {
+            directory = ".";
+        }
+        for (boost::filesystem::directory_iterator item(directory, error), end; (!error) && (item != end); item.increment(error))
+        {
+            if (item->path().extension() == ".mtl")
+            {
+                sources.push_back(item->path());
+            }
+        }
+        sort(sources.begin() + 1, sources.end());
+        vector<char> buffer(1 << 16);
+        for (unsigned int x = 0; x < sources.size(); x++)
+        {
+            string name = sources[x].filename().string() + '\0';
+            for (unsigned int y = 0; y < name.size(); y++)
+            {
+                key = (key ^ (unsigned char) name[y]) * 1099511628211ull;
+            }
+            boost::filesystem::ifstream source(sources[x], ios_base::in | ios_base::binary);
+            while (source.read(buffer.data(), buffer.size()) || (source.gcount() > 0))
+            {
+                for (streamsize y = 0; y < source.gcount(); y++)
+                {
+                    key = (key ^ (unsigned char) buffer[y]) * 1099511628211ull;
+                }
+            }
+        }
+    }
+    stringstream name;
+    name << hex << setw(16) << setfill('0') << key;
+    string home = getenv("HOME");
+    return home + "/.config/meshes/" + name.str() + ".mesh";
+}
+
+bool MeshCache::write(string cachePath, AssetData &asset)
+{
+    vector<unsigned char> file(sizeof(MeshCacheHeader) + asset.meshes.size() * sizeof(MeshRecord));
+    vector<MeshRecord> records(asset.meshes.size());
+    for (unsigned int x = 0; x < asset.meshes.size(); x++)
+    {
+        MeshData &item = asset.meshes[x];
+        Mesh *mesh = item.mesh;
+        MeshRecord &record = records[x];
+        memset(&record, 0, sizeof(record));
+        record.textured = item.textured;
+        record.packed = mesh->packed;
+        record.vertSize = item.vertSize;
+        record.indexSize = item.indexSize;
+        record.lodLevels = mesh->lodLevels;
+        for (int y = 0; y < MAX_LODS; y++)
+        {
+            record.lodOffset[y] = (y < mesh->lodLevels) ? mesh->lodOffset[y] : 0;
+            record.lodCount[y] = (y < mesh->lodLevels) ? mesh->lodCount[y] : 0;
+        }
+        for (int y = 0; y < 3; y++)
+        {
+            record.color[y] = item.color[y];
+            record.posOffset[y] = mesh->posOffset[y];
+            record.posScale[y] = mesh->posScale[y];
+        }
+        for (int y = 0; y < 2; y++)
+        {
+            record.uvOffset[y] = mesh->uvOffset[y];
+            record.uvScale[y] = mesh->uvScale[y];
+        }
+        record.opacity = item.opacity;
+        if (item.textured)
+        {
+            record.vertexOffset = append(file, item.vertices, item.vertSize * sizeof(Vertex));
+            if (mesh->packed)
+            {
+                record.packedOffset = append(file, ((MeshTex*) mesh)->packedVertices, item.vertSize * sizeof(VertexPacked));
+            }
+        }
+        else
+        {
+            record.vertexOffset = append(file, item.vertices1, item.vertSize * sizeof(Vertex1));
+            if (mesh->packed)
+            {
+                record.packedOffset = append(file, ((MeshVert*) mesh)->packedVertices, item.vertSize * sizeof(Vertex1Packed));
+            }
+        }
+        record.indexOffset = append(file, item.indices, item.indexSize * sizeof(GLuint));
+        //! Each image is its file name and its type, each with its length first.
+        record.imageCount = item.images.size();
+        string images;
+        for (unsigned int y = 0; y < item.images.size(); y++)
+        {
+            for (string text : {item.images[y].first, item.images[y].second})
+            {
+                uint32_t length = text.size();
+                images.append((const char*) &length, sizeof(length));
+                images += text;
+            }
+        }
+        record.imageOffset = append(file, images.data(), images.size());
+    }
+    MeshCacheHeader header;
+    memcpy(header.magic, "ACMC", 4);
+    header.version = 1;
+    header.meshCount = asset.meshes.size();
+    header.radius = asset.radius;
+    header.occluderPositions = asset.occluder.positions.size();
+    header.occluderIndices = asset.occluder.indices.size();
+    header.occluderOffset = append(file, asset.occluder.positions.data(), asset.occluder.positions.size() * sizeof(vec3));
+    append(file, asset.occluder.indices.data(), asset.occluder.indices.size() * sizeof(GLuint));
+    header.length = file.size();
+    memcpy(file.data(), &header, sizeof(header));
+    memcpy(file.data() + sizeof(header), records.data(), records.size() * sizeof(MeshRecord));
+    boost::system::error_code error;
+    create_directories(boost::filesystem::path(cachePath).parent_path(), error);
+    //! Write to the side and rename, so a reader never maps half a file.
+    string partial = cachePath + "." + to_string(getpid()) + "." + to_string(hash<thread::id>()(this_thread::get_id()));
+    boost::filesystem::ofstream output(partial, ios_base::out | ios_base::binary);
+    if (!output.is_open())
+    {
+        cout << "\n\n\tError opening mesh cache file " << partial << ".\n\n";
+        return false;
+    }
+    output.write((const char*) file.data(), file.size());
+    output.close();
+    if (output.fail())
+    {
+        cout << "\n\n\tError writing mesh cache file " << partial << ".\n\n";
+        remove(boost::filesystem::path(partial), error);
+        return false;
+    }
+    rename(boost::filesystem::path(partial), boost::filesystem::path(cachePath), error);
+    if (debug1)
+    {
+        cout << "\n\tWrote " << file.size() << " bytes to the mesh cache file " << cachePath << ".";
+    }
+    return !error;
+}
+
+AssetData *MeshCache::read(string cachePath)
+{
+    int fd = open(cachePath.c_str(), O_RDONLY);
+    if (fd < 0)
+    {
+        return nullptr;
+    }
+    struct stat info;
+    if ((fstat(fd, &info) != 0) || (info.st_size < (off_t) sizeof(MeshCacheHeader)))
+    {
+        close(fd);
+        return nullptr;
+    }
+    size_t fileSize = info.st_size;
+    //! Private and writable, so a mesh may change its arrays without touching the file.
+    void *mapped = mmap(nullptr, fileSize, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (mapped == MAP_FAILED)
+    {
+        cout << "\n\n\tError mapping file " << cachePath << ".\n\n";
+        return nullptr;
+    }
+    unsigned char *data = (unsigned char*) mapped;
+    MeshCacheHeader header;
+    memcpy(&header, data, sizeof(header));
+    //! An array is usable when it is aligned and inside the file.
+    auto inside = [fileSize](uint64_t offset, uint64_t size)
+    {
+        return (offset % 16 == 0) && (offset <= fileSize) && (size <= fileSize - offset);
+    };
+    bool response = (memcmp(header.magic, "ACMC", 4) == 0) && (header.version == 1)
+    && (header.length == fileSize)
+    && ((uint64_t) header.meshCount * sizeof(MeshRecord) <= fileSize - sizeof(header))
+    && (inside(header.occluderOffset, (uint64_t) header.occluderPositions * sizeof(vec3)));
+    vector<MeshRecord> records;
+    if (response)
+    {
+        records.resize(header.meshCount);
+        memcpy(records.data(), data + sizeof(header), records.size() * sizeof(MeshRecord));
+    }
+    for (unsigned int x = 0; (response) && (x < records.size()); x++)
+    {
+        MeshRecord &record = records[x];
+        size_t vertexSize = (record.textured) ? sizeof(Vertex) : sizeof(Vertex1);
+        size_t packedSize = (record.textured) ? sizeof(VertexPacked) : sizeof(Vertex1Packed);
+        response = (inside(record.vertexOffset, (uint64_t) record.vertSize * vertexSize))
+        && ((!record.packed) || (inside(record.packedOffset, (uint64_t) record.vertSize * packedSize)))
+        && (inside(record.indexOffset, (uint64_t) record.indexSize * sizeof(GLuint)))
+        && (record.lodLevels > 0) && (record.lodLevels <= MAX_LODS);
+        for (uint32_t y = 0; (response) && (y < record.lodLevels); y++)
+        {
+            response = ((uint64_t) record.lodOffset[y] + record.lodCount[y] <= record.indexSize);
+        }
+    }
+    if (!response)
+    {
+        cout << "\n\tThe mesh cache file:  " << cachePath << " is not usable.\n";
+        munmap(mapped, fileSize);
+        return nullptr;
+    }
+    AssetData *asset = new AssetData();
+    asset->mapped = mapped;
+    asset->mappedSize = fileSize;
+    asset->radius = header.radius;
+    vec3 *positions = (vec3*) (data + header.occluderOffset);
+    asset->occluder.positions.assign(positions, positions + header.occluderPositions);
+    size_t indexStart = (header.occluderOffset + header.occluderPositions * sizeof(vec3) + 15) & ~(size_t) 15;
+    if ((header.occluderIndices > 0) && (inside(indexStart, (uint64_t) header.occluderIndices * sizeof(GLuint))))
+    {
+        GLuint *indices = (GLuint*) (data + indexStart);
+        asset->occluder.indices.assign(indices, indices + header.occluderIndices);
+    }
+    for (unsigned int x = 0; x < records.size(); x++)
+    {
+        MeshRecord &record = records[x];
+        MeshData item;
+        item.textured = record.textured;
+        item.vertSize = record.vertSize;
+        item.indexSize = record.indexSize;
+        item.indices = (GLuint*) (data + record.indexOffset);
+        item.color = vec3(record.color[0], record.color[1], record.color[2]);
+        item.opacity = record.opacity;
+        //! The arrays are in the mapping, the meshes use them where they are.
+        if (item.textured)
+        {
+            MeshTex *meshTexPtr = new MeshTex();
+            item.mesh = meshTexPtr;
+            item.vertices = (Vertex*) (data + record.vertexOffset);
+            if (record.packed)
+            {
+                meshTexPtr->packedVertices = (VertexPacked*) (data + record.packedOffset);
+            }
+        }
+        else
+        {
+            MeshVert *meshVertPtr = new MeshVert();
+            item.mesh = meshVertPtr;
+            item.vertices1 = (Vertex1*) (data + record.vertexOffset);
+            if (record.packed)
+            {
+                meshVertPtr->packedVertices = (Vertex1Packed*) (data + record.packedOffset);
+            }
+        }
+        Mesh *mesh = item.mesh;
+        mesh->mapped = true;
+        mesh->packed = record.packed;
+        mesh->lodLevels = record.lodLevels;
+        for (uint32_t y = 0; y < record.lodLevels; y++)
+        {
+            mesh->lodOffset[y] = record.lodOffset[y];
+            mesh->lodCount[y] = record.lodCount[y];
+        }
+        mesh->posOffset = vec3(record.posOffset[0], record.posOffset[1], record.posOffset[2]);
+        mesh->posScale = vec3(record.posScale[0], record.posScale[1], record.posScale[2]);
+        mesh->uvOffset = vec2(record.uvOffset[0], record.uvOffset[1]);
+        mesh->uvScale = vec2(record.uvScale[0], record.uvScale[1]);
+        size_t offset = record.imageOffset;
+        for (uint32_t y = 0; y < record.imageCount; y++)
+        {
+            string text[2];
+            for (int z = 0; z < 2; z++)
+            {
+                uint32_t length = 0;
+                if (offset + sizeof(length) <= fileSize)
+                {
+                    memcpy(&length, data + offset, sizeof(length));
+                }
+                offset += sizeof(length);
+                if ((offset <= fileSize) && (length <= fileSize - offset))
+                {
+                    text[z].assign((const char*) data + offset, length);
+                    offset += length;
+                }
+            }
+            item.images.push_back(make_pair(text[0], text[1]));
+        }
+        asset->meshes.push_back(item);
+    }
+    if (debug1)
+    {
+        cout << "\n\tRead " << records.size() << " meshes from the mesh cache file " << cachePath << ".";
+    }
+    return asset;
+}
+
+void MeshCache::unmap(void *mapped, size_t mappedSize)
+{
+    if (mapped != nullptr)
+    {
+        munmap(mapped, mappedSize);
+    }
+}
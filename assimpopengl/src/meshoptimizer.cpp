@@ -0,0 +1,420 @@
+/**********************************************************
+ *   MeshOptimizer:  A class to reorder the vertex and index
+ *   arrays of a mesh when it is imported.  The vertex cache
+ *   stage follows Tom Forsyth's "Linear-Speed Vertex Cache
+ *   Optimisation" and the overdraw stage follows the cluster
+ *   sort of Sander, Nehab and Barczak "Fast Triangle Reordering
+ *   for Vertex Locality and Reduced Overdraw".
+ *   Created by: Edward Charles Eberle <eberdeed@eberdeed.net>
+ *   October 2026 San Diego, California USA
+ * ********************************************************/
+
+#include "../include/meshoptimizer.h"
+
+MeshOptimizer::MeshOptimizer()
+{
+    cout << "\n\n\tCreating MeshOptimizer.\n\n";
+}
+
+MeshOptimizer::~MeshOptimizer()
+{
+    cout << "\n\n\tDestroying MeshOptimizer.\n\n";
+}
+
+int MeshOptimizer::optimize(float *vertices, int vertSize, int stride, GLuint *indices, int indexSize)
+{
+    int triCount = indexSize / 3;
+    if (triCount < 1)
+    {
+        return vertSize;
+    }
+    float acmrBefore = calcACMR(indices, indexSize, vertSize);
+    int before = vertSize;
+    vertSize = weldVertices(vertices, vertSize, stride, indices, indexSize);
+    optimizeVertexCache(indices, indexSize, vertSize);
+    optimizeOverdraw(indices, indexSize, vertices, vertSize, stride, overdrawThreshold);
+    vertSize = optimizeVertexFetch(vertices, vertSize, stride, indices, indexSize);
+    float acmrAfter = calcACMR(indices, indexSize, vertSize);
+    totalTriangles += triCount;
+    totalVertsBefore += before;
+    totalVertsAfter += vertSize;
+    totalMissesBefore += acmrBefore * triCount;
+    totalMissesAfter += acmrAfter * triCount;
+    //! Formatted apart, so cout keeps its own format.
+    ostringstream acmr;
+    acmr << fixed << setprecision(3) << acmrBefore << " -> " << acmrAfter;
+    cout << "\n\n\tOptimized mesh of " << triCount << " triangles:  vertices "
+    << before << " -> " << vertSize << ", ACMR " << acmr.str() << ".\n\n";
+    return vertSize;
+}
+
+int MeshOptimizer::weldVertices(float *vertices, int vertSize, int stride, GLuint *indices, int indexSize)
+{
+    size_t bytes = stride * sizeof(float);
+    //! Hash and compare vertices through their index.
+    auto hasher = [vertices, bytes, stride](GLuint v)
+    {
+        const unsigned char *data = (const unsigned char*) &vertices[v * stride];
+        size_t hash = 2166136261u;
+        for (size_t x = 0; x < bytes; x++)
+        {
+            hash = (hash ^ data[x]) * 16777619u;
+        }
+        return hash;
+    };
+    auto equal = [vertices, bytes, stride](GLuint a, GLuint b)
+    {
+        return memcmp(&vertices[a * stride], &vertices[b * stride], bytes) == 0;
+    };
+    unordered_map<GLuint, GLuint, decltype(hasher), decltype(equal)> unique(vertSize * 2, hasher, equal);
+    vector<GLuint> remap(vertSize);
+    vector<bool> first(vertSize, false);
+    GLuint count = 0;
+    for (int x = 0; x < vertSize; x++)
+    {
+        auto result = unique.emplace((GLuint) x, count);
+        if (result.second)
+        {
+            first[x] = true;
+            count++;
+        }
+        remap[x] = result.first->second;
+    }
+    //! Compact the array, every new slot is at or below its old slot.
+    for (int x = 0; x < vertSize; x++)
+    {
+        if ((first[x]) && (remap[x] != (GLuint) x))
+        {
+            memmove(&vertices[remap[x] * stride], &vertices[x * stride], bytes);
+        }
+    }
+    for (int x = 0; x < indexSize; x++)
+    {
+        indices[x] = remap[indices[x]];
+    }
+    return count;
+}
+
+float MeshOptimizer::vertexScore(int cachePos, int valence)
+{
+    //! No triangles left to use the vertex.
+    if (valence == 0)
+    {
+        return -1.0f;
+    }
+    float score = 0.0f;
+    if (cachePos >= 0)
+    {
+        //! The last triangle's vertices get a fixed score so
+        //! the next triangle does not simply reuse them.
+        if (cachePos < 3)
+        {
+            score = 0.75f;
+        }
+        else
+        {
+            score = powf(1.0f - (float)(cachePos - 3) / (float)(maxCache - 3), 1.5f);
+        }
+    }
+    //! Favor vertices with few triangles left, to finish them off.
+    score += 2.0f * powf((float) valence, -0.5f);
+    return score;
+}
+
+void MeshOptimizer::optimizeVertexCache(GLuint *indices, int indexSize, int vertSize)
+{
+    int triCount = indexSize / 3;
+    if (triCount < 2)
+    {
+        return;
+    }
+    //! The triangles that use each vertex.
+    vector<int> valence(vertSize, 0);
+    for (int x = 0; x < triCount * 3; x++)
+    {
+        valence[indices[x]]++;
+    }
+    vector<int> offsets(vertSize + 1, 0);
+    for (int x = 0; x < vertSize; x++)
+    {
+        offsets[x + 1] = offsets[x] + valence[x];
+    }
+    vector<int> adjacency(triCount * 3);
+    vector<int> fill(offsets.begin(), offsets.end() - 1);
+    for (int x = 0; x < triCount * 3; x++)
+    {
+        adjacency[fill[indices[x]]++] = x / 3;
+    }
+    vector<int> cachePos(vertSize, -1);
+    vector<float> vScore(vertSize);
+    for (int x = 0; x < vertSize; x++)
+    {
+        vScore[x] = vertexScore(-1, valence[x]);
+    }
+    vector<float> tScore(triCount);
+    vector<bool> emitted(triCount, false);
+    int bestTri = -1;
+    float bestScore = -1.0f;
+    for (int x = 0; x < triCount; x++)
+    {
+        tScore[x] = vScore[indices[x * 3]] + vScore[indices[x * 3 + 1]] + vScore[indices[x * 3 + 2]];
+        if (tScore[x] > bestScore)
+        {
+            bestScore = tScore[x];
+            bestTri = x;
+        }
+    }
+    vector<GLuint> output;
+    output.reserve(triCount * 3);
+    int cache[maxCache + 3], newCache[maxCache + 3];
+    int cacheCount = 0, newCount, cursor = 0;
+    for (int done = 0; done < triCount; done++)
+    {
+        if (bestTri < 0)
+        {
+            //! Nothing in the cache is usable, start on the next unused triangle.
+            while (emitted[cursor])
+            {
+                cursor++;
+            }
+            bestTri = cursor;
+        }
+        GLuint *tri = &indices[bestTri * 3];
+        emitted[bestTri] = true;
+        newCount = 0;
+        for (int k = 0; k < 3; k++)
+        {
+            int v = tri[k];
+            output.push_back(v);
+            //! Remove the triangle from the vertex's live list.
+            int *list = &adjacency[offsets[v]];
+            for (int x = 0; x < valence[v]; x++)
+            {
+                if (list[x] == bestTri)
+                {
+                    list[x] = list[valence[v] - 1];
+                    valence[v]--;
+                    break;
+                }
+            }
+            if (find(newCache, newCache + newCount, v) == newCache + newCount)
+            {
+                newCache[newCount++] = v;
+            }
+        }
+        for (int x = 0; x < cacheCount; x++)
+        {
+            if ((cache[x] != (int) tri[0]) && (cache[x] != (int) tri[1]) && (cache[x] != (int) tri[2]))
+            {
+                newCache[newCount++] = cache[x];
+            }
+        }
+        for (int x = 0; x < newCount; x++)
+        {
+            int v = newCache[x];
+            cachePos[v] = (x < maxCache) ? x : -1;
+            vScore[v] = vertexScore(cachePos[v], valence[v]);
+        }
+        cacheCount = std::min(newCount, (int) maxCache);
+        memcpy(cache, newCache, cacheCount * sizeof(int));
+        //! Rescore the triangles around the vertices that changed.
+        bestTri = -1;
+        bestScore = -1.0f;
+        for (int x = 0; x < newCount; x++)
+        {
+            int v = newCache[x];
+            for (int y = 0; y < valence[v]; y++)
+            {
+                int t = adjacency[offsets[v] + y];
+                float score = vScore[indices[t * 3]] + vScore[indices[t * 3 + 1]] + vScore[indices[t * 3 + 2]];
+                tScore[t] = score;
+                if (score > bestScore)
+                {
+                    bestScore = score;
+                    bestTri = t;
+                }
+            }
+        }
+    }
+    memcpy(indices, output.data(), triCount * 3 * sizeof(GLuint));
+}
+
+int MeshOptimizer::cacheMisses(GLuint *tri, vector<unsigned int> &stamps, unsigned int &timestamp)
+{
+    int misses = 0;
+    for (int k = 0; k < 3; k++)
+    {
+        //! A vertex is in the FIFO if it entered less than cacheSize misses ago.
+        if (timestamp - stamps[tri[k]] > (unsigned int) cacheSize)
+        {
+            stamps[tri[k]] = timestamp++;
+            misses++;
+        }
+    }
+    return misses;
+}
+
+void MeshOptimizer::optimizeOverdraw(GLuint *indices, int indexSize, float *vertices, int vertSize, int stride, float threshold)
+{
+    int triCount = indexSize / 3;
+    if (triCount < 2)
+    {
+        return;
+    }
+    vector<unsigned int> stamps(vertSize, 0);
+    unsigned int timestamp = cacheSize + 1;
+    //! Hard boundaries are where the cache ordering started over.
+    vector<int> hard;
+    hard.push_back(0);
+    for (int t = 0; t < triCount; t++)
+    {
+        if ((cacheMisses(&indices[t * 3], stamps, timestamp) == 3) && (t > 0))
+        {
+            hard.push_back(t);
+        }
+    }
+    hard.push_back(triCount);
+    //! Soft boundaries split a cluster while its ACMR stays within the threshold.
+    vector<int> clusters;
+    for (unsigned int h = 0; h + 1 < hard.size(); h++)
+    {
+        int start = hard[h], end = hard[h + 1];
+        int misses = 0;
+        timestamp += cacheSize + 1;
+        for (int t = start; t < end; t++)
+        {
+            misses += cacheMisses(&indices[t * 3], stamps, timestamp);
+        }
+        float clusterThreshold = threshold * (float) misses / (float) (end - start);
+        clusters.push_back(start);
+        misses = 0;
+        timestamp += cacheSize + 1;
+        for (int t = start; t < end; t++)
+        {
+            misses += cacheMisses(&indices[t * 3], stamps, timestamp);
+            if ((t + 1 < end) && ((float) misses / (float) (t - start + 1) <= clusterThreshold))
+            {
+                clusters.push_back(t + 1);
+                start = t + 1;
+                misses = 0;
+                timestamp += cacheSize + 1;
+            }
+        }
+    }
+    int clusterCount = clusters.size();
+    clusters.push_back(triCount);
+    //! The area weighted centroid of the mesh.
+    vec3 meshCenter = vec3(0.0f);
+    float meshArea = 0.0f;
+    vector<vec3> centers(clusterCount), normals(clusterCount);
+    for (int c = 0; c < clusterCount; c++)
+    {
+        vec3 center = vec3(0.0f), normal = vec3(0.0f);
+        float area = 0.0f;
+        for (int t = clusters[c]; t < clusters[c + 1]; t++)
+        {
+            float *p0 = &vertices[indices[t * 3] * stride];
+            float *p1 = &vertices[indices[t * 3 + 1] * stride];
+            float *p2 = &vertices[indices[t * 3 + 2] * stride];
+            vec3 a = vec3(p0[0], p0[1], p0[2]);
+            vec3 b = vec3(p1[0], p1[1], p1[2]);
+            vec3 d = vec3(p2[0], p2[1], p2[2]);
+            vec3 n = cross(b - a, d - a);
+            float triArea = length(n);
+            center += (a + b + d) * (triArea / 3.0f);
+            normal += n;
+            area += triArea;
+        }
+        meshCenter += center;
+        meshArea += area;
+        centers[c] = (area > 0.0f) ? center / area : center;
+        normals[c] = normal;
+    }
+    if (meshArea > 0.0f)
+    {
+        meshCenter /= meshArea;
+    }
+    //! Clusters far out and facing out are drawn first, they hide the rest.
+    vector<float> keys(clusterCount);
+    vector<int> order(clusterCount);
+    for (int c = 0; c < clusterCount; c++)
+    {
+        float len = length(normals[c]);
+        keys[c] = (len > 0.0f) ? dot(centers[c] - meshCenter, normals[c] / len) : 0.0f;
+        order[c] = c;
+    }
+    stable_sort(order.begin(), order.end(), [&keys](int a, int b) { return keys[a] > keys[b]; });
+    vector<GLuint> output;
+    output.reserve(triCount * 3);
+    for (int c = 0; c < clusterCount; c++)
+    {
+        output.insert(output.end(), &indices[clusters[order[c]] * 3], &indices[clusters[order[c] + 1] * 3]);
+    }
+    memcpy(indices, output.data(), triCount * 3 * sizeof(GLuint));
+    if (debug1)
+    {
+        cout << "\n\tOverdraw clusters:  " << clusterCount << " from "
+        << hard.size() - 1 << " cache restarts.";
+    }
+}
+
+int MeshOptimizer::optimizeVertexFetch(float *vertices, int vertSize, int stride, GLuint *indices, int indexSize)
+{
+    vector<int> remap(vertSize, -1);
+    int count = 0;
+    for (int x = 0; x < indexSize; x++)
+    {
+        if (remap[indices[x]] < 0)
+        {
+            remap[indices[x]] = count++;
+        }
+        indices[x] = remap[indices[x]];
+    }
+    vector<float> reordered(count * stride);
+    for (int x = 0; x < vertSize; x++)
+    {
+        if (remap[x] >= 0)
+        {
+            memcpy(&reordered[remap[x] * stride], &vertices[x * stride], stride * sizeof(float));
+        }
+    }
+    memcpy(vertices, reordered.data(), count * stride * sizeof(float));
+    return count;
+}
+
+float MeshOptimizer::calcACMR(GLuint *indices, int indexSize, int vertSize)
+{
+    int triCount = indexSize / 3;
+    if (triCount < 1)
+    {
+        return 0.0f;
+    }
+    vector<unsigned int> stamps(vertSize, 0);
+    unsigned int timestamp = cacheSize + 1;
+    int misses = 0;
+    for (int t = 0; t < triCount; t++)
+    {
+        misses += cacheMisses(&indices[t * 3], stamps, timestamp);
+    }
+    return (float) misses / (float) triCount;
+}
+
+void MeshOptimizer::resetStats()
+{
+    totalTriangles = totalVertsBefore = totalVertsAfter = 0;
+    totalMissesBefore = totalMissesAfter = 0.0;
+}
+
+void MeshOptimizer::printStats(string name)
+{
+    if (totalTriangles == 0)
+    {
+        return;
+    }
+    ostringstream acmr;
+    acmr << fixed << setprecision(3) << totalMissesBefore / totalTriangles
+    << " -> " << totalMissesAfter / totalTriangles;
+    cout << "\n\n\tMesh optimization for " << name << ":  " << totalTriangles
+    << " triangles, vertices " << totalVertsBefore << " -> " << totalVertsAfter
+    << ", ACMR " << acmr.str() << ".\n\n";
+}
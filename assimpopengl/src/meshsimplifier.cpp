@@ -0,0 +1,318 @@
+/**********************************************************
+ *   MeshSimplifier:  A class to build the simplified levels
+ *   of detail of a mesh when it is imported, by quadric error
+ *   edge collapse (Garland and Heckbert).
+ *   Created by: Edward Charles Eberle <eberdeed@eberdeed.net>
+ *   October 2026 San Diego, California USA
+ * ********************************************************/
+
+#include "../include/meshsimplifier.h"
+#include <unordered_set>
+
+MeshSimplifier::MeshSimplifier()
+{
+    cout << "\n\n\tCreating MeshSimplifier.\n\n";
+}
+
+MeshSimplifier::~MeshSimplifier()
+{
+    cout << "\n\n\tDestroying MeshSimplifier.\n\n";
+}
+
+void MeshSimplifier::addPlane(Quadric &q, const vec3 &p0, const vec3 &p1, const vec3 &p2)
+{
+    vec3 normal = cross(p1 - p0, p2 - p0);
+    float area = length(normal);
+    if (area <= 0.0f)
+    {
+        return;
+    }
+    normal /= area;
+    double a = normal.x, b = normal.y, c = normal.z, d = -dot(normal, p0);
+    //! Weight by the triangle area so large faces hold their shape.
+    double w = area * 0.5;
+    q.a2 += w * a * a; q.b2 += w * b * b; q.c2 += w * c * c; q.d2 += w * d * d;
+    q.ab += w * a * b; q.ac += w * a * c; q.ad += w * a * d;
+    q.bc += w * b * c; q.bd += w * b * d; q.cd += w * c * d;
+}
+
+void MeshSimplifier::addQuadric(Quadric &q, const Quadric &r)
+{
+    q.a2 += r.a2; q.b2 += r.b2; q.c2 += r.c2; q.d2 += r.d2;
+    q.ab += r.ab; q.ac += r.ac; q.ad += r.ad;
+    q.bc += r.bc; q.bd += r.bd; q.cd += r.cd;
+}
+
+double MeshSimplifier::quadricError(const Quadric &q, const vec3 &p)
+{
+    double x = p.x, y = p.y, z = p.z;
+    double error = q.a2 * x * x + q.b2 * y * y + q.c2 * z * z
+        + 2.0 * (q.ab * x * y + q.ac * x * z + q.bc * y * z)
+        + 2.0 * (q.ad * x + q.bd * y + q.cd * z) + q.d2;
+    return fabs(error);
+}
+
+bool MeshSimplifier::flips(const vector<GLuint> &triangles, const GLuint *indices, GLuint from, GLuint to)
+{
+    GLuint posFrom = positionRemap[from], posTo = positionRemap[to];
+    for (GLuint tri : triangles)
+    {
+        const GLuint *corner = &indices[tri * 3];
+        vec3 p[3], q[3];
+        bool removed = false;
+        for (int x = 0; x < 3; x++)
+        {
+            p[x] = q[x] = positions[corner[x]];
+            if (positionRemap[corner[x]] == posTo)
+            {
+                removed = true;
+            }
+            else if (positionRemap[corner[x]] == posFrom)
+            {
+                q[x] = positions[to];
+            }
+        }
+        //! Triangles holding both ends of the edge disappear.
+        if (removed)
+        {
+            continue;
+        }
+        vec3 before = cross(p[1] - p[0], p[2] - p[0]);
+        vec3 after = cross(q[1] - q[0], q[2] - q[0]);
+        if (dot(before, after) <= 0.25f * length(before) * length(after))
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+int MeshSimplifier::simplify(const float *vertices, int vertSize, int stride, const GLuint *indices, int indexSize,
+    GLuint *destination, int targetIndexSize, float targetError)
+{
+    memcpy(destination, indices, indexSize * sizeof(GLuint));
+    lastError = 0.0f;
+    int count = indexSize;
+    if ((targetIndexSize >= indexSize) || (indexSize < 3) || (vertSize < 3))
+    {
+        return count;
+    }
+    //! Vertices that share a position are moved together.
+    positions.resize(vertSize);
+    positionRemap.resize(vertSize);
+    auto hasher = [vertices, stride](GLuint v)
+    {
+        const unsigned char *data = (const unsigned char*) &vertices[v * stride];
+        size_t hash = 2166136261u;
+        for (size_t x = 0; x < 3 * sizeof(float); x++)
+        {
+            hash = (hash ^ data[x]) * 16777619u;
+        }
+        return hash;
+    };
+    auto equal = [vertices, stride](GLuint a, GLuint b)
+    {
+        return memcmp(&vertices[a * stride], &vertices[b * stride], 3 * sizeof(float)) == 0;
+    };
+    unordered_map<GLuint, GLuint, decltype(hasher), decltype(equal)> unique(vertSize * 2, hasher, equal);
+    vec3 low = vec3(vertices[0], vertices[1], vertices[2]), high = low;
+    for (int x = 0; x < vertSize; x++)
+    {
+        positions[x] = vec3(vertices[x * stride], vertices[x * stride + 1], vertices[x * stride + 2]);
+        positionRemap[x] = unique.emplace((GLuint) x, (GLuint) x).first->second;
+        low = glm::min(low, positions[x]);
+        high = glm::max(high, positions[x]);
+    }
+    vec3 size = high - low;
+    float extent = std::max(size.x, std::max(size.y, size.z));
+    if (extent <= 0.0f)
+    {
+        return count;
+    }
+    double errorLimit = (targetError * extent) * (targetError * extent);
+    double maxError = 0.0;
+    vector<Quadric> quadrics(vertSize);
+    for (int x = 0; x < count; x += 3)
+    {
+        Quadric q;
+        addPlane(q, positions[indices[x]], positions[indices[x + 1]], positions[indices[x + 2]]);
+        for (int y = 0; y < 3; y++)
+        {
+            addQuadric(quadrics[positionRemap[indices[x + y]]], q);
+        }
+    }
+    vector<GLuint> adjStart(vertSize + 1), adjList, remap(vertSize), wedges(vertSize * 2), wedgeCount(vertSize);
+    vector<char> kind(vertSize), touched(vertSize), border(vertSize);
+    vector<Collapse> collapses;
+    unordered_set<unsigned long long> wedgeEdges, positionEdges;
+    auto edgeKey = [](GLuint a, GLuint b)
+    {
+        return ((unsigned long long) a << 32) | b;
+    };
+    while (count > targetIndexSize)
+    {
+        //! The triangles around each position.
+        fill(adjStart.begin(), adjStart.end(), 0);
+        for (int x = 0; x < count; x++)
+        {
+            adjStart[positionRemap[destination[x]] + 1]++;
+        }
+        for (int x = 0; x < vertSize; x++)
+        {
+            adjStart[x + 1] += adjStart[x];
+        }
+        adjList.resize(count);
+        vector<GLuint> fillPos(adjStart.begin(), adjStart.end() - 1);
+        for (int x = 0; x < count; x++)
+        {
+            adjList[fillPos[positionRemap[destination[x]]]++] = x / 3;
+        }
+        //! The half edges, by vertex and by position.
+        wedgeEdges.clear();
+        positionEdges.clear();
+        fill(wedgeCount.begin(), wedgeCount.end(), 0);
+        fill(border.begin(), border.end(), 0);
+        for (int x = 0; x < count; x++)
+        {
+            GLuint a = destination[x], b = destination[(x % 3 == 2) ? x - 2 : x + 1];
+            wedgeEdges.insert(edgeKey(a, b));
+            positionEdges.insert(edgeKey(positionRemap[a], positionRemap[b]));
+            GLuint pos = positionRemap[a];
+            if (((wedgeCount[pos] < 1) || (wedges[pos * 2] != a))
+                && ((wedgeCount[pos] < 2) || (wedges[pos * 2 + 1] != a)))
+            {
+                if (wedgeCount[pos] < 2)
+                {
+                    wedges[pos * 2 + wedgeCount[pos]] = a;
+                }
+                wedgeCount[pos]++;
+            }
+        }
+        for (int x = 0; x < count; x++)
+        {
+            GLuint a = positionRemap[destination[x]];
+            GLuint b = positionRemap[destination[(x % 3 == 2) ? x - 2 : x + 1]];
+            if (positionEdges.find(edgeKey(b, a)) == positionEdges.end())
+            {
+                border[a] = border[b] = 1;
+            }
+        }
+        for (int x = 0; x < vertSize; x++)
+        {
+            if ((border[x]) || (wedgeCount[x] > 2))
+            {
+                kind[x] = locked;
+            }
+            else
+            {
+                kind[x] = (wedgeCount[x] == 2) ? seam : manifold;
+            }
+        }
+        //! Every edge in both directions, cheapest first.
+        collapses.clear();
+        for (int x = 0; x < count; x++)
+        {
+            GLuint a = destination[x], b = destination[(x % 3 == 2) ? x - 2 : x + 1];
+            bool seamEdge = wedgeEdges.find(edgeKey(b, a)) == wedgeEdges.end();
+            GLuint ends[2][2] = {{a, b}, {b, a}};
+            for (int y = 0; y < 2; y++)
+            {
+                GLuint from = ends[y][0], to = ends[y][1];
+                GLuint pos = positionRemap[from];
+                if ((pos == positionRemap[to]) || (kind[pos] == locked)
+                    || ((kind[pos] == seam) && (!seamEdge)))
+                {
+                    continue;
+                }
+                collapses.push_back({from, to, quadricError(quadrics[pos], positions[to])});
+            }
+        }
+        sort(collapses.begin(), collapses.end(), [](const Collapse &a, const Collapse &b)
+        {
+            return a.cost < b.cost;
+        });
+        fill(touched.begin(), touched.end(), 0);
+        for (int x = 0; x < vertSize; x++)
+        {
+            remap[x] = x;
+        }
+        int goal = (count - targetIndexSize) / 3, removed = 0;
+        for (Collapse &item : collapses)
+        {
+            if ((item.cost > errorLimit) || (removed >= goal))
+            {
+                break;
+            }
+            GLuint posFrom = positionRemap[item.from], posTo = positionRemap[item.to];
+            if ((touched[posFrom]) || (touched[posTo]))
+            {
+                continue;
+            }
+            vector<GLuint> around(&adjList[adjStart[posFrom]], &adjList[0] + adjStart[posFrom + 1]);
+            if (flips(around, destination, item.from, item.to))
+            {
+                continue;
+            }
+            if (kind[posFrom] == seam)
+            {
+                //! The other side of the seam follows along its own edge.
+                GLuint sibling = (wedges[posFrom * 2] == item.from) ? wedges[posFrom * 2 + 1] : wedges[posFrom * 2];
+                GLuint partner = item.to;
+                for (GLuint tri : around)
+                {
+                    bool hasSibling = false;
+                    GLuint other = item.to;
+                    for (int y = 0; y < 3; y++)
+                    {
+                        hasSibling |= (destination[tri * 3 + y] == sibling);
+                        if (positionRemap[destination[tri * 3 + y]] == posTo)
+                        {
+                            other = destination[tri * 3 + y];
+                        }
+                    }
+                    if ((hasSibling) && (other != item.to))
+                    {
+                        partner = other;
+                        break;
+                    }
+                }
+                if ((partner == item.to) || (flips(around, destination, sibling, partner)))
+                {
+                    continue;
+                }
+                remap[sibling] = partner;
+            }
+            remap[item.from] = item.to;
+            addQuadric(quadrics[posTo], quadrics[posFrom]);
+            touched[posFrom] = touched[posTo] = 1;
+            maxError = std::max(maxError, item.cost);
+            //! An interior edge takes two triangles with it.
+            removed += 2;
+        }
+        if (removed == 0)
+        {
+            break;
+        }
+        //! Rewrite the triangles and drop the collapsed ones.
+        int write = 0;
+        for (int x = 0; x < count; x += 3)
+        {
+            GLuint a = remap[destination[x]], b = remap[destination[x + 1]], c = remap[destination[x + 2]];
+            GLuint pa = positionRemap[a], pb = positionRemap[b], pc = positionRemap[c];
+            if ((pa != pb) && (pb != pc) && (pa != pc))
+            {
+                destination[write++] = a;
+                destination[write++] = b;
+                destination[write++] = c;
+            }
+        }
+        count = write;
+    }
+    lastError = sqrt(maxError) / extent;
+    if (debug1)
+    {
+        cout << "\n\tSimplified " << indexSize / 3 << " triangles to " << count / 3
+        << " with error " << lastError << ".";
+    }
+    return count;
+}
@@ -19,8 +19,19 @@ MeshTex::~MeshTex()
     cout << "\n\n\tDestroying MeshTex.\n\n";
     // Properly de-allocate all resources once they've outlived their purpose
     glDeleteVertexArrays(1, &VAO);
-    glDeleteBuffers(1, &VBO[0]);
+    if (instanced)
+    {
+        glDeleteBuffers(2, VBO);
+        ResourceRegistry::shared().releaseGL(ResourceRegistry::BUFFER, VBO[1]);
+    }
+    else
+    {
+        glDeleteBuffers(1, &VBO[0]);
+    }
     glDeleteBuffers(1, &EBO);
+    ResourceRegistry::shared().releaseGL(ResourceRegistry::BUFFER, VBO[0]);
+    ResourceRegistry::shared().releaseGL(ResourceRegistry::BUFFER, EBO);
+    releaseArrays();
 }
 void MeshTex::debug(mat4 *modelData)
 {
@@ -43,9 +54,19 @@ int MeshTex::setData(Vertex *vertices, GLuint *indices, vector<Texture>textures,
     this->instanced = instanced;
     this->quantity = quantity;
     this->shader = shader;
+    setLods(indexSize);
     if ((instanced) && (quantity > 0))
     {
         instanceArray = new mat4[quantity];
+        ResourceRegistry::shared().trackHeap(instanceArray, "Mesh instances", quantity * sizeof(mat4));
+    }
+    //! The arrays are the mesh's from here, unless they are in a mapped file.
+    if (!mapped)
+    {
+        ResourceRegistry &registry = ResourceRegistry::shared();
+        registry.trackHeap(vertices, "Mesh arrays", (long) vertSize * sizeof(Vertex));
+        registry.trackHeap(indices, "Mesh arrays", (long) indexSize * sizeof(GLuint));
+        registry.trackHeap(packedVertices, "Mesh arrays", (long) vertSize * sizeof(VertexPacked));
     }
     numDiff = 0;
     //! Bind appropriate textures
@@ -111,6 +132,19 @@ int MeshTex::setData(Vertex *vertices, GLuint *indices, vector<Texture>textures,
        isBinorm = false;
        binormOne = dummyTex++ + startIndex;
     }
+    //! A program compiled for the textures this mesh actually has.
+    if (shader != nullptr)
+    {
+        vector<string> variantDefines;
+        variantDefines.push_back("NUM_DIFFUSE " + to_string(numDiff));
+        //! The normal map is only read by the lit programs, unlit it would make a copy of the plain one.
+        bool lit = find(shader->defines.begin(), shader->defines.end(), "LIT") != shader->defines.end();
+        if ((isBinorm) && (lit))
+        {
+            variantDefines.push_back("NORMAL_MAP");
+        }
+        this->shader = shader->variant(variantDefines);
+    }
     if (instanced)
     {
         setupInstancedMesh();
@@ -126,6 +160,42 @@ int MeshTex::setData(Vertex *vertices, GLuint *indices, vector<Texture>textures,
     return (startIndex + 4);
 }
 
+void MeshTex::releaseArrays()
+{
+    if (!mapped)
+    {
+        ResourceRegistry &registry = ResourceRegistry::shared();
+        registry.releaseHeap(vertices);
+        registry.releaseHeap(indices);
+        registry.releaseHeap(packedVertices);
+        delete [] vertices;
+        delete [] indices;
+        delete [] packedVertices;
+    }
+    vertices = nullptr;
+    indices = nullptr;
+    packedVertices = nullptr;
+}
+
+void MeshTex::adoptArrays(MeshTex *source)
+{
+    releaseArrays();
+    vertices = source->vertices;
+    indices = source->indices;
+    packedVertices = source->packedVertices;
+    mapped = source->mapped;
+    source->vertices = nullptr;
+    source->indices = nullptr;
+    source->packedVertices = nullptr;
+    if (!mapped)
+    {
+        ResourceRegistry &registry = ResourceRegistry::shared();
+        registry.trackHeap(vertices, "Mesh arrays", (long) vertSize * sizeof(Vertex));
+        registry.trackHeap(indices, "Mesh arrays", (long) indexSize * sizeof(GLuint));
+        registry.trackHeap(packedVertices, "Mesh arrays", (long) vertSize * sizeof(VertexPacked));
+    }
+}
+
 //! For debugging.
 void MeshTex::dumpData()
 {
@@ -136,15 +206,6 @@ void MeshTex::dumpData()
         " Normal: " << vertices[x].Normal[0] << ", " << vertices[x].Normal[1] << ", " << vertices[x].Normal[2] <<
         " TexCoord: " << vertices[x].TexCoords[0] << ", " << vertices[x].TexCoords[1];
     }
-    if (instanced)
-    {
-        for (int x = 0; x < indexSize; x++)
-        {
-            cout << "\n\tIndexed Vertex: " << verticesIndexed[x].Position[0] << ", " << verticesIndexed[x].Position[1] << ", " << verticesIndexed[x].Position[2] <<
-            " Normal: " << verticesIndexed[x].Normal[0] << ", " << verticesIndexed[x].Normal[1] << ", " << verticesIndexed[x].Normal[2] <<
-            " TexCoord: " << verticesIndexed[x].TexCoords[0] << ", " << verticesIndexed[x].TexCoords[1];
-        }
-    }
     cout << "\n\n\n\tIndices: \n\n";
     for (int x = 0; x < indexSize; x++)
     {
@@ -173,18 +234,40 @@ void MeshTex::setupMesh()
     
     glBindVertexArray(VAO);
     glBindBuffer(GL_ARRAY_BUFFER, VBO[0]);
-    glBufferData(GL_ARRAY_BUFFER, vertSize * sizeof(Vertex), vertices, GL_STATIC_DRAW); 
+    if (packed)
+    {
+        glBufferData(GL_ARRAY_BUFFER, vertSize * sizeof(VertexPacked), packedVertices, GL_STATIC_DRAW);
+    }
+    else
+    {
+        glBufferData(GL_ARRAY_BUFFER, vertSize * sizeof(Vertex), vertices, GL_STATIC_DRAW); 
+    }
    
     glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
     glBufferData(GL_ELEMENT_ARRAY_BUFFER, indexSize * sizeof(GLuint), indices, GL_STATIC_DRAW);
+    ResourceRegistry::shared().trackGL(ResourceRegistry::BUFFER, VBO[0], "Mesh buffers", (long) vertSize * ((packed) ? sizeof(VertexPacked) : sizeof(Vertex)));
+    ResourceRegistry::shared().trackGL(ResourceRegistry::BUFFER, EBO, "Mesh buffers", (long) indexSize * sizeof(GLuint));
     
-    // Vertex Positions
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (GLvoid*)0);
-    glEnableVertexAttribArray(0);   
-    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (GLvoid*)(3 * sizeof(float)));
-    glEnableVertexAttribArray(1);   
-    glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex), (GLvoid*)(6 * sizeof(float)));
-    glEnableVertexAttribArray(2); 
+    if (packed)
+    {
+        //! Normalized shorts decoded by the shader with posOffset, posScale, uvOffset and uvScale.
+        glVertexAttribPointer(0, 3, GL_UNSIGNED_SHORT, GL_TRUE, sizeof(VertexPacked), (GLvoid*)0);
+        glEnableVertexAttribArray(0);   
+        glVertexAttribPointer(1, 2, GL_SHORT, GL_TRUE, sizeof(VertexPacked), (GLvoid*)(4 * sizeof(unsigned short)));
+        glEnableVertexAttribArray(1);   
+        glVertexAttribPointer(2, 2, GL_UNSIGNED_SHORT, GL_TRUE, sizeof(VertexPacked), (GLvoid*)(6 * sizeof(unsigned short)));
+        glEnableVertexAttribArray(2); 
+    }
+    else
+    {
+        // Vertex Positions
+        glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (GLvoid*)0);
+        glEnableVertexAttribArray(0);   
+        glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (GLvoid*)(3 * sizeof(float)));
+        glEnableVertexAttribArray(1);   
+        glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex), (GLvoid*)(6 * sizeof(float)));
+        glEnableVertexAttribArray(2); 
+    }
     glBindBuffer(GL_ARRAY_BUFFER, 0);
     glBindVertexArray(0);
 }  
@@ -201,42 +284,70 @@ void MeshTex::setupInstancedMesh()
         float TexCoords[2];
     };
     */
-    verticesIndexed = new Vertex[indexSize];
-    for (int x = 0; x < indexSize; x++)
-    {
-        for (int y = 0; y < 3; y++)
-        {
-            verticesIndexed[x].Position[y] = vertices[indices[x]].Position[y];
-            verticesIndexed[x].Normal[y] = vertices[indices[x]].Normal[y];
-            if (y < 2)
-            {
-                verticesIndexed[x].TexCoords[y] = vertices[indices[x]].TexCoords[y];
-            }
-        }
-    }
     if (debug1)
     {
         dumpData();
     }
     glGenVertexArrays(1, &VAO);
     glGenBuffers(2, VBO);
+    glGenBuffers(1, &EBO);
     glBindVertexArray(VAO);
     glBindBuffer(GL_ARRAY_BUFFER, VBO[0]);
-    glBufferData(GL_ARRAY_BUFFER, indexSize * sizeof(Vertex), verticesIndexed, GL_STATIC_DRAW); 
+    if (packed)
+    {
+        glBufferData(GL_ARRAY_BUFFER, vertSize * sizeof(VertexPacked), packedVertices, GL_STATIC_DRAW);
+    }
+    else
+    {
+        glBufferData(GL_ARRAY_BUFFER, vertSize * sizeof(Vertex), vertices, GL_STATIC_DRAW); 
+    }
+    //! Drawn indexed so the vertex cache order from MeshOptimizer is used.
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, indexSize * sizeof(GLuint), indices, GL_STATIC_DRAW);
+    ResourceRegistry::shared().trackGL(ResourceRegistry::BUFFER, VBO[0], "Mesh buffers", (long) vertSize * ((packed) ? sizeof(VertexPacked) : sizeof(Vertex)));
+    ResourceRegistry::shared().trackGL(ResourceRegistry::BUFFER, EBO, "Mesh buffers", (long) indexSize * sizeof(GLuint));
    
-    // Vertex Positions
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (GLvoid*)0);
-    glEnableVertexAttribArray(0);   
-    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (GLvoid*)(3 * sizeof(float)));
-    glEnableVertexAttribArray(1);   
-    glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex), (GLvoid*)(6 * sizeof(float)));
-    glEnableVertexAttribArray(2); 
-    //! Uniform buffer to feed the uniform.
- 
+    if (packed)
+    {
+        //! Normalized shorts decoded by the shader with posOffset, posScale, uvOffset and uvScale.
+        glVertexAttribPointer(0, 3, GL_UNSIGNED_SHORT, GL_TRUE, sizeof(VertexPacked), (GLvoid*)0);
+        glEnableVertexAttribArray(0);   
+        glVertexAttribPointer(1, 2, GL_SHORT, GL_TRUE, sizeof(VertexPacked), (GLvoid*)(4 * sizeof(unsigned short)));
+        glEnableVertexAttribArray(1);   
+        glVertexAttribPointer(2, 2, GL_UNSIGNED_SHORT, GL_TRUE, sizeof(VertexPacked), (GLvoid*)(6 * sizeof(unsigned short)));
+        glEnableVertexAttribArray(2); 
+    }
+    else
+    {
+        // Vertex Positions
+        glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (GLvoid*)0);
+        glEnableVertexAttribArray(0);   
+        glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (GLvoid*)(3 * sizeof(float)));
+        glEnableVertexAttribArray(1);   
+        glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex), (GLvoid*)(6 * sizeof(float)));
+        glEnableVertexAttribArray(2); 
+    }
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    glBindVertexArray(0);
+    //! The instance block is made once at its largest, each draw fills the start of it.
+    glBindBuffer(GL_UNIFORM_BUFFER, VBO[1]);
+    glBufferData(GL_UNIFORM_BUFFER, std::max(quantity, 1) * sizeof(mat4), nullptr, GL_DYNAMIC_DRAW);
+    glBindBuffer(GL_UNIFORM_BUFFER, 0);
+    ResourceRegistry::shared().trackGL(ResourceRegistry::BUFFER, VBO[1], "Mesh instances", std::max(quantity, 1) * sizeof(mat4));
+    //! The position only stream for the depth pre-pass.
+    if (packed)
+    {
+        setupDepthMesh(packedVertices, vertSize, sizeof(VertexPacked), EBO);
+    }
+    else
+    {
+        setupDepthMesh(vertices, vertSize, sizeof(Vertex), EBO);
+    }
 }
 //! Draw the object.
 void MeshTex::Draw(mat4 view, mat4 projection, mat4 model, vector<PointLight>lights, vector<SpotLight>spotLights, vec3 viewPos, bool diffOnly, float gamma) 
 {
+    shader->Use();
     glBindVertexArray(VAO);
     bool difftrigger = true;
     bool spectrigger = true;
@@ -281,6 +392,7 @@ void MeshTex::Draw(mat4 view, mat4 projection, mat4 model, vector<PointLight>lig
     shader->setMat4("view", view);
     shader->setMat4("projection", projection);
     shader->setMat4("model", model);
+    setPacking();
     shader->setVec3("colordiff", vec3(1.0f, 1.0f, 1.0f));
     for (int x = 0; x < lights.size(); x++)
     {   
@@ -317,15 +429,16 @@ void MeshTex::Draw(mat4 view, mat4 projection, mat4 model, vector<PointLight>lig
         printVec3(viewPos);
     }
     // Draw mesh
-    glDrawElements(GL_TRIANGLES, indexSize, GL_UNSIGNED_INT, 0);
+    glDrawElements(GL_TRIANGLES, lodIndexCount(0), GL_UNSIGNED_INT, lodIndexOffset(0));
     glBindTexture(GL_TEXTURE_2D, 0);
     glBindVertexArray(0);
 }
 
 //! Draw the object.
-void MeshTex::DrawInstanced(mat4 view, mat4 projection, vector<mat4>model, vector<PointLight>lights, vector<SpotLight>spotLights, vec3 viewPos, bool diffOnly, float gamma) 
+void MeshTex::DrawInstanced(mat4 view, mat4 projection, vector<mat4>model, vector<PointLight>lights, vector<SpotLight>spotLights, vec3 viewPos, bool diffOnly, float gamma, int lod) 
 {
-    for (int x = 0; x < quantity; x++)
+    int count = std::min((int) model.size(), quantity);
+    for (int x = 0; x < count; x++)
     {
         instanceArray[x] = model[x];
     }
@@ -339,15 +452,16 @@ void MeshTex::DrawInstanced(mat4 view, mat4 projection, vector<mat4>model, vecto
     bool spectrigger = true;
     bool heighttrigger = true;
     opacity = 1.0f;
-    
-    shader->setFloat("gamma", gamma);
-    shader->setBool("diffOnly", diffOnly);
+    //! The variant program is made current before its uniforms are set.
+    shader->Use();
     //! Bind appropriate textures
     //! Here we allow for the three types of textures: Diffuse, specular and binormal or bumpmap.
-     cout  << "\n\n\tSampler IDs 1: diffOne " << diffOne 
-    << " diffTwo " << diffTwo << " specOne " << specOne
-    << " binormOne " << binormOne;
-    shader->Use();
+    if (debug1)
+    {
+        cout  << "\n\n\tSampler IDs 1: diffOne " << diffOne 
+        << " diffTwo " << diffTwo << " specOne " << specOne
+        << " binormOne " << binormOne;
+    }
     shader->setFloat("gamma", gamma);
     shader->setBool("diffOnly", diffOnly);
     if (debug1)
@@ -396,19 +510,23 @@ void MeshTex::DrawInstanced(mat4 view, mat4 projection, vector<mat4>model, vecto
     shader->setFloat("opacity", opacity);
     shader->setMat4("view", view);
     shader->setMat4("projection", projection);
-    cout  << "\n\n\tSampler IDs 2: diffOne " << diffOne 
-    << " diffTwo " << diffTwo << " specOne " << specOne
-    << " binormOne " << binormOne;
+    if (debug1)
+    {
+        cout  << "\n\n\tSampler IDs 2: diffOne " << diffOne 
+        << " diffTwo " << diffTwo << " specOne " << specOne
+        << " binormOne " << binormOne;
+    }
     dataIndex = glGetUniformBlockIndex(shader->Program, "itemData");   
     glUniformBlockBinding(shader->Program, dataIndex, 0);
     glBindBuffer(GL_UNIFORM_BUFFER, VBO[1]);
     //! Pass the image indices and cube distances.
-    glBufferData(GL_UNIFORM_BUFFER, quantity * sizeof(mat4), (void*)instanceArray,
-    GL_DYNAMIC_DRAW);
+    glBufferSubData(GL_UNIFORM_BUFFER, 0, count * sizeof(mat4), (void*)instanceArray);
     glBindBuffer(GL_UNIFORM_BUFFER, 0);    
     glBindBufferBase(GL_UNIFORM_BUFFER, 0, dataIndex);
+    //! The whole block is bound, a smaller level of detail only draws fewer instances.
     glBindBufferRange(GL_UNIFORM_BUFFER, 0, VBO[1], 0, quantity * sizeof(mat4));
     glBindBuffer(GL_UNIFORM_BUFFER, 0);
+    setPacking();
     shader->setVec3("colordiff", vec3(1.0f, 1.0f, 1.0f));
     for (int x = 0; x < lights.size(); x++)
     {   
@@ -441,18 +559,17 @@ void MeshTex::DrawInstanced(mat4 view, mat4 projection, vector<mat4>model, vecto
     {
         cout << "\n\tCamera Position in MeshTex:  ";
         printVec3(viewPos);
-        cout << "\n\tInstance quantity:  " << quantity << ".\n\n";
+        cout << "\n\tInstance quantity:  " << count << " at level of detail " << lod << ".\n\n";
         UniformPrinter uniforms(shader->Program);
     }
     // Draw mesh.
-    glDrawArraysInstanced(GL_TRIANGLES, 0, indexSize, quantity);
+    glDrawElementsInstanced(GL_TRIANGLES, lodIndexCount(lod), GL_UNSIGNED_INT, lodIndexOffset(lod), count);
     if (debug1)
     {
-        cout << "\n\n\t" << quantity << " instanced objects drawn.\n\n";
+        cout << "\n\n\t" << count << " instanced objects drawn.\n\n";
     }
     glBindTexture(GL_TEXTURE_2D, 0);
     glBindVertexArray(0);
-    glDeleteBuffers(1, &VBO[1]);
 }
 
 void MeshTex::printVec3(vec3 vecVal)
@@ -24,12 +24,16 @@ MeshVert::~MeshVert()
     if (instanced)
     {
         glDeleteBuffers(2, VBO);
+        ResourceRegistry::shared().releaseGL(ResourceRegistry::BUFFER, VBO[1]);
     }
     else
     {
         glDeleteBuffers(1, &VBO[0]);
     }
     glDeleteBuffers(1, &EBO);
+    ResourceRegistry::shared().releaseGL(ResourceRegistry::BUFFER, VBO[0]);
+    ResourceRegistry::shared().releaseGL(ResourceRegistry::BUFFER, EBO);
+    releaseArrays();
 }
 
 //!  Pass along data to be displayed from the Model class.
@@ -43,7 +47,22 @@ int MeshVert::setData(Vertex1 *vertices, GLuint *indices, vec3 color, int vertSi
     this->instanced = instanced;
     this->quantity = quantity;
     this->shader = shader;
+    //! The untextured program, with no texture fetches at all.
+    if (shader != nullptr)
+    {
+        this->shader = shader->variant(vector<string>(1, "NUM_DIFFUSE 0"));
+    }
+    setLods(indexSize);
     instanceArray = new mat4[quantity];
+    ResourceRegistry &registry = ResourceRegistry::shared();
+    registry.trackHeap(instanceArray, "Mesh instances", std::max(quantity, 0) * sizeof(mat4));
+    //! The arrays are the mesh's from here, unless they are in a mapped file.
+    if (!mapped)
+    {
+        registry.trackHeap(vertices, "Mesh arrays", (long) vertSize * sizeof(Vertex1));
+        registry.trackHeap(indices, "Mesh arrays", (long) indexSize * sizeof(GLuint));
+        registry.trackHeap(packedVertices, "Mesh arrays", (long) vertSize * sizeof(Vertex1Packed));
+    }
     setupMesh();
     diffOne = startIndex + dummyTex++ + startIndex; 
     diffTwo = startIndex + dummyTex++ + startIndex;
@@ -54,6 +73,42 @@ int MeshVert::setData(Vertex1 *vertices, GLuint *indices, vec3 color, int vertSi
     return (startIndex + 4);
 }
 
+void MeshVert::releaseArrays()
+{
+    if (!mapped)
+    {
+        ResourceRegistry &registry = ResourceRegistry::shared();
+        registry.releaseHeap(vertices);
+        registry.releaseHeap(indices);
+        registry.releaseHeap(packedVertices);
+        delete [] vertices;
+        delete [] indices;
+        delete [] packedVertices;
+    }
+    vertices = nullptr;
+    indices = nullptr;
+    packedVertices = nullptr;
+}
+
+void MeshVert::adoptArrays(MeshVert *source)
+{
+    releaseArrays();
+    vertices = source->vertices;
+    indices = source->indices;
+    packedVertices = source->packedVertices;
+    mapped = source->mapped;
+    source->vertices = nullptr;
+    source->indices = nullptr;
+    source->packedVertices = nullptr;
+    if (!mapped)
+    {
+        ResourceRegistry &registry = ResourceRegistry::shared();
+        registry.trackHeap(vertices, "Mesh arrays", (long) vertSize * sizeof(Vertex1));
+        registry.trackHeap(indices, "Mesh arrays", (long) indexSize * sizeof(GLuint));
+        registry.trackHeap(packedVertices, "Mesh arrays", (long) vertSize * sizeof(Vertex1Packed));
+    }
+}
+
 void MeshVert::dumpData()
 {
     cout << "\n\nVertices, Normals and TexCoords: \n\n";
@@ -90,16 +145,36 @@ void MeshVert::setupMesh()
     
     glBindVertexArray(VAO);
     glBindBuffer(GL_ARRAY_BUFFER, VBO[0]);
-    glBufferData(GL_ARRAY_BUFFER, vertSize * sizeof(Vertex1), vertices, GL_STATIC_DRAW);  
+    if (packed)
+    {
+        glBufferData(GL_ARRAY_BUFFER, vertSize * sizeof(Vertex1Packed), packedVertices, GL_STATIC_DRAW);  
+    }
+    else
+    {
+        glBufferData(GL_ARRAY_BUFFER, vertSize * sizeof(Vertex1), vertices, GL_STATIC_DRAW);  
+    }
     
     glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
     glBufferData(GL_ELEMENT_ARRAY_BUFFER, indexSize * sizeof(GLuint), indices, GL_STATIC_DRAW);
+    ResourceRegistry::shared().trackGL(ResourceRegistry::BUFFER, VBO[0], "Mesh buffers", (long) vertSize * ((packed) ? sizeof(Vertex1Packed) : sizeof(Vertex1)));
+    ResourceRegistry::shared().trackGL(ResourceRegistry::BUFFER, EBO, "Mesh buffers", (long) indexSize * sizeof(GLuint));
     
-    // Vertex Positions
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex1), (GLvoid*)0);
-    glEnableVertexAttribArray(0);   
-    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex1), (GLvoid*)(3 * sizeof(float)));
-    glEnableVertexAttribArray(1); 
+    if (packed)
+    {
+        //! Normalized shorts decoded by the shader with posOffset and posScale.
+        glVertexAttribPointer(0, 3, GL_UNSIGNED_SHORT, GL_TRUE, sizeof(Vertex1Packed), (GLvoid*)0);
+        glEnableVertexAttribArray(0);   
+        glVertexAttribPointer(1, 2, GL_SHORT, GL_TRUE, sizeof(Vertex1Packed), (GLvoid*)(4 * sizeof(unsigned short)));
+        glEnableVertexAttribArray(1); 
+    }
+    else
+    {
+        // Vertex Positions
+        glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex1), (GLvoid*)0);
+        glEnableVertexAttribArray(0);   
+        glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex1), (GLvoid*)(3 * sizeof(float)));
+        glEnableVertexAttribArray(1); 
+    }
     if (instanced)
     {
         //! Uniform buffer to feed the uniform.
@@ -108,10 +183,20 @@ void MeshVert::setupMesh()
         glBindBuffer(GL_UNIFORM_BUFFER, VBO[1]);
         glBufferData(GL_UNIFORM_BUFFER, quantity * sizeof(mat4), (void*)instanceArray,
         GL_DYNAMIC_DRAW);
+        ResourceRegistry::shared().trackGL(ResourceRegistry::BUFFER, VBO[1], "Mesh instances", quantity * sizeof(mat4));
         glBindBuffer(GL_UNIFORM_BUFFER, 0);
         glBindVertexArray(0);
         glBindBufferBase(GL_UNIFORM_BUFFER, 0, dataIndex);
         glBindBufferRange(GL_UNIFORM_BUFFER, 0, VBO[1], 0, quantity * sizeof(mat4));
+        //! The position only stream for the depth pre-pass.
+        if (packed)
+        {
+            setupDepthMesh(packedVertices, vertSize, sizeof(Vertex1Packed), EBO);
+        }
+        else
+        {
+            setupDepthMesh(vertices, vertSize, sizeof(Vertex1), EBO);
+        }
     }
     else
     {
@@ -123,7 +208,7 @@ void MeshVert::setupMesh()
 //! Draw object.
 void MeshVert::Draw(mat4 view, mat4 projection, mat4 model, vector<PointLight>lights, vector<SpotLight>spotLights, vec3 viewPos, bool diffOnly, float gamma) 
 {
-    
+    shader->Use();
     shader->setInt("numDiffuse", numDiff);
     shader->setBool("isDiffuse", isDiff);
     shader->setInt("diffuseOne", diffOne);
@@ -143,6 +228,7 @@ void MeshVert::Draw(mat4 view, mat4 projection, mat4 model, vector<PointLight>li
     shader->setInt("numDiffuse", 0);
     shader->setFloat("shininess", 1.0f);
     shader->setVec3("colordiff", colordiff);
+    setPacking();
     shader->setFloat("opacity", opacity);
     for (int x = 0; x < lights.size(); x++)
     {   
@@ -179,13 +265,14 @@ void MeshVert::Draw(mat4 view, mat4 projection, mat4 model, vector<PointLight>li
     }
     // Draw mesh
     glBindVertexArray(VAO);
-    glDrawElements(GL_TRIANGLES, indexSize, GL_UNSIGNED_INT, 0);
+    glDrawElements(GL_TRIANGLES, lodIndexCount(0), GL_UNSIGNED_INT, lodIndexOffset(0));
     glBindVertexArray(0);
 }
 
 //! Draw object instanced.
-void MeshVert::DrawInstanced( mat4 view, mat4 projection, vector<mat4>model, vector<PointLight>lights, vector<SpotLight>spotLights, vec3 viewPos, bool diffOnly, float gamma) 
+void MeshVert::DrawInstanced( mat4 view, mat4 projection, vector<mat4>model, vector<PointLight>lights, vector<SpotLight>spotLights, vec3 viewPos, bool diffOnly, float gamma, int lod) 
 {
+    shader->Use();
     shader->setInt("numDiffuse", numDiff);
     shader->setBool("isDiffuse", isDiff);
     shader->setInt("diffuseOne", diffOne);
@@ -194,7 +281,8 @@ void MeshVert::DrawInstanced( mat4 view, mat4 projection, vector<mat4>model, vec
     shader->setInt("specularOne", specOne);
     shader->setBool("isBinormal", isBinorm);
     shader->setInt("binormalOne", binormOne);
-    for (int x = 0; x < quantity; x++)
+    int count = std::min((int) model.size(), quantity);
+    for (int x = 0; x < count; x++)
     {
         instanceArray[x] = model[x];
     }
@@ -205,14 +293,20 @@ void MeshVert::DrawInstanced( mat4 view, mat4 projection, vector<mat4>model, vec
     shader->setMat4("projection", projection);
     glBindBuffer(GL_UNIFORM_BUFFER, VBO[1]);
     //! Pass the image indices and cube distances.
-    glBufferSubData(GL_UNIFORM_BUFFER, 0, quantity * sizeof(mat4), (void*) modelData); 
+    glBufferSubData(GL_UNIFORM_BUFFER, 0, count * sizeof(mat4), (void*) instanceArray); 
     glBindBuffer(GL_UNIFORM_BUFFER, 0);    
+    //! Each variant program has its own block binding, and the binding
+    //! point is shared with the other meshes.
+    glUniformBlockBinding(shader->Program, glGetUniformBlockIndex(shader->Program, "itemData"), 0);
+    //! The whole block is bound, a smaller level of detail only draws fewer instances.
+    glBindBufferRange(GL_UNIFORM_BUFFER, 0, VBO[1], 0, quantity * sizeof(mat4));
     shader->setVec3("viewPos", viewPos);
     //! No texture present.
     shader->setBool("isDiffuse", false);
     shader->setInt("numDiffuse", 0);
     shader->setFloat("shininess", 1.0f);
     shader->setVec3("colordiff", colordiff);
+    setPacking();
     shader->setFloat("opacity", opacity);
     for (int x = 0; x < lights.size(); x++)
     {   
@@ -241,11 +335,15 @@ void MeshVert::DrawInstanced( mat4 view, mat4 projection, vector<mat4>model, vec
         shader->setFloat("spotLights[" + ss.str() + "].linear", spotLights[x].linear);
         shader->setFloat("spotLights[" + ss.str() + "].quadratic", spotLights[x].quadratic);
     }
-    cout << "\n\n\tOpacity:  " << opacity << "  Color Vector:  " 
-    << colordiff.x << ", " << colordiff.y << ", " 
-    << colordiff.z << "\n\n";
+    if (debug1)
+    {
+        cout << "\n\n\tOpacity:  " << opacity << "  Color Vector:  " 
+        << colordiff.x << ", " << colordiff.y << ", " 
+        << colordiff.z << "\n\n";
+    }
     // Draw mesh
     glBindVertexArray(VAO);
-    glDrawElementsInstanced(GL_TRIANGLES, indexSize, GL_UNSIGNED_INT, indices, quantity);
+    //! The index buffer is bound to the VAO, so the offset is zero.
+    glDrawElementsInstanced(GL_TRIANGLES, lodIndexCount(lod), GL_UNSIGNED_INT, lodIndexOffset(lod), count);
     glBindVertexArray(0);
 }
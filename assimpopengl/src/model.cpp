@@ -6,68 +6,31 @@
  *   April 2020 San Diego, California USA
  * ********************************************************/
 #include "../include/model.h"
-//! Load each asset one-by-one.
-Model::Model(vector<ModelInfo> modelinfo, Shader *shader, int startIndex)
+//! Load the assets on the loader threads.
+Model::Model(vector<ModelInfo> modelinfo, Shader *shader, int startIndex, AssetLoader *loader)
 {
     cout << "\n\n\tCreating Model.\n\n";
     quantity = -1;
     this->startIndex = startIndex;
     imageMkr = new CreateImage();
     cout << "\n\n\tCreated Image Manager.\n\n";
-    import = new Assimp::Importer();
-    cout << "\n\n\tCreated Assimp Importer.\n\n";
-    for (unsigned int x = 0; x < modelinfo.size(); x++)
-    {
-        texcount = vertcount = 0;
-        cout << "\n\n\tLoading Model:  " << modelinfo[x].path << " Model Index:  " << x << ".\n\n";
-        if (!exists(modelinfo[x].path))
-        {
-            cout << "\n\n\tError no model at " << modelinfo[x].path << ".\n\n";
-            exit(-1);
-        }
-        
-        loadModel(modelinfo[x].path);
-        modelinfo[x].meshes = meshes;
-        meshes.clear();
-        textures.clear();
-        limit = meshes.size();
-        if (debug1)
-        {
-            cout << "\n\n\tProcessed " << texcount << " textured"
-            << " meshes and " << vertcount << " untextured "
-            << "meshes, for a total of " << limit << " meshes.\n\n";
-        }
-    }
+    sorter = new DepthSorter();
     this->modelinfo = modelinfo;
+    loadModels(loader);
 }
 
-Model::Model(vector<ModelInfo> modelinfo, int quantity, Shader *shader, int startIndex)
+Model::Model(vector<ModelInfo> modelinfo, int quantity, Shader *shader, int startIndex, AssetLoader *loader)
 {
     cout << "\n\n\tCreating Model.\n\n";
     this->quantity = quantity;
     this->shader = shader;
     this->startIndex = startIndex;
+    culler = new OcclusionCuller();
     imageMkr = new CreateImage();
     cout << "\n\n\tCreated Image Manager.\n\n";
-    import = new Assimp::Importer();
-    cout << "\n\n\tCreated Assimp.\n\n";
-    for (unsigned int x = 0; x < modelinfo.size(); x++)
-    {
-        texcount = vertcount = 0;
-        cout << "\n\n\tLoading Model:  " << modelinfo[x].path << " Model Index:  " << x << ".\n\n";
-        loadModel(modelinfo[x].path);
-        modelinfo[x].meshes = meshes;
-        limit = meshes.size();
-        meshes.clear();
-        textures.clear();
-        if (debug1)
-        {
-            cout << "\n\n\tProcessed " << texcount << " textured"
-            << " meshes and " << vertcount << " untextured "
-            << "meshes, for a total of " << limit << " meshes.\n\n";
-        }
-    }
+    sorter = new DepthSorter();
     this->modelinfo = modelinfo;
+    loadModels(loader);
 }
 
 Model::~Model()
@@ -80,7 +43,7 @@ Model::~Model()
         {
             for (int z = 0; z < modelinfo[x].meshes[y].textures.size(); z++)
             {
-               glDeleteTextures(1, &modelinfo[x].meshes[y].textures[z].id);
+               CreateImage::releaseTexture(modelinfo[x].meshes[y].textures[z].id);
                if (debug1)
                {
                    cout << "\n\tDestroying texture " << z << " in mesh " << y 
@@ -88,10 +51,23 @@ Model::~Model()
                }
                 
             }
+            //! The arrays of a cached mesh are still mapped, so it goes before the unmap below.
+            delete modelinfo[x].meshes[y].mesh;
+            modelinfo[x].meshes[y].mesh = nullptr;
         }
     }
     modelinfo.clear();
     delete imageMkr;
+    delete sorter;
+    delete culler;
+    for (unsigned int x = 0; x < impostors.size(); x++)
+    {
+        delete impostors[x];
+    }
+    for (unsigned int x = 0; x < mappings.size(); x++)
+    {
+        MeshCache::unmap(mappings[x].first, mappings[x].second);
+    }
     cout << "\n\n\tModel deleted.\n\n";
 }
 //! Draw each asset as a series of meshes.
@@ -100,7 +76,6 @@ void Model::Draw(mat4 view, mat4 projection, vector<ModelInfo>model, vector<Poin
     MeshInfo meshItem;
     string type;
     shader->Use();
-    sortIDs();
     for (int x = 0; x < modelinfo.size(); x++)
     {
         modelinfo[x].model = model[x].model;
@@ -113,8 +88,13 @@ void Model::Draw(mat4 view, mat4 projection, vector<ModelInfo>model, vector<Poin
         cout << "\n\tView Position:  ";
         printVec3(viewPos);
     }
-    for (int y = 0; y < modelinfo.size(); y++)
+    for (int z = 0; z < modelinfo.size(); z++)
     {
+        int y = sorter->order[z];
+        if (!resident[y])
+        {
+            continue;
+        }
         meshes.clear();
         meshes = modelinfo[y].meshes;
         if(debug1)
@@ -132,6 +112,7 @@ void Model::Draw(mat4 view, mat4 projection, vector<ModelInfo>model, vector<Poin
                 cout << "\n\tDrawing mesh " << x << " from model " << modelinfo[y].path 
                 << " of type " << type << " with gamma " << modelinfo[y].gamma;
             }
+            requestTextures(y, x, projectedSize(projection, modelinfo[y].model, viewPos, modelinfo[y].radius));
             meshItem.mesh->Draw(view, projection, modelinfo[y].model, lights, spotLights, viewPos, modelinfo[y].diffOnly, modelinfo[y].gamma);
             startIndex += modelinfo[y].meshes[x].textures.size();
             if (debug1)
@@ -163,24 +144,64 @@ void Model::DrawInstanced(mat4 view, mat4 projection, vector<ModelInfo>model, ve
     MeshInfo meshItem;
     mat4 tmpMat;
     string type;
-    int start = 0;
-    int end = quantity;
-    int count;
     if (debug1)
     {
         cout << "\n\tView Position:  ";
         printVec3(viewPos);
     }
+    if ((culler != nullptr) && (occlusionCulling))
+    {
+        cullOcclusion(view, projection, instanceData, viewPos);
+    }
+    else
+    {
+        //! The flags of the last culled frame would hide instances still.
+        visible.clear();
+    }
+    //! Each asset is bucketed once, the pre-pass and the shading share the buckets.
+    lodData.resize(modelinfo.size());
+    for (int y = 0; y < modelinfo.size(); y++)
+    {
+        if (resident[y])
+        {
+            bucketInstances(y, projection, instanceData, viewPos);
+        }
+    }
+    bool prepass = (depthPrepass) && (depthShader != nullptr);
+    if (prepass)
+    {
+        //! Lay down the nearest depth of every mesh with the color writes off.
+        glColorMask(GL_FALSE, GL_FALSE, GL_FALSE, GL_FALSE);
+        for (int y = 0; y < modelinfo.size(); y++)
+        {
+            if (!resident[y])
+            {
+                continue;
+            }
+            for (unsigned int x = 0; x < modelinfo[y].meshes.size(); x++)
+            {
+                for (int z = 0; z < MAX_LODS; z++)
+                {
+                    if (lodData[y].lods[z].size() > 0)
+                    {
+                        modelinfo[y].meshes[x].mesh->DrawDepth(depthShader, view, projection, lodData[y].lods[z], z);
+                    }
+                }
+            }
+        }
+        glColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
+        //! Then shade only the fragments that won.
+        glDepthFunc(GL_EQUAL);
+        glDepthMask(GL_FALSE);
+        shader->Use();
+    }
     for (int y = 0; y < modelinfo.size(); y++)
     {
-        modelData.clear();
-        count = 0;
-        for (int x = start; x < end; x++)
+        //! An asset still loading is left out until it is resident.
+        if (!resident[y])
         {
-            modelData.push_back(instanceData[x]);
+            continue;
         }
-        start += quantity;
-        end += quantity;
         meshes = modelinfo[y].meshes;
         int limit = meshes.size();
         for (int x = 0; x < limit; x++)
@@ -197,82 +218,613 @@ void Model::DrawInstanced(mat4 view, mat4 projection, vector<ModelInfo>model, ve
                 for (int x = 0; x < quantity; x++)
                 {
                     cout << "\n\tData for asteroid " << x << " in the Model class.";
-                    printMat4(modelData[x]);
+                    printMat4(instanceData[y * quantity + x]);
+                }
+            }
+            //! One instanced draw per level of detail in use.
+            for (int z = 0; z < MAX_LODS; z++)
+            {
+                if (lodData[y].lods[z].size() > 0)
+                {
+                    meshItem.mesh->DrawInstanced(view, projection, lodData[y].lods[z], lights, spotLights, viewPos, modelinfo[y].diffOnly, modelinfo[y].gamma, z);
                 }
             }
-            meshItem.mesh->DrawInstanced(view, projection, modelData, lights, spotLights, viewPos, modelinfo[y].diffOnly, modelinfo[y].gamma);
             startIndex += modelinfo[y].meshes[x].textures.size();
             if (debug1)
             {
                 cout << "\n\t:  " << startIndex;
             }
         }
+        if (lodData[y].lods[MAX_LODS].size() > 0)
+        {
+            //! The impostors are not in the pre-pass, they test and write depth as usual.
+            if (prepass)
+            {
+                glDepthFunc(GL_LESS);
+                glDepthMask(GL_TRUE);
+            }
+            impostors[y]->Draw(view, projection, lodData[y].lods[MAX_LODS], viewPos);
+            shader->Use();
+            if (prepass)
+            {
+                glDepthFunc(GL_EQUAL);
+                glDepthMask(GL_FALSE);
+            }
+        }
+    }
+    if (prepass)
+    {
+        glDepthFunc(GL_LESS);
+        glDepthMask(GL_TRUE);
     }
 }  
 
-//! Less than operator for stable_sort.
-bool Model::cmpdist(const ModelInfo &a, const ModelInfo &b)
-{   
-    return a.dist > b.dist;
+void Model::bucketInstances(int y, mat4 projection, vector<mat4> &instanceData, vec3 viewPos)
+{
+    int start = y * quantity, end = start + quantity;
+    bool streaming = TextureStreamer::shared().enabled;
+    float largest = 0.0f;
+    vector<mat4> *lods = lodData[y].lods;
+    for (int x = 0; x <= MAX_LODS; x++)
+    {
+        lods[x].clear();
+    }
+    for (int x = start; x < end; x++)
+    {
+        if ((visible.size() > x) && (!visible[x]))
+        {
+            continue;
+        }
+        lods[selectLod(projection, instanceData[x], viewPos, modelinfo[y].radius)].push_back(instanceData[x]);
+        if (streaming)
+        {
+            largest = std::max(largest, projectedSize(projection, instanceData[x], viewPos, modelinfo[y].radius));
+        }
+    }
+    //! The textures are streamed for the largest visible instance.
+    for (unsigned int x = 0; (streaming) && (x < modelinfo[y].meshes.size()); x++)
+    {
+        requestTextures(y, x, largest);
+    }
+    if (debug1)
+    {
+        cout << "\n\tInstances per level of detail for " << modelinfo[y].path << ":  ";
+        for (int x = 0; x <= MAX_LODS; x++)
+        {
+            cout << lods[x].size() << " ";
+        }
+    }
+    //! Nearest first, so the depth test rejects the hidden fragments before they are shaded.
+    if (frontToBack)
+    {
+        for (int x = 0; x <= MAX_LODS; x++)
+        {
+            sortFrontToBack(lods[x], viewPos);
+        }
+    }
+}
+
+void Model::setQuality(float lodBias, float impostorScale)
+{
+    this->lodBias = std::max(lodBias, 0.01f);
+    this->impostorScale = std::max(impostorScale, 0.0f);
 }
 
+void Model::setDepthPrepass(bool enabled, Shader *depthShader)
+{
+    if (depthShader != nullptr)
+    {
+        this->depthShader = depthShader;
+    }
+    depthPrepass = enabled;
+    cout << "\n\n\tDepth pre-pass " << ((enabled) ? "on" : "off") << ".\n\n";
+}
 
-void Model::sortDists(vec3 viewPos)
+void Model::buildLods(MeshData &item, float *vertices, int stride, AssetData &asset)
 {
-    for (int x = 0; x < modelinfo.size(); x++)
+    Mesh *meshPtr = item.mesh;
+    int vertSize = item.vertSize, indexSize = item.indexSize;
+    for (int x = 0; x < vertSize; x++)
+    {
+        asset.radius = std::max(asset.radius, length(vec3(vertices[x * stride], vertices[x * stride + 1], vertices[x * stride + 2])));
+    }
+    meshPtr->lodLevels = 1;
+    meshPtr->lodOffset[0] = 0;
+    meshPtr->lodCount[0] = indexSize;
+    if ((!generateLods) || (indexSize < 3))
+    {
+        addOccluder(item, vertices, stride, asset);
+        return;
+    }
+    //! Each level is simplified from the one before it and stored after it.
+    //! The simplifier copies the whole level before it reduces it, and a level
+    //! may keep nine tenths of the one before, so each may take up to indexSize.
+    GLuint *lodIndices = new GLuint[indexSize * MAX_LODS];
+    memcpy(lodIndices, item.indices, indexSize * sizeof(GLuint));
+    int total = indexSize;
+    for (int x = 1; x < MAX_LODS; x++)
+    {
+        GLuint *source = &lodIndices[meshPtr->lodOffset[x - 1]];
+        int sourceSize = meshPtr->lodCount[x - 1];
+        int target = (sourceSize / 6) * 3;
+        int result = asset.simplifier->simplify(vertices, vertSize, stride, source, sourceSize,
+            &lodIndices[total], target, lodError[x]);
+        //! Stop when the mesh will not simplify any further.
+        if ((result < 3) || (result > (sourceSize * 9) / 10))
+        {
+            break;
+        }
+        if (optimizeMeshes)
+        {
+            asset.optimizer->optimizeVertexCache(&lodIndices[total], result, vertSize);
+        }
+        meshPtr->lodOffset[x] = total;
+        meshPtr->lodCount[x] = result;
+        meshPtr->lodLevels = x + 1;
+        total += result;
+    }
+    delete [] item.indices;
+    item.indices = new GLuint[total];
+    memcpy(item.indices, lodIndices, total * sizeof(GLuint));
+    delete [] lodIndices;
+    item.indexSize = total;
+    addOccluder(item, vertices, stride, asset);
+    cout << "\n\n\tLevels of detail in triangles:  ";
+    for (int x = 0; x < meshPtr->lodLevels; x++)
+    {
+        cout << meshPtr->lodCount[x] / 3 << " ";
+    }
+    cout << "\n\n";
+}
+
+float Model::projectedSize(mat4 projection, mat4 instance, vec3 viewPos, float radius)
+{
+    //! The instance scale is the length of the first column of its matrix.
+    float scaled = radius * length(vec3(instance[0]));
+    float dist = std::max(distance(vec3(instance[3]), viewPos), 0.0001f);
+    return (scaled * projection[1][1]) / dist;
+}
+
+void Model::sortFrontToBack(vector<mat4> &instances, vec3 viewPos)
+{
+    if (instances.size() < 2)
+    {
+        return;
+    }
+    sortDepths.clear();
+    for (unsigned int x = 0; x < instances.size(); x++)
+    {
+        vec3 offset = vec3(instances[x][3]) - viewPos;
+        sortDepths.push_back(dot(offset, offset));
+    }
+    sorter->sort(sortDepths.data(), sortDepths.size());
+    sortScratch.clear();
+    for (unsigned int x = 0; x < instances.size(); x++)
+    {
+        sortScratch.push_back(instances[sorter->order[x]]);
+    }
+    instances.swap(sortScratch);
+}
+
+void Model::addOccluder(MeshData &item, float *vertices, int stride, AssetData &asset)
+{
+    Mesh *meshPtr = item.mesh;
+    int last = meshPtr->lodLevels - 1;
+    GLuint *source = &item.indices[meshPtr->lodOffset[last]];
+    unordered_map<GLuint, GLuint> remap;
+    for (GLuint x = 0; x < meshPtr->lodCount[last]; x++)
+    {
+        auto result = remap.emplace(source[x], (GLuint) asset.occluder.positions.size());
+        if (result.second)
+        {
+            float *position = &vertices[source[x] * stride];
+            asset.occluder.positions.push_back(vec3(position[0], position[1], position[2]));
+        }
+        asset.occluder.indices.push_back(result.first->second);
+    }
+}
+
+int Model::selectLod(mat4 projection, mat4 instance, vec3 viewPos, float radius)
+{
+    float size = projectedSize(projection, instance, viewPos, radius);
+    if ((impostors.size() > 0) && (size < impostorScreenSize * impostorScale))
+    {
+        return MAX_LODS;
+    }
+    size /= lodBias;
+    int lod = 0;
+    while ((lod < MAX_LODS - 1) && (size < lodScreenSize[lod]))
     {
-        vec3 location = modelinfo[x].location;
-        modelinfo[x].dist = distance(location, viewPos);
-        //!cout << "\n\n\tDistance: " << x << " : " << modelinfo[x].dist;
+        lod++;
     }
-    //! Sort uses the algorithm library.
-    sort(modelinfo.begin(), modelinfo.end(), cmpdist);
+    return lod;
 }
-//! Less than operator for stable_sort.
-bool Model::cmpid(const ModelInfo &a, const ModelInfo &b)
-{   
-    return a.idval < b.idval;
+
+void Model::cullOcclusion(mat4 view, mat4 projection, vector<mat4> &instanceData, vec3 viewPos)
+{
+    int total = std::min((int) instanceData.size(), quantity * (int) modelinfo.size());
+    vector<pair<float, int>> candidates;
+    visible.assign(instanceData.size(), true);
+    for (int x = 0; x < total; x++)
+    {
+        float size = projectedSize(projection, instanceData[x], viewPos, modelinfo[x / quantity].radius);
+        if (size > occluderScreenSize)
+        {
+            candidates.push_back(make_pair(size, x));
+        }
+    }
+    //! The largest on screen make the best occluders.
+    int limit = std::min((int) candidates.size(), maxOccluders);
+    partial_sort(candidates.begin(), candidates.begin() + limit, candidates.end(),
+        [](const pair<float, int> &a, const pair<float, int> &b) { return a.first > b.first; });
+    culler->beginFrame(view, projection);
+    for (int x = 0; x < limit; x++)
+    {
+        int item = candidates[x].second;
+        culler->addOccluder(occluders[item / quantity], instanceData[item]);
+    }
+    culler->endFrame();
+    for (int x = 0; x < total; x++)
+    {
+        float scaled = modelinfo[x / quantity].radius * length(vec3(instanceData[x][0]));
+        visible[x] = culler->isVisible(vec3(instanceData[x][3]), scaled);
+    }
+    if (debug1)
+    {
+        cout << "\n\tOcclusion:  " << limit << " occluders of " << culler->occluderTriangles
+        << " triangles culled " << culler->culled << " of " << culler->tested << " instances.";
+    }
 }
 
+void Model::buildImpostors(Shader *impostorShader, int tileSize, int views)
+{
+    for (unsigned int x = 0; x < modelinfo.size(); x++)
+    {
+        Impostor *impostor = new Impostor(impostorShader, tileSize, views);
+        //! The asset fills a tile, so its textures need that much detail.
+        for (unsigned int y = 0; y < modelinfo[x].meshes.size(); y++)
+        {
+            for (unsigned int z = 0; z < modelinfo[x].meshes[y].textures.size(); z++)
+            {
+                TextureStreamer::shared().prefetch(modelinfo[x].meshes[y].textures[z].id, tileSize);
+            }
+        }
+        impostor->capture(modelinfo[x].meshes, shader, modelinfo[x].radius, modelinfo[x].diffOnly, modelinfo[x].gamma);
+        impostors.push_back(impostor);
+    }
+    cout << "\n\n\tBuilt " << impostors.size() << " impostor atlases.\n\n";
+}
 
-void Model::sortIDs()
+void Model::sortDists(vec3 viewPos)
 {
-    //! Sort uses the algorithm library.
-    sort(modelinfo.begin(), modelinfo.end(), cmpid);
+    sortDepths.clear();
+    for (int x = 0; x < modelinfo.size(); x++)
+    {
+        modelinfo[x].dist = distance(modelinfo[x].location, viewPos);
+        sortDepths.push_back(modelinfo[x].dist);
+    }
+    //! Only the indices move, modelinfo stays in the order it was given.
+    sorter->sort(sortDepths.data(), sortDepths.size(), true);
 }
 
 
+//! Read each asset on the loader threads, with a loader of its own when none is given.
+void Model::loadModels(AssetLoader *loader)
+{
+    occluders.assign(modelinfo.size(), Occluder());
+    resident.assign(modelinfo.size(), false);
+    mappings.assign(modelinfo.size(), make_pair((void*) nullptr, (size_t) 0));
+    holdsArrays.assign(modelinfo.size(), false);
+    AssetLoader *local = nullptr;
+    if (loader == nullptr)
+    {
+        local = loader = new AssetLoader();
+    }
+    this->loader = loader;
+    for (unsigned int x = 0; x < modelinfo.size(); x++)
+    {
+        cout << "\n\n\tLoading Model:  " << modelinfo[x].path << " Model Index:  " << x << ".\n\n";
+        if (!AssetPack::shared().has(modelinfo[x].path))
+        {
+            cout << "\n\n\tError no model at " << modelinfo[x].path << ".\n\n";
+            exit(-1);
+        }
+        //! The worker makes everything but the buffers and textures,
+        //! which are made from it on the context thread.
+        string path = modelinfo[x].path;
+        bool quantize = modelinfo[x].quantize;
+        loader->submit(path, [this, x, path, quantize]() -> AssetLoader::Upload
+        {
+            AssetData *asset = importAsset(path, quantize);
+            return [this, x, asset]()
+            {
+                addModel(x, asset);
+            };
+        });
+    }
+    if (local != nullptr)
+    {
+        local->finish();
+        delete local;
+        this->loader = nullptr;
+    }
+}
+
 //! Read an asset file using the Assimp library.
-void Model::loadModel(string path)
+const aiScene *Model::readScene(Assimp::Importer *importer, string path)
 {
     cout << "\n\n\tLoading design:  " << path << "\n\n";
-    hasTex = false;
-    const aiScene* scene = import->ReadFile(path, aiProcess_Triangulate | aiProcess_GenNormals 
+    const aiScene* scene = importer->ReadFile(path, aiProcess_Triangulate | aiProcess_GenNormals 
     | aiProcess_GenUVCoords);
     cout << "\n\n\tLoaded scene.\n\n"; 
     if(!scene || scene->mFlags & AI_SCENE_FLAGS_INCOMPLETE || !scene->mRootNode) 
     {
-        cout << "Error upon Assimp library import: " << import->GetErrorString() << endl;
+        cout << "Error upon Assimp library import: " << importer->GetErrorString() << endl;
         exit(1);
     }
-    directory = path.substr(0, path.find_last_of('/'));
-    processNode(scene->mRootNode, scene);
+    return scene;
+}
+
+//! Make the CPU side of one asset, on the calling thread.
+AssetData *Model::importAsset(string path, bool quantize)
+{
+    //! Assimp::Importer and the import stages keep state between calls,
+    //! so each thread has its own and none are shared.
+    static thread_local Assimp::Importer importer;
+    static thread_local MeshOptimizer optimizer;
+    static thread_local VertexQuantizer quantizer;
+    static thread_local MeshSimplifier simplifier;
+    //! The importer reads the model and its materials out of the asset pack, the importer deletes it.
+    static thread_local bool packed = false;
+    if (!packed)
+    {
+        importer.SetIOHandler(new PackIOSystem());
+        packed = true;
+    }
+    //! A .glb asset is used as it was exported, without the import stages or the mesh cache.
+    if ((GlbLoader::enabled) && (GlbLoader::handles(path)))
+    {
+        AssetData *mapped = GlbLoader::read(path);
+        if (mapped != nullptr)
+        {
+            cout << "\n\n\tRead " << path << " as a glTF binary.\n\n";
+            mapped->quantize = quantize;
+            mapped->directory = path.substr(0, path.find_last_of('/'));
+            for (unsigned int x = 0; x < mapped->meshes.size(); x++)
+            {
+                MeshData &item = mapped->meshes[x];
+                float *vertices = (item.textured) ? (float*) item.vertices : (float*) item.vertices1;
+                int stride = ((item.textured) ? sizeof(Vertex) : sizeof(Vertex1)) / sizeof(float);
+                for (int y = 0; y < item.vertSize; y++)
+                {
+                    mapped->radius = std::max(mapped->radius, length(vec3(vertices[y * stride], vertices[y * stride + 1], vertices[y * stride + 2])));
+                }
+                addOccluder(item, vertices, stride, *mapped);
+            }
+            return mapped;
+        }
+    }
+    //! A warm start maps the meshes this import made last time.
+    string cacheFile;
+    if (MeshCache::enabled)
+    {
+        stringstream settings;
+        settings << quantize << " " << optimizeMeshes << " " << generateLods << " " << ObjParser::enabled << " " << ObjParser::revision;
+        for (int x = 0; x < MAX_LODS; x++)
+        {
+            settings << " " << lodError[x];
+        }
+        cacheFile = MeshCache::cachePath(path, settings.str());
+        AssetData *cached = MeshCache::read(cacheFile);
+        if (cached != nullptr)
+        {
+            cout << "\n\n\tRead " << path << " from the mesh cache.\n\n";
+            cached->quantize = quantize;
+            cached->directory = path.substr(0, path.find_last_of('/'));
+            return cached;
+        }
+    }
+    AssetData *asset = new AssetData();
+    asset->quantize = quantize;
+    asset->directory = path.substr(0, path.find_last_of('/'));
+    asset->optimizer = &optimizer;
+    asset->quantizer = &quantizer;
+    asset->simplifier = &simplifier;
+    optimizer.resetStats();
+    //! The OBJ files are read without Assimp, anything else or any it will not read with it.
+    if ((ObjParser::enabled) && (ObjParser::handles(path)) && (ObjParser::read(path, asset->meshes)))
+    {
+        cout << "\n\n\tParsed " << path << " into " << asset->meshes.size() << " meshes.\n\n";
+        for (unsigned int x = 0; x < asset->meshes.size(); x++)
+        {
+            finishMesh(asset->meshes[x], *asset);
+        }
+    }
+    else
+    {
+        const aiScene *scene = readScene(&importer, path);
+        processNode(scene->mRootNode, scene, *asset);
+        //! Nothing points into the scene any more.
+        importer.FreeScene();
+    }
+    optimizer.printStats(path);
+    if (MeshCache::enabled)
+    {
+        MeshCache::write(cacheFile, *asset);
+    }
+    return asset;
+}
+
+//! Make the buffers and textures of one asset, on the context thread.
+void Model::addModel(int x, AssetData *asset)
+{
+    texcount = vertcount = 0;
+    for (unsigned int y = 0; y < asset->meshes.size(); y++)
+    {
+        MeshData &item = asset->meshes[y];
+        int instances = (quantity > 0) ? quantity : -1;
+        textures.clear();
+        for (unsigned int z = 0; z < item.images.size(); z++)
+        {
+            Texture texture;
+            texture.id = TextureFromFile(item.images[z].first, item.images[z].second);
+            if (texture.id > 0)
+            {
+                texture.type = item.images[z].second;
+                texture.path = item.images[z].first;
+                textures.push_back(texture);
+            }
+        }
+        if (item.textured)
+        {
+            hasTex = true;
+            MeshTex *meshTexPtr = (MeshTex*) item.mesh;
+            startIndex = meshTexPtr->setData(item.vertices, item.indices, textures, item.vertSize, item.indexSize, 
+            quantity > 0, instances, shader, startIndex);
+            meshTexPtr->opacity = item.opacity;
+            meshTexPtr->setType("Textured");
+            texcount++;
+        }
+        else
+        {
+            MeshVert *meshVertPtr = (MeshVert*) item.mesh;
+            startIndex = meshVertPtr->setData(item.vertices1, item.indices, item.color, item.vertSize, item.indexSize, 
+            quantity > 0, instances, shader, startIndex);
+            meshVertPtr->opacity = item.opacity;
+            meshVertPtr->setType("Untextured");
+            vertcount++;
+        }
+        MeshInfo info;
+        info.mesh = item.mesh;
+        info.textures = textures;
+        meshes.push_back(info);
+        if (debug1)
+        {
+            cout << "\n\n\tProcessed one " << item.mesh->type << " mesh.\n\n";
+            for (int z = 0; z < textures.size(); z++)
+            {
+                cout << "\n\tTexture " << z << " of type " << textures[z].type 
+                << " at location " << textures[z].path;
+            }
+        }
+    }
+    modelinfo[x].radius = asset->radius;
+    occluders[x] = asset->occluder;
+    modelinfo[x].meshes = meshes;
+    limit = meshes.size();
+    meshes.clear();
+    textures.clear();
+    resident[x] = true;
+    mappings[x] = make_pair(asset->mapped, asset->mappedSize);
+    delete asset;
+    //! The buffers have the arrays now, only the GPU copy stays unless it is asked for.
+    holdsArrays[x] = true;
+    if (!modelinfo[x].keepArrays)
+    {
+        releaseArrays(x);
+    }
     if (debug1)
     {
-        for (int y = 0; y < meshes.size(); y++)
+        cout << "\n\n\tProcessed " << texcount << " textured"
+        << " meshes and " << vertcount << " untextured "
+        << "meshes, for a total of " << limit << " meshes.\n\n";
+    }
+}
+
+void Model::releaseArrays(int x)
+{
+    if ((x < 0) || (x >= (int) modelinfo.size()) || (!holdsArrays[x]))
+    {
+        return;
+    }
+    for (unsigned int y = 0; y < modelinfo[x].meshes.size(); y++)
+    {
+        Mesh *mesh = modelinfo[x].meshes[y].mesh;
+        if (mesh->type == "Textured")
         {
-            cout <<  "\n\n\tTextures for mesh " << y << "\n";
-            for (int x = 0; x < textures.size(); x++)
+            ((MeshTex*) mesh)->releaseArrays();
+        }
+        else
+        {
+            ((MeshVert*) mesh)->releaseArrays();
+        }
+    }
+    //! Nothing points into the file once the arrays are gone.
+    MeshCache::unmap(mappings[x].first, mappings[x].second);
+    mappings[x] = make_pair((void*) nullptr, (size_t) 0);
+    holdsArrays[x] = false;
+}
+
+bool Model::restoreArrays(int x)
+{
+    if ((x < 0) || (x >= (int) modelinfo.size()) || (!resident[x]))
+    {
+        return false;
+    }
+    if (holdsArrays[x])
+    {
+        return true;
+    }
+    AssetData *asset = importAsset(modelinfo[x].path, modelinfo[x].quantize);
+    bool same = (asset->meshes.size() == modelinfo[x].meshes.size());
+    for (unsigned int y = 0; y < asset->meshes.size(); y++)
+    {
+        //! The read meshes hold their arrays, to give them on or free them.
+        MeshData &item = asset->meshes[y];
+        Mesh *mesh = (same) ? modelinfo[x].meshes[y].mesh : nullptr;
+        if (item.textured)
+        {
+            MeshTex *source = (MeshTex*) item.mesh;
+            source->vertices = item.vertices;
+            source->indices = item.indices;
+            same = (same) && (mesh->type == "Textured") && (((MeshTex*) mesh)->vertSize == item.vertSize)
+            && (((MeshTex*) mesh)->indexSize == item.indexSize);
+        }
+        else
+        {
+            MeshVert *source = (MeshVert*) item.mesh;
+            source->vertices = item.vertices1;
+            source->indices = item.indices;
+            same = (same) && (mesh->type != "Textured") && (((MeshVert*) mesh)->vertSize == item.vertSize)
+            && (((MeshVert*) mesh)->indexSize == item.indexSize);
+        }
+    }
+    if (same)
+    {
+        for (unsigned int y = 0; y < asset->meshes.size(); y++)
+        {
+            Mesh *mesh = modelinfo[x].meshes[y].mesh;
+            if (asset->meshes[y].textured)
+            {
+                ((MeshTex*) mesh)->adoptArrays((MeshTex*) asset->meshes[y].mesh);
+            }
+            else
             {
-                cout << "\n\tTexture " << x << " of type " << textures[x].type 
-                << " at location " << textures[x].path;
+                ((MeshVert*) mesh)->adoptArrays((MeshVert*) asset->meshes[y].mesh);
             }
         }
+        mappings[x] = make_pair(asset->mapped, asset->mappedSize);
+        holdsArrays[x] = true;
+    }
+    else
+    {
+        cout << "\n\n\tError:  " << modelinfo[x].path << " no longer reads as it was loaded.\n\n";
+    }
+    //! The read meshes have no buffers, and free any arrays not taken.
+    for (unsigned int y = 0; y < asset->meshes.size(); y++)
+    {
+        delete asset->meshes[y].mesh;
+    }
+    if (!same)
+    {
+        MeshCache::unmap(asset->mapped, asset->mappedSize);
     }
+    delete asset;
+    return same;
 }
 
 //! Process a node and all subnodes.
-void Model::processNode(aiNode* node, const aiScene* scene)
+void Model::processNode(aiNode* node, const aiScene* scene, AssetData &asset)
 {
     cout << "\n\n\tIn processNode.\n\n";
     // Process all the node's meshes (if any)
@@ -282,37 +834,31 @@ void Model::processNode(aiNode* node, const aiScene* scene)
     }
     for(GLuint i = 0; i < node->mNumMeshes; i++)
     {
-        mesh = scene->mMeshes[node->mMeshes[i]]; 
-        meshes.push_back(processMesh(mesh, scene)); 
+        aiMesh *mesh = scene->mMeshes[node->mMeshes[i]]; 
+        asset.meshes.push_back(processMesh(mesh, scene, asset)); 
     }
     // Then do the same for each of its children
     cout << "\n\n\tProcessing " << node->mNumChildren << " child nodes.\n\n";
     for(GLuint i = 0; i < node->mNumChildren; i++)
     {
-        processNode(node->mChildren[i], scene);
+        processNode(node->mChildren[i], scene, asset);
     }
 } 
 
 //! Process a single mesh.
-MeshInfo Model::processMesh(aiMesh* mesh, const aiScene* scene)
+MeshData Model::processMesh(aiMesh* mesh, const aiScene* scene, AssetData &asset)
 {
-    MeshInfo item;
-    vec3 colordiff;
+    MeshData item;
     aiVector3D *texptr = nullptr;
-    aiVector3D texval;
-    indexSize = vertSize = 0;
     // Data to fill
-    Mesh *meshPtr;
     int vertSize;
-    textures.clear();
-    if (mesh->HasTextureCoords(0))
+    item.textured = mesh->HasTextureCoords(0);
+    if (item.textured)
     {
-        hasTex = true;
         cout << "\n\n\tHas texture coordinates.\n\n";
     }
     else
     {
-        hasTex = false;
         cout << "\n\n\tDoes not have texture coordinates.\n\n";
     }
     bool colors = mesh->HasVertexColors(0);
@@ -327,259 +873,201 @@ MeshInfo Model::processMesh(aiMesh* mesh, const aiScene* scene)
     try
     {
         vertSize = mesh->mNumVertices;
-        if (vertSize >= 3)
+        if (vertSize < 3)
+        {
+            cout << "\n\nFatal Error:  Mesh with no vertices.\n";
+            exit(1);
+        }
+        //! Both vertex layouts start with the position and the normal.
+        float *vertices;
+        int stride;
+        if (item.textured)
         {
             //! Textured mesh.
-            if (hasTex)
+            item.vertices = new Vertex[vertSize];
+            vertices = (float*) item.vertices;
+            stride = sizeof(Vertex) / sizeof(float);
+        }
+        else
+        {
+            //! Untextured mesh.
+            item.vertices1 = new Vertex1[vertSize];
+            vertices = (float*) item.vertices1;
+            stride = sizeof(Vertex1) / sizeof(float);
+        }
+        // Walk through each of the mesh's vertices
+        for(GLuint i = 0; i < mesh->mNumVertices; i++)
+        {
+            float *vertex = &vertices[i * stride];
+            // Positions
+            vertex[0] = mesh->mVertices[i].x;
+            vertex[1] = mesh->mVertices[i].y;
+            vertex[2] = mesh->mVertices[i].z;
+            vertex[3] = mesh->mNormals[i].x;
+            vertex[4] = mesh->mNormals[i].y;
+            vertex[5] = mesh->mNormals[i].z;
+            if (item.textured)
             {
-                vertices = new Vertex[vertSize];
-                // Walk through each of the mesh's vertices
-                for(GLuint i = 0; i < mesh->mNumVertices; i++)
-                {
-                    // Positions
-                    vertices[i].Position[0] = mesh->mVertices[i].x;
-                    vertices[i].Position[1] = mesh->mVertices[i].y;
-                    vertices[i].Position[2] = mesh->mVertices[i].z;
-                    vertices[i].Normal[0] = mesh->mNormals[i].x;
-                    vertices[i].Normal[1] = mesh->mNormals[i].y;
-                    vertices[i].Normal[2] = mesh->mNormals[i].z;
-                    texptr = nullptr;
-                    texptr = &mesh->mTextureCoords[0][i];
-                    if (!texptr)
-                    {
-                        cout << "\n\n\tNo texture coordinates.\n\n";
-                        exit(1);
-                    }
-                    else
-                    {
-                        vertices[i].TexCoords[0] = texptr->x;
-                        vertices[i].TexCoords[1] = texptr->y;
-                    }
-                 }
-                if (mesh->HasFaces())
-                {
-                    vector<GLuint>indices1;
-                    for(GLuint i = 0; i < mesh->mNumFaces; i++)
-                    {
-                        aiFace face = mesh->mFaces[i];
-                        // Retrieve all indices of the face and store them in the indices vector
-                        for(GLuint j = 0; j < face.mNumIndices; j++)
-                        {
-                            indices1.push_back(face.mIndices[j]);
-                        }
-                    }
-                    indexSize = indices1.size();
-                    indices = new GLuint[indexSize];
-                    for (int x = 0; x < indexSize; x++)
-                    {
-                        indices[x]  = indices1[x];
-                   }
-                }
-                if (mesh->mMaterialIndex >= 0)
-                {
-                    aiMaterial* material = scene->mMaterials[mesh->mMaterialIndex];
-                    if (debug1)
-                    {
-                        aiMaterialProperty **proplist = material->mProperties;
-                        cout << "\n\n\tProperty list for material "  << mesh->mMaterialIndex << "\n";
-                        for (int x = 0; x < material->mNumProperties; x++)
-                        {
-                            cout << "\n\t" << proplist[x]->mData << " : " << proplist[x]->mKey.C_Str();
-                        }
-                    }
-                    material->Get(AI_MATKEY_OPACITY, opacity);
-                    /** Here we check for all the texture types even though we are only using three:
-                     *  diffuse - color, specular - highlights, height - bumps.
-                     */
-                    vector<Texture> noneMaps = loadMaterialTextures(material, aiTextureType_NONE, "none");
-                    textures.insert(textures.end(), noneMaps.begin(), noneMaps.end());
-                    vector<Texture> diffuseMaps = loadMaterialTextures(material, aiTextureType_DIFFUSE, "diffuse");
-                    textures.insert(textures.end(), diffuseMaps.begin(), diffuseMaps.end());
-                    vector<Texture> specularMaps = loadMaterialTextures(material, aiTextureType_SPECULAR, "specular");
-                    textures.insert(textures.end(), specularMaps.begin(), specularMaps.end());
-                    vector<Texture> ambientMaps = loadMaterialTextures(material, aiTextureType_AMBIENT, "ambient");
-                    textures.insert(textures.end(), ambientMaps.begin(), ambientMaps.end());
-                    vector<Texture> emissiveMaps = loadMaterialTextures(material, aiTextureType_EMISSIVE, "emissive");
-                    textures.insert(textures.end(), emissiveMaps.begin(), emissiveMaps.end());
-                    vector<Texture> heightMaps = loadMaterialTextures(material, aiTextureType_HEIGHT, "height");
-                    textures.insert(textures.end(), heightMaps.begin(), heightMaps.end());
-                    vector<Texture> normalMaps = loadMaterialTextures(material, aiTextureType_NORMALS, "normal");
-                    textures.insert(textures.end(), normalMaps.begin(), normalMaps.end());
-                    vector<Texture> shininessMaps = loadMaterialTextures(material, aiTextureType_SHININESS, "shininess");
-                    textures.insert(textures.end(), shininessMaps.begin(), shininessMaps.end());
-                    vector<Texture> opacityMaps = loadMaterialTextures(material, aiTextureType_OPACITY, "opacity");
-                    textures.insert(textures.end(), opacityMaps.begin(), opacityMaps.end());
-                    vector<Texture> displacementMaps = loadMaterialTextures(material, aiTextureType_DISPLACEMENT, "displacement");
-                    textures.insert(textures.end(), displacementMaps.begin(), displacementMaps.end());
-                    vector<Texture> lightMaps = loadMaterialTextures(material, aiTextureType_LIGHTMAP, "lightmap");
-                    textures.insert(textures.end(), lightMaps.begin(), lightMaps.end());
-                    vector<Texture> unknownMaps = loadMaterialTextures(material, aiTextureType_UNKNOWN, "unknown");
-                    textures.insert(textures.end(), unknownMaps.begin(), unknownMaps.end());
-                }
-                MeshTex *meshTexPtr = new MeshTex();
-                if (quantity > 0)
+                texptr = &mesh->mTextureCoords[0][i];
+                item.vertices[i].TexCoords[0] = texptr->x;
+                item.vertices[i].TexCoords[1] = texptr->y;
+            }
+        }
+        if (mesh->HasFaces())
+        {
+            vector<GLuint>indices1;
+            for(GLuint i = 0; i < mesh->mNumFaces; i++)
+            {
+                aiFace face = mesh->mFaces[i];
+                // Retrieve all indices of the face and store them in the indices vector
+                for(GLuint j = 0; j < face.mNumIndices; j++)
                 {
-                    startIndex = meshTexPtr->setData(vertices, indices, textures, vertSize, indexSize, true, quantity, shader, startIndex);
+                    indices1.push_back(face.mIndices[j]);
                 }
-                else
+            }
+            item.indexSize = indices1.size();
+            item.indices = new GLuint[item.indexSize];
+            memcpy(item.indices, indices1.data(), item.indexSize * sizeof(GLuint));
+        }
+        item.vertSize = vertSize;
+        float opacity = 1.0f;
+        if (mesh->mMaterialIndex >= 0)
+        {
+            aiMaterial* material = scene->mMaterials[mesh->mMaterialIndex];
+            if (debug1)
+            {
+                aiMaterialProperty **proplist = material->mProperties;
+                cout << "\n\n\tProperty list for material "  << mesh->mMaterialIndex << "\n";
+                for (int x = 0; x < material->mNumProperties; x++)
                 {
-                    startIndex = meshTexPtr->setData(vertices, indices, textures, vertSize, indexSize, false, -1, shader, startIndex);
+                    cout << "\n\t" << proplist[x]->mData << " : " << proplist[x]->mKey.C_Str();
                 }
-                opacity = glm::clamp(opacity, 0.0f, 1.0f);
-                meshTexPtr->opacity = opacity;
-                meshTexPtr->setType("Textured");
-                meshPtr = meshTexPtr;
-                texcount++;
+            }
+            material->Get(AI_MATKEY_OPACITY, opacity);
+            if (item.textured)
+            {
+                /** Here we check for all the texture types even though we are only using three:
+                 *  diffuse - color, specular - highlights, height - bumps.
+                 *  The images are only named here, they are loaded on the context thread.
+                 */
+                loadMaterialTextures(material, aiTextureType_NONE, "none", item, asset.directory);
+                loadMaterialTextures(material, aiTextureType_DIFFUSE, "diffuse", item, asset.directory);
+                loadMaterialTextures(material, aiTextureType_SPECULAR, "specular", item, asset.directory);
+                loadMaterialTextures(material, aiTextureType_AMBIENT, "ambient", item, asset.directory);
+                loadMaterialTextures(material, aiTextureType_EMISSIVE, "emissive", item, asset.directory);
+                loadMaterialTextures(material, aiTextureType_HEIGHT, "height", item, asset.directory);
+                loadMaterialTextures(material, aiTextureType_NORMALS, "normal", item, asset.directory);
+                loadMaterialTextures(material, aiTextureType_SHININESS, "shininess", item, asset.directory);
+                loadMaterialTextures(material, aiTextureType_OPACITY, "opacity", item, asset.directory);
+                loadMaterialTextures(material, aiTextureType_DISPLACEMENT, "displacement", item, asset.directory);
+                loadMaterialTextures(material, aiTextureType_LIGHTMAP, "lightmap", item, asset.directory);
+                loadMaterialTextures(material, aiTextureType_UNKNOWN, "unknown", item, asset.directory);
             }
             else
             {
-                //! Untextured mesh.
-                vertices1 = new Vertex1[vertSize];
-                
-                // Walk through each of the mesh's vertices.
-                for(GLuint i = 0; i < mesh->mNumVertices; i++)
-                {
-                    // Positions
-                    vertices1[i].Position[0] = mesh->mVertices[i].x;
-                    vertices1[i].Position[1] = mesh->mVertices[i].y;
-                    vertices1[i].Position[2] = mesh->mVertices[i].z;
-                    vertices1[i].Normal[0] = mesh->mNormals[i].x;
-                    vertices1[i].Normal[1] = mesh->mNormals[i].y;
-                    vertices1[i].Normal[2] = mesh->mNormals[i].z;
-                }
-                if (mesh->HasFaces())
-                {
-                    vector<GLuint>indices1;
-                    for(GLuint i = 0; i < mesh->mNumFaces; i++)
-                    {
-                        aiFace face = mesh->mFaces[i];
-                        // Retrieve all indices of the face and store them in the indices vector
-                        for(GLuint j = 0; j < face.mNumIndices; j++)
-                        {
-                            indices1.push_back(face.mIndices[j]);
-                        }
-                    }
-                    indexSize = indices1.size();
-                    indices = new GLuint[indexSize];
-                    for (int x = 0; x < indexSize; x++)
-                    {
-                        indices[x]  = indices1[x];
-                    }
-                }
-                if (mesh->mMaterialIndex >= 0)
-                {
-                    aiMaterial* material = scene->mMaterials[mesh->mMaterialIndex];
-                    if (debug1)
-                    {
-                        aiMaterialProperty **proplist = material->mProperties;
-                        cout << "\n\n\tProperty list:  ";
-                        for (int x = 0; x < material->mNumProperties; x++)
-                        {
-                            cout << "\n\t" << proplist[x]->mData << " : " << proplist[x]->mKey.C_Str();
-                        }
-                    }
-                    aiColor4D color (0.0f, 0.0f, 0.0f, 0.0f);
-                    material->Get(AI_MATKEY_COLOR_DIFFUSE,color);
-                    cout << "\n\n\tMaterial color:  "
-                    << color[0] << ", " << color[1] << ", "
-                    << color[3] << ", " << color[3];
-                    material->Get(AI_MATKEY_OPACITY, opacity);
-                    for (int x = 0; x < 3; x++)\
-                    {
-                        colordiff[x] = color[x];
-                    }
-                }
-                MeshVert *meshVertPtr = new MeshVert();
-                if (quantity > 0)
-                {
-                    startIndex = meshVertPtr->setData(vertices1, indices, colordiff, vertSize, indexSize, true, quantity, shader, startIndex);
-                }
-                else
-                {
-                    startIndex = meshVertPtr->setData(vertices1, indices, colordiff, vertSize, indexSize, false, -1, shader, startIndex);
-                }
-                if (opacity  > 1.0f)
+                aiColor4D color (0.0f, 0.0f, 0.0f, 0.0f);
+                material->Get(AI_MATKEY_COLOR_DIFFUSE,color);
+                cout << "\n\n\tMaterial color:  "
+                << color[0] << ", " << color[1] << ", "
+                << color[3] << ", " << color[3];
+                for (int x = 0; x < 3; x++)
                 {
-                    opacity = 0.7f;
+                    item.color[x] = color[x];
                 }
-                meshVertPtr->opacity = opacity;
-                vertcount++;
-                meshVertPtr->setType("Untextured");
-                meshPtr = meshVertPtr;
             }
         }
-        else
-        {
-            cout << "\n\nFatal Error:  Mesh with no vertices.\n";
-            exit(1);
-        }
-        item.mesh = meshPtr;
-        item.textures = textures;
+        item.opacity = opacity;
+        finishMesh(item, asset);
     }
     catch(exception exc)
     {
         cout << "\n\n\tFatal Error Loading Mesh:  " << exc.what() << "\n\n";
         exit(1);
     }
-    // Return a mesh object created from the extracted mesh data
-    if (debug1)
+    return item;
+}
+
+//! The stages after extraction, the same for every reader.
+void Model::finishMesh(MeshData &item, AssetData &asset)
+{
+    //! Both vertex layouts start with the position and the normal.
+    float *vertices = (item.textured) ? (float*) item.vertices : (float*) item.vertices1;
+    int stride = ((item.textured) ? sizeof(Vertex) : sizeof(Vertex1)) / sizeof(float);
+    if ((optimizeMeshes) && (item.indexSize > 0))
     {
-        cout << "\n\n\tProcessed one " << meshPtr->type << " mesh.\n\n";
+        item.vertSize = asset.optimizer->optimize(vertices, item.vertSize, stride, item.indices, item.indexSize);
+    }
+    int vertSize = item.vertSize;
+    if (item.textured)
+    {
+        MeshTex *meshTexPtr = new MeshTex();
+        item.mesh = meshTexPtr;
+        buildLods(item, vertices, stride, asset);
+        if ((asset.quantize) && (asset.quantizer->canPack(item.vertices, vertSize)))
+        {
+            meshTexPtr->packedVertices = asset.quantizer->pack(item.vertices, vertSize, meshTexPtr);
+            cout << "\n\n\tPacked " << vertSize << " vertices from " << sizeof(Vertex)
+            << " to " << sizeof(VertexPacked) << " bytes per vertex.\n\n";
+        }
+        item.opacity = glm::clamp(item.opacity, 0.0f, 1.0f);
+    }
+    else
+    {
+        MeshVert *meshVertPtr = new MeshVert();
+        item.mesh = meshVertPtr;
+        buildLods(item, vertices, stride, asset);
+        if ((asset.quantize) && (asset.quantizer->canPack(item.vertices1, vertSize)))
+        {
+            meshVertPtr->packedVertices = asset.quantizer->pack(item.vertices1, vertSize, meshVertPtr);
+            cout << "\n\n\tPacked " << vertSize << " vertices from " << sizeof(Vertex1)
+            << " to " << sizeof(Vertex1Packed) << " bytes per vertex.\n\n";
+        }
+        item.opacity = (item.opacity > 1.0f) ? 0.7f : item.opacity;
     }
-    return item;
 }
 
-//! Check for existing texture and load as needed.
-vector<Texture> Model::loadMaterialTextures(aiMaterial* mat, aiTextureType type, string typeName)
+//! Name the images of one texture type, they are loaded by addModel().
+void Model::loadMaterialTextures(aiMaterial* mat, aiTextureType type, string typeName, MeshData &item, string directory)
 {
-    vector<Texture> textures;
     for(GLuint i = 0; i < mat->GetTextureCount(type); i++)
     {
         aiString str;
         mat->GetTexture(type, i, &str);
-        filename = string(str.C_Str());
-        filename = directory + "/" + filename;
+        string filename = directory + "/" + string(str.C_Str());
         if (debug1)
         {
             cout << "\n\n\tTexture directory:  " << directory << " filename:  " << filename 
             << "  type:  " << typeName << "  count:  " << (i + 1) << "\n\n";
         }
-        GLboolean skip = false;
-        Texture texture;
-        texture.id = TextureFromFile(filename);
-        if (texture.id > 0)
-        {
-            texture.type = typeName;
-            texture.path = filename;
-            textures.push_back(texture);
-        }
+        item.images.push_back(make_pair(filename, typeName));
     }
-    return textures;
 }  
 
 //! Use the CreateImage class to turn an image into a texture.
-GLint Model::TextureFromFile(string filename)
+GLint Model::TextureFromFile(string filename, string typeName)
 {
-    //Generate texture ID and load texture data 
-    GLuint textureID;
-    glGenTextures(1, &textureID);
-    GLsizei width, height;
     if (debug1)
     {
         cout << "\n\n\tProcessing:  " << filename << "\n\n";
     }
-    if(imageMkr->setImage(filename))
+    //! Images shared by several meshes or models come from the texture cache.
+    static const unsigned char grey[4] = {128, 128, 128, 255};
+    static const unsigned char flat[4] = {128, 128, 255, 255};
+    bool bump = (typeName == "normal") || (typeName == "height");
+    GLuint textureID = imageMkr->loadTexture(filename, loader, (bump) ? flat : grey, true);
+    if ((debug1) && (textureID > 0))
     {
-        textureID = imageMkr->textureObject();
-        if (debug1)
-        {
-            cout << "\n\n\tReturning texture buffer:  " << textureID << "\n\n";
-        }
-        return textureID;
+        cout << "\n\n\tReturning texture buffer:  " << textureID << "\n\n";
     }
-    else
+    return textureID;
+}
+
+void Model::requestTextures(int y, int x, float size)
+{
+    vector<Texture> &meshTextures = modelinfo[y].meshes[x].textures;
+    for (unsigned int z = 0; z < meshTextures.size(); z++)
     {
-        return 0;
+        TextureStreamer::shared().request(meshTextures[z].id, size);
     }
 }
 
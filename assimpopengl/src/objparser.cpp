@@ -0,0 +1,734 @@
+/**********************************************************
+ *   ObjParser:  A class to read Wavefront OBJ and MTL files
+ *   straight into the vertex and index arrays of the meshes.
+ *   Created by: Edward Charles Eberle <eberdeed@eberdeed.net>
+ *   October 2026 San Diego, California USA
+ * ********************************************************/
+
+#include "../include/objparser.h"
+#include "../include/info.h"
+#include "../include/assetpack.h"
+#include <unordered_map>
+#include <algorithm>
+#include <cmath>
+#include <cctype>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+bool ObjParser::enabled = true;
+bool ObjParser::debug1 = false;
+
+//! The texture types in the order Model::processMesh() asks Assimp for them.
+static const int OBJ_TEXTURE_TYPES = 9;
+static const char *textureTypes[OBJ_TEXTURE_TYPES] = {"diffuse", "specular", "ambient", "emissive",
+    "height", "normal", "shininess", "opacity", "displacement"};
+
+//! One material of a library, with the defaults of Assimp's OBJ importer.
+struct ObjMaterial {
+    vec3 diffuse = vec3(0.6f);
+    float opacity = 1.0f;
+    //! The image files of each texture type.
+    vector<string> images[OBJ_TEXTURE_TYPES];
+};
+
+//! The position, texture coordinate and normal of a face corner, -1 for none.
+struct ObjCorner {
+    int position, texCoord, normal;
+    bool operator==(const ObjCorner &other) const
+    {
+        return (position == other.position) && (texCoord == other.texCoord) && (normal == other.normal);
+    }
+};
+
+struct ObjCornerHash {
+    size_t operator()(const ObjCorner &corner) const
+    {
+        return ((size_t) corner.position * 73856093u) ^ ((size_t) corner.texCoord * 19349663u)
+        ^ ((size_t) corner.normal * 83492791u);
+    }
+};
+
+//! One mesh as it is read, a vertex for each distinct corner.
+struct ObjMeshBuild {
+    string material;
+    bool textured = false;
+    vector<ObjCorner> corners;
+    vector<GLuint> indices;
+    unordered_map<ObjCorner, GLuint, ObjCornerHash> lookup;
+};
+
+//! A file read out of the asset pack, or mapped from the disk.
+struct ObjSource {
+    PackView contents;
+    void *mapped = nullptr;
+    size_t mappedSize = 0;
+    ~ObjSource()
+    {
+        if (mapped != nullptr)
+        {
+            munmap(mapped, mappedSize);
+        }
+    }
+    bool open(string path)
+    {
+        if (AssetPack::shared().view(path, contents))
+        {
+            return true;
+        }
+        int handle = ::open(path.c_str(), O_RDONLY);
+        if (handle < 0)
+        {
+            return false;
+        }
+        struct stat status;
+        if ((fstat(handle, &status) != 0) || (status.st_size <= 0))
+        {
+            close(handle);
+            return false;
+        }
+        void *data = mmap(nullptr, status.st_size, PROT_READ, MAP_PRIVATE, handle, 0);
+        close(handle);
+        if (data == MAP_FAILED)
+        {
+            return false;
+        }
+        //! It is read once from front to back.
+        madvise(data, status.st_size, MADV_SEQUENTIAL);
+        mapped = data;
+        mappedSize = status.st_size;
+        contents.data = (const unsigned char*) data;
+        contents.size = mappedSize;
+        return true;
+    }
+    const char *begin() { return (const char*) contents.data; }
+    const char *end() { return (const char*) contents.data + contents.size; }
+};
+
+//! Powers of ten a double holds exactly.
+static const double powers[23] = {1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+
+/** \brief Read eight decimal digits at once as one 64 bit word, returning
+ * false unless all eight are digits.  The text must have eight bytes left.
+ */
+static inline bool eightDigits(const char *text, uint64_t &value)
+{
+#if defined(__BYTE_ORDER__) && (__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__)
+    uint64_t chunk;
+    memcpy(&chunk, text, 8);
+    //! Every byte is 0x30 to 0x39 when its high half is 3 and adding 6 leaves it 3.
+    if (((chunk & 0xF0F0F0F0F0F0F0F0ull) | (((chunk + 0x0606060606060606ull) & 0xF0F0F0F0F0F0F0F0ull) >> 4))
+        != 0x3333333333333333ull)
+    {
+        return false;
+    }
+    //! Combine the digits in pairs, then fours, then the eight.
+    chunk -= 0x3030303030303030ull;
+    chunk = (chunk * 10) + (chunk >> 8);
+    value = ((((chunk & 0x000000FF000000FFull) * (100 + (1000000ull << 32)))
+        + (((chunk >> 16) & 0x000000FF000000FFull) * (1 + (10000ull << 32)))) >> 32) & 0xFFFFFFFFull;
+    return true;
+#else
+    return false;
+#endif
+}
+
+float ObjParser::parseFloat(const char *&text, const char *end)
+{
+    const char *p = text;
+    while ((p < end) && ((*p == ' ') || (*p == '\t')))
+    {
+        p++;
+    }
+    bool negative = false;
+    if ((p < end) && ((*p == '-') || (*p == '+')))
+    {
+        negative = (*p == '-');
+        p++;
+    }
+    //! Up to 19 significant digits fit the mantissa, the rest only scale it.
+    uint64_t mantissa = 0, chunk = 0;
+    int exponent = 0, digits = 0;
+    const char *start = p;
+    while ((end - p >= 8) && (digits <= 11) && (eightDigits(p, chunk)))
+    {
+        mantissa = mantissa * 100000000ull + chunk;
+        digits += (mantissa > 0) ? 8 : 0;
+        p += 8;
+    }
+    while ((p < end) && (*p >= '0') && (*p <= '9'))
+    {
+        if (digits < 19)
+        {
+            mantissa = mantissa * 10 + (*p - '0');
+            digits += (mantissa > 0) ? 1 : 0;
+        }
+        else
+        {
+            exponent++;
+        }
+        p++;
+    }
+    bool whole = (p > start);
+    if ((p < end) && (*p == '.'))
+    {
+        p++;
+        const char *fraction = p;
+        while ((end - p >= 8) && (digits <= 11) && (eightDigits(p, chunk)))
+        {
+            mantissa = mantissa * 100000000ull + chunk;
+            digits += (mantissa > 0) ? 8 : 0;
+            exponent -= 8;
+            p += 8;
+        }
+        while ((p < end) && (*p >= '0') && (*p <= '9'))
+        {
+            if (digits < 19)
+            {
+                mantissa = mantissa * 10 + (*p - '0');
+                digits += (mantissa > 0) ? 1 : 0;
+                exponent--;
+            }
+            p++;
+        }
+        whole = whole || (p > fraction);
+    }
+    if (!whole)
+    {
+        //! Not a plain number, "nan" or "inf" perhaps, which strtof() reads.
+        char buffer[32];
+        size_t size = std::min((size_t) (end - start), sizeof(buffer) - 1);
+        memcpy(buffer, start, size);
+        buffer[size] = '\0';
+        char *stop = buffer;
+        float value = strtof(buffer, &stop);
+        if (stop == buffer)
+        {
+            return 0.0f;
+        }
+        text = start + (stop - buffer);
+        return (negative) ? -value : value;
+    }
+    if ((p < end) && ((*p == 'e') || (*p == 'E')))
+    {
+        const char *q = p + 1;
+        int sign = 1, power = 0;
+        if ((q < end) && ((*q == '-') || (*q == '+')))
+        {
+            sign = (*q == '-') ? -1 : 1;
+            q++;
+        }
+        if ((q < end) && (*q >= '0') && (*q <= '9'))
+        {
+            while ((q < end) && (*q >= '0') && (*q <= '9'))
+            {
+                power = std::min(power * 10 + (*q - '0'), 1000);
+                q++;
+            }
+            exponent += sign * power;
+            p = q;
+        }
+    }
+    double value = (double) mantissa;
+    if ((exponent >= 0) && (exponent <= 22))
+    {
+        value *= powers[exponent];
+    }
+    else if ((exponent < 0) && (exponent >= -22))
+    {
+        value /= powers[-exponent];
+    }
+    else
+    {
+        value *= std::pow(10.0, exponent);
+    }
+    text = p;
+    return (float) ((negative) ? -value : value);
+}
+
+/** \brief Read a one based face index, or a negative one counting back
+ * from the end, as a zero based index below count.
+ */
+static bool parseIndex(const char *&text, const char *end, int count, int &index)
+{
+    bool negative = false;
+    if ((text < end) && (*text == '-'))
+    {
+        negative = true;
+        text++;
+    }
+    long value = 0;
+    const char *start = text;
+    while ((text < end) && (*text >= '0') && (*text <= '9') && (value <= INT32_MAX))
+    {
+        value = value * 10 + (*text - '0');
+        text++;
+    }
+    if ((text == start) || (value == 0))
+    {
+        return false;
+    }
+    value = (negative) ? count - value : value - 1;
+    if ((value < 0) || (value >= count))
+    {
+        return false;
+    }
+    index = (int) value;
+    return true;
+}
+
+static inline bool isSpace(char letter)
+{
+    return (letter == ' ') || (letter == '\t') || (letter == '\r');
+}
+
+//! \brief The next word of a line, moving past it.
+static string nextWord(const char *&text, const char *stop)
+{
+    while ((text < stop) && (isSpace(*text)))
+    {
+        text++;
+    }
+    const char *start = text;
+    while ((text < stop) && (!isSpace(*text)))
+    {
+        text++;
+    }
+    return string(start, text);
+}
+
+//! \brief The rest of a line without the white space around it.
+static string restOfLine(const char *text, const char *stop)
+{
+    while ((text < stop) && (isSpace(*text)))
+    {
+        text++;
+    }
+    while ((stop > text) && (isSpace(stop[-1])))
+    {
+        stop--;
+    }
+    return string(text, stop);
+}
+
+//! \brief The image file of a texture statement, past any options such as "-bm 1.0".
+static string textureName(const char *text, const char *stop)
+{
+    while (true)
+    {
+        const char *before = text;
+        string word = nextWord(text, stop);
+        if ((word.size() < 2) || (word[0] != '-') || (isdigit((unsigned char) word[1])))
+        {
+            return restOfLine(before, stop);
+        }
+        //! The arguments of an option are numbers, on or off, except for two.
+        if ((word == "-imfchan") || (word == "-type"))
+        {
+            nextWord(text, stop);
+            continue;
+        }
+        while (true)
+        {
+            const char *argument = text;
+            string value = nextWord(text, stop);
+            bool numeric = (value == "on") || (value == "off");
+            if ((!numeric) && (value.size() > 0))
+            {
+                char *last = nullptr;
+                strtod(value.c_str(), &last);
+                numeric = (*last == '\0');
+            }
+            if (!numeric)
+            {
+                text = argument;
+                break;
+            }
+        }
+    }
+}
+
+//! \brief Read a material library into the materials by name.
+static void readLibrary(string path, unordered_map<string, ObjMaterial> &materials)
+{
+    ObjSource source;
+    if (!source.open(path))
+    {
+        cout << "\n\n\tWarning:  No material library " << path << ".\n\n";
+        return;
+    }
+    ObjMaterial *material = nullptr;
+    const char *text = source.begin(), *end = source.end();
+    while (text < end)
+    {
+        const char *stop = (const char*) memchr(text, '\n', end - text);
+        stop = (stop == nullptr) ? end : stop;
+        const char *line = text;
+        string keyword = nextWord(line, stop);
+        text = stop + 1;
+        if ((keyword.size() == 0) || (keyword[0] == '#'))
+        {
+            continue;
+        }
+        if (keyword == "newmtl")
+        {
+            material = &materials[restOfLine(line, stop)];
+            continue;
+        }
+        if (material == nullptr)
+        {
+            continue;
+        }
+        int type = -1;
+        if (keyword == "Kd")
+        {
+            for (int x = 0; x < 3; x++)
+            {
+                material->diffuse[x] = ObjParser::parseFloat(line, stop);
+            }
+        }
+        else if (keyword == "d")
+        {
+            material->opacity = ObjParser::parseFloat(line, stop);
+        }
+        else if (keyword == "Tr")
+        {
+            material->opacity = 1.0f - ObjParser::parseFloat(line, stop);
+        }
+        else if (keyword == "map_Kd")
+        {
+            type = 0;
+        }
+        else if (keyword == "map_Ks")
+        {
+            type = 1;
+        }
+        else if (keyword == "map_Ka")
+        {
+            type = 2;
+        }
+        else if (keyword == "map_Ke")
+        {
+            type = 3;
+        }
+        else if ((keyword == "map_bump") || (keyword == "map_Bump") || (keyword == "bump"))
+        {
+            type = 4;
+        }
+        else if ((keyword == "map_Kn") || (keyword == "norm"))
+        {
+            type = 5;
+        }
+        else if (keyword == "map_Ns")
+        {
+            type = 6;
+        }
+        else if (keyword == "map_d")
+        {
+            type = 7;
+        }
+        else if (keyword == "disp")
+        {
+            type = 8;
+        }
+        if (type >= 0)
+        {
+            string name = textureName(line, stop);
+            if (name.size() > 0)
+            {
+                material->images[type].push_back(name);
+            }
+        }
+    }
+}
+
+bool ObjParser::handles(string path)
+{
+    string extension = boost::filesystem::path(path).extension().string();
+    transform(extension.begin(), extension.end(), extension.begin(), ::tolower);
+    return extension == ".obj";
+}
+
+bool ObjParser::read(string path, vector<MeshData> &meshes)
+{
+    auto begin = chrono::steady_clock::now();
+    ObjSource source;
+    if (!source.open(path))
+    {
+        return false;
+    }
+    string directory = path.substr(0, path.find_last_of('/'));
+    vector<float> positions, texCoords, normals;
+    vector<vec3> faceNormals;
+    vector<ObjMeshBuild> builds;
+    //! The mesh of each material of the current object.
+    unordered_map<string, int> objectMeshes;
+    vector<string> libraries;
+    string material;
+    int current = -1;
+    vector<ObjCorner> face;
+    vector<GLuint> faceIndices;
+    const char *text = source.begin(), *end = source.end();
+    int lineNumber = 0;
+    while (text < end)
+    {
+        lineNumber++;
+        while ((text < end) && ((*text == ' ') || (*text == '\t')))
+        {
+            text++;
+        }
+        const char *stop = (const char*) memchr(text, '\n', end - text);
+        stop = (stop == nullptr) ? end : stop;
+        const char *line = text;
+        text = stop + 1;
+        if ((stop - line < 2) || (line[0] == '#'))
+        {
+            continue;
+        }
+        bool failed = false;
+        if ((line[0] == 'v') && (isSpace(line[1])))
+        {
+            line++;
+            for (int x = 0; x < 3; x++)
+            {
+                const char *before = line;
+                positions.push_back(parseFloat(line, stop));
+                failed = failed || (line == before);
+            }
+        }
+        else if ((line[0] == 'v') && (line[1] == 't'))
+        {
+            line += 2;
+            for (int x = 0; x < 2; x++)
+            {
+                const char *before = line;
+                texCoords.push_back(parseFloat(line, stop));
+                //! A one dimensional coordinate has its v left 0.
+                if ((line == before) && (x == 1))
+                {
+                    texCoords.back() = 0.0f;
+                }
+                else
+                {
+                    failed = failed || (line == before);
+                }
+            }
+        }
+        else if ((line[0] == 'v') && (line[1] == 'n'))
+        {
+            line += 2;
+            for (int x = 0; x < 3; x++)
+            {
+                const char *before = line;
+                normals.push_back(parseFloat(line, stop));
+                failed = failed || (line == before);
+            }
+        }
+        else if ((line[0] == 'f') && (isSpace(line[1])))
+        {
+            line++;
+            face.clear();
+            int positionCount = positions.size() / 3, texCoordCount = texCoords.size() / 2, normalCount = normals.size() / 3;
+            while (!failed)
+            {
+                while ((line < stop) && (isSpace(*line)))
+                {
+                    line++;
+                }
+                if (line >= stop)
+                {
+                    break;
+                }
+                ObjCorner corner = {-1, -1, -1};
+                failed = !parseIndex(line, stop, positionCount, corner.position);
+                if ((!failed) && (line < stop) && (*line == '/'))
+                {
+                    line++;
+                    if ((line < stop) && (*line != '/'))
+                    {
+                        failed = !parseIndex(line, stop, texCoordCount, corner.texCoord);
+                    }
+                    if ((!failed) && (line < stop) && (*line == '/'))
+                    {
+                        line++;
+                        failed = !parseIndex(line, stop, normalCount, corner.normal);
+                    }
+                }
+                failed = failed || ((line < stop) && (!isSpace(*line)));
+                face.push_back(corner);
+            }
+            //! Points and lines are left out, they are not drawn as triangles.
+            if ((!failed) && (face.size() >= 3))
+            {
+                if (current < 0)
+                {
+                    auto found = objectMeshes.find(material);
+                    if (found == objectMeshes.end())
+                    {
+                        found = objectMeshes.emplace(material, (int) builds.size()).first;
+                        builds.push_back(ObjMeshBuild());
+                        builds.back().material = material;
+                    }
+                    current = found->second;
+                }
+                ObjMeshBuild &build = builds[current];
+                //! A face without normals gets the flat normal GenNormals gives it.
+                int flat = 0;
+                for (unsigned int x = 0; x < face.size(); x++)
+                {
+                    if (face[x].normal < 0)
+                    {
+                        if (flat == 0)
+                        {
+                            vec3 normal(0.0f);
+                            for (unsigned int y = 0; y < face.size(); y++)
+                            {
+                                float *a = &positions[face[y].position * 3];
+                                float *b = &positions[face[(y + 1) % face.size()].position * 3];
+                                normal += cross(vec3(a[0], a[1], a[2]), vec3(b[0], b[1], b[2]));
+                            }
+                            float size = length(normal);
+                            faceNormals.push_back((size > 0.0f) ? normal / size : normal);
+                            flat = -1 - (int) faceNormals.size();
+                        }
+                        face[x].normal = flat;
+                    }
+                    build.textured = build.textured || (face[x].texCoord >= 0);
+                }
+                faceIndices.clear();
+                for (unsigned int x = 0; x < face.size(); x++)
+                {
+                    auto result = build.lookup.emplace(face[x], (GLuint) build.corners.size());
+                    if (result.second)
+                    {
+                        build.corners.push_back(face[x]);
+                    }
+                    faceIndices.push_back(result.first->second);
+                }
+                //! A fan from the first corner, as aiProcess_Triangulate splits a convex polygon.
+                for (unsigned int x = 1; x + 1 < faceIndices.size(); x++)
+                {
+                    build.indices.push_back(faceIndices[0]);
+                    build.indices.push_back(faceIndices[x]);
+                    build.indices.push_back(faceIndices[x + 1]);
+                }
+            }
+        }
+        else if (((line[0] == 'o') || (line[0] == 'g')) && (isSpace(line[1])))
+        {
+            //! Assimp starts a new object at each group too.
+            objectMeshes.clear();
+            current = -1;
+        }
+        else
+        {
+            string keyword = nextWord(line, stop);
+            if (keyword == "usemtl")
+            {
+                material = restOfLine(line, stop);
+                current = -1;
+            }
+            else if (keyword == "mtllib")
+            {
+                for (string name = nextWord(line, stop); name.size() > 0; name = nextWord(line, stop))
+                {
+                    libraries.push_back(name);
+                }
+            }
+        }
+        if (failed)
+        {
+            cout << "\n\n\tThe OBJ parser can not read line " << lineNumber << " of " << path
+            << ", it is left to Assimp.\n\n";
+            return false;
+        }
+    }
+    unordered_map<string, ObjMaterial> materials;
+    for (unsigned int x = 0; x < libraries.size(); x++)
+    {
+        readLibrary(directory + "/" + libraries[x], materials);
+    }
+    ObjMaterial standard;
+    for (unsigned int x = 0; x < builds.size(); x++)
+    {
+        ObjMeshBuild &build = builds[x];
+        if (build.corners.size() < 3)
+        {
+            continue;
+        }
+        MeshData item;
+        item.textured = build.textured;
+        item.vertSize = build.corners.size();
+        item.indexSize = build.indices.size();
+        //! Both vertex layouts start with the position and the normal.
+        float *vertices;
+        int stride;
+        if (item.textured)
+        {
+            item.vertices = new Vertex[item.vertSize];
+            vertices = (float*) item.vertices;
+            stride = sizeof(Vertex) / sizeof(float);
+        }
+        else
+        {
+            item.vertices1 = new Vertex1[item.vertSize];
+            vertices = (float*) item.vertices1;
+            stride = sizeof(Vertex1) / sizeof(float);
+        }
+        for (int y = 0; y < item.vertSize; y++)
+        {
+            ObjCorner &corner = build.corners[y];
+            float *vertex = &vertices[y * stride];
+            memcpy(vertex, &positions[corner.position * 3], 3 * sizeof(float));
+            if (corner.normal >= 0)
+            {
+                memcpy(vertex + 3, &normals[corner.normal * 3], 3 * sizeof(float));
+            }
+            else
+            {
+                vec3 &normal = faceNormals[-2 - corner.normal];
+                vertex[3] = normal.x;
+                vertex[4] = normal.y;
+                vertex[5] = normal.z;
+            }
+            if (item.textured)
+            {
+                vertex[6] = (corner.texCoord >= 0) ? texCoords[corner.texCoord * 2] : 0.0f;
+                vertex[7] = (corner.texCoord >= 0) ? texCoords[corner.texCoord * 2 + 1] : 0.0f;
+            }
+        }
+        item.indices = new GLuint[item.indexSize];
+        memcpy(item.indices, build.indices.data(), item.indexSize * sizeof(GLuint));
+        auto found = materials.find(build.material);
+        ObjMaterial &mat = (found != materials.end()) ? found->second : standard;
+        item.opacity = mat.opacity;
+        if (item.textured)
+        {
+            for (int y = 0; y < OBJ_TEXTURE_TYPES; y++)
+            {
+                for (unsigned int z = 0; z < mat.images[y].size(); z++)
+                {
+                    item.images.push_back(make_pair(directory + "/" + mat.images[y][z], string(textureTypes[y])));
+                }
+            }
+        }
+        else
+        {
+            item.color = mat.diffuse;
+        }
+        meshes.push_back(item);
+    }
+    if (meshes.size() == 0)
+    {
+        cout << "\n\n\tThe OBJ parser found no faces in " << path << ", it is left to Assimp.\n\n";
+        return false;
+    }
+    if (debug1)
+    {
+        double time = chrono::duration<double, milli>(chrono::steady_clock::now() - begin).count();
+        cout << "\n\n\tParsed " << path << " into " << meshes.size() << " meshes in " << time << " ms.\n\n";
+    }
+    return true;
+}
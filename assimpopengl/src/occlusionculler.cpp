@@ -0,0 +1,258 @@
+/**********************************************************
+ *   OcclusionCuller:  A class to drop instances hidden
+ *   behind nearer ones, using a depth buffer rasterized on
+ *   the CPU and a hierarchy of farthest depths.
+ *   Created by: Edward Charles Eberle <eberdeed@eberdeed.net>
+ *   October 2026 San Diego, California USA
+ * ********************************************************/
+
+#include "../include/occlusionculler.h"
+
+OcclusionCuller::OcclusionCuller(int width, int height, int threads)
+{
+    cout << "\n\n\tCreating OcclusionCuller.\n\n";
+    this->width = width;
+    this->height = height;
+    //! The mip levels down to one pixel.
+    int w = width, h = height;
+    while (true)
+    {
+        levelWidth.push_back(w);
+        levelHeight.push_back(h);
+        levels.push_back(vector<float>(w * h, 1.0f));
+        if ((w == 1) && (h == 1))
+        {
+            break;
+        }
+        w = std::max(1, (w + 1) / 2);
+        h = std::max(1, (h + 1) / 2);
+    }
+    if (threads < 1)
+    {
+        threads = glm::clamp((int) thread::hardware_concurrency() - 1, 1, 4);
+    }
+    threads = std::min(threads, height);
+    for (int x = 0; x < threads; x++)
+    {
+        workers.push_back(thread(&OcclusionCuller::worker, this, x));
+    }
+}
+
+OcclusionCuller::~OcclusionCuller()
+{
+    cout << "\n\n\tDestroying OcclusionCuller.\n\n";
+    {
+        lock_guard<mutex> guard(lock);
+        quit = true;
+    }
+    wake.notify_all();
+    for (unsigned int x = 0; x < workers.size(); x++)
+    {
+        workers[x].join();
+    }
+}
+
+void OcclusionCuller::beginFrame(mat4 view, mat4 projection)
+{
+    this->view = view;
+    viewProjection = projection * view;
+    projScaleX = projection[0][0];
+    projScaleY = projection[1][1];
+    projDepthA = projection[2][2];
+    projDepthB = projection[3][2];
+    fill(levels[0].begin(), levels[0].end(), 1.0f);
+    triangles.clear();
+    occluderTriangles = tested = culled = 0;
+}
+
+void OcclusionCuller::addOccluder(Occluder &occluder, mat4 model)
+{
+    mat4 transform = viewProjection * model;
+    vec3 screen[3];
+    for (unsigned int x = 0; x + 2 < occluder.indices.size(); x += 3)
+    {
+        bool behind = false;
+        for (int y = 0; y < 3; y++)
+        {
+            vec4 clip = transform * vec4(occluder.positions[occluder.indices[x + y]] * occluderShrink, 1.0f);
+            //! Triangles crossing the near plane are left out rather than clipped.
+            if (clip.w <= 0.0001f)
+            {
+                behind = true;
+                break;
+            }
+            screen[y] = vec3(((clip.x / clip.w) * 0.5f + 0.5f) * width,
+                ((clip.y / clip.w) * 0.5f + 0.5f) * height,
+                (clip.z / clip.w) * 0.5f + 0.5f);
+        }
+        if (behind)
+        {
+            continue;
+        }
+        //! Back faces are hidden by the front faces of the same occluder.
+        float area = (screen[1].x - screen[0].x) * (screen[2].y - screen[0].y)
+            - (screen[2].x - screen[0].x) * (screen[1].y - screen[0].y);
+        if (area <= 0.0f)
+        {
+            continue;
+        }
+        triangles.push_back(screen[0]);
+        triangles.push_back(screen[1]);
+        triangles.push_back(screen[2]);
+    }
+}
+
+void OcclusionCuller::endFrame()
+{
+    occluderTriangles = triangles.size() / 3;
+    if (occluderTriangles > 0)
+    {
+        unique_lock<mutex> guard(lock);
+        pending = workers.size();
+        generation++;
+        wake.notify_all();
+        done.wait(guard, [this] { return pending == 0; });
+    }
+    buildHierarchy();
+}
+
+void OcclusionCuller::worker(int band)
+{
+    int seen = 0;
+    while (true)
+    {
+        {
+            unique_lock<mutex> guard(lock);
+            wake.wait(guard, [this, &seen] { return (quit) || (generation != seen); });
+            if (quit)
+            {
+                return;
+            }
+            seen = generation;
+        }
+        rasterBand(band);
+        {
+            lock_guard<mutex> guard(lock);
+            if (--pending == 0)
+            {
+                done.notify_one();
+            }
+        }
+    }
+}
+
+void OcclusionCuller::rasterBand(int band)
+{
+    int bands = workers.size();
+    int rowStart = (height * band) / bands, rowEnd = (height * (band + 1)) / bands;
+    float *depth = levels[0].data();
+    for (unsigned int t = 0; t < triangles.size(); t += 3)
+    {
+        const vec3 &a = triangles[t], &b = triangles[t + 1], &c = triangles[t + 2];
+        int x0 = std::max(0, (int) floor(std::min(a.x, std::min(b.x, c.x))));
+        int x1 = std::min(width - 1, (int) ceil(std::max(a.x, std::max(b.x, c.x))));
+        int y0 = std::max(rowStart, (int) floor(std::min(a.y, std::min(b.y, c.y))));
+        int y1 = std::min(rowEnd - 1, (int) ceil(std::max(a.y, std::max(b.y, c.y))));
+        if ((x0 > x1) || (y0 > y1))
+        {
+            continue;
+        }
+        float area = (b.x - a.x) * (c.y - a.y) - (c.x - a.x) * (b.y - a.y);
+        for (int y = y0; y <= y1; y++)
+        {
+            float py = y + 0.5f;
+            for (int x = x0; x <= x1; x++)
+            {
+                float px = x + 0.5f;
+                //! Edge functions at the pixel center, all positive inside.
+                float w0 = (c.x - b.x) * (py - b.y) - (c.y - b.y) * (px - b.x);
+                float w1 = (a.x - c.x) * (py - c.y) - (a.y - c.y) * (px - c.x);
+                float w2 = (b.x - a.x) * (py - a.y) - (b.y - a.y) * (px - a.x);
+                if ((w0 < 0.0f) || (w1 < 0.0f) || (w2 < 0.0f))
+                {
+                    continue;
+                }
+                float z = (w0 * a.z + w1 * b.z + w2 * c.z) / area;
+                float &stored = depth[y * width + x];
+                if (z < stored)
+                {
+                    stored = z;
+                }
+            }
+        }
+    }
+}
+
+void OcclusionCuller::buildHierarchy()
+{
+    for (unsigned int l = 1; l < levels.size(); l++)
+    {
+        const vector<float> &source = levels[l - 1];
+        vector<float> &target = levels[l];
+        int sw = levelWidth[l - 1], sh = levelHeight[l - 1];
+        for (int y = 0; y < levelHeight[l]; y++)
+        {
+            int sy0 = std::min(y * 2, sh - 1), sy1 = std::min(y * 2 + 1, sh - 1);
+            for (int x = 0; x < levelWidth[l]; x++)
+            {
+                int sx0 = std::min(x * 2, sw - 1), sx1 = std::min(x * 2 + 1, sw - 1);
+                //! Keep the farthest depth so a test against it is conservative.
+                target[y * levelWidth[l] + x] = std::max(
+                    std::max(source[sy0 * sw + sx0], source[sy0 * sw + sx1]),
+                    std::max(source[sy1 * sw + sx0], source[sy1 * sw + sx1]));
+            }
+        }
+    }
+}
+
+bool OcclusionCuller::isVisible(vec3 center, float radius)
+{
+    tested++;
+    vec4 eye = view * vec4(center, 1.0f);
+    float dist = -eye.z, nearDist = dist - radius, farDist = dist + radius;
+    //! Wholly behind the camera.
+    if (farDist <= 0.0f)
+    {
+        culled++;
+        return false;
+    }
+    if (nearDist <= 0.0001f)
+    {
+        return true;
+    }
+    //! The screen rectangle of the box around the sphere.
+    float left = std::min((eye.x - radius) / nearDist, (eye.x - radius) / farDist) * projScaleX;
+    float right = std::max((eye.x + radius) / nearDist, (eye.x + radius) / farDist) * projScaleX;
+    float bottom = std::min((eye.y - radius) / nearDist, (eye.y - radius) / farDist) * projScaleY;
+    float top = std::max((eye.y + radius) / nearDist, (eye.y + radius) / farDist) * projScaleY;
+    if ((right < -1.0f) || (left > 1.0f) || (top < -1.0f) || (bottom > 1.0f))
+    {
+        culled++;
+        return false;
+    }
+    float px0 = glm::clamp((left * 0.5f + 0.5f) * width, 0.0f, (float) width - 1.0f);
+    float px1 = glm::clamp((right * 0.5f + 0.5f) * width, 0.0f, (float) width - 1.0f);
+    float py0 = glm::clamp((bottom * 0.5f + 0.5f) * height, 0.0f, (float) height - 1.0f);
+    float py1 = glm::clamp((top * 0.5f + 0.5f) * height, 0.0f, (float) height - 1.0f);
+    //! The level where the rectangle spans about two texels.
+    float span = std::max(px1 - px0, py1 - py0);
+    int level = glm::clamp((int) ceil(log2(std::max(span, 1.0f))), 0, (int) levels.size() - 1);
+    int x0 = (int) px0 >> level, x1 = (int) px1 >> level;
+    int y0 = (int) py0 >> level, y1 = (int) py1 >> level;
+    float farthest = 0.0f;
+    for (int y = y0; y <= y1; y++)
+    {
+        for (int x = x0; x <= x1; x++)
+        {
+            farthest = std::max(farthest, levels[level][y * levelWidth[level] + x]);
+        }
+    }
+    //! The depth of the nearest point of the sphere.
+    float nearest = ((-projDepthA + (projDepthB / nearDist)) * 0.5f) + 0.5f;
+    if (nearest <= farthest)
+    {
+        return true;
+    }
+    culled++;
+    return false;
+}
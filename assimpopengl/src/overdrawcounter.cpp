@@ -0,0 +1,110 @@
+/**********************************************************
+ *   OverdrawCounter:  A class to count the fragments that
+ *   are shaded in a frame, using the stencil buffer of an
+ *   offscreen framebuffer.
+ *   Created by: Edward Charles Eberle <eberdeed@eberdeed.net>
+ *   October 2026 San Diego, California USA
+ * ********************************************************/
+
+#include "../include/overdrawcounter.h"
+
+OverdrawCounter::OverdrawCounter(Shader *shader)
+{
+    cout << "\n\n\tCreating OverdrawCounter.\n\n";
+    this->shader = shader;
+    glGenVertexArrays(1, &VAO);
+}
+
+OverdrawCounter::~OverdrawCounter()
+{
+    cout << "\n\n\tDestroying OverdrawCounter.\n\n";
+    glDeleteVertexArrays(1, &VAO);
+    glDeleteTextures(1, &colorTex);
+    glDeleteRenderbuffers(1, &depthStencil);
+    glDeleteFramebuffers(1, &FBO);
+}
+
+void OverdrawCounter::allocate(int width, int height)
+{
+    this->width = width;
+    this->height = height;
+    if (FBO == 0)
+    {
+        glGenFramebuffers(1, &FBO);
+        glGenTextures(1, &colorTex);
+        glGenRenderbuffers(1, &depthStencil);
+    }
+    glBindTexture(GL_TEXTURE_2D, colorTex);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glBindTexture(GL_TEXTURE_2D, 0);
+    glBindRenderbuffer(GL_RENDERBUFFER, depthStencil);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH24_STENCIL8, width, height);
+    glBindRenderbuffer(GL_RENDERBUFFER, 0);
+    glBindFramebuffer(GL_FRAMEBUFFER, FBO);
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, colorTex, 0);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_RENDERBUFFER, depthStencil);
+    if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
+    {
+        cout << "\n\n\tError:  The overdraw framebuffer is not complete.\n\n";
+        exit(-1);
+    }
+    readBack.resize(width * height * 4);
+}
+
+void OverdrawCounter::begin()
+{
+    glGetIntegerv(GL_VIEWPORT, viewport);
+    glGetIntegerv(GL_FRAMEBUFFER_BINDING, &previous);
+    if ((viewport[2] != width) || (viewport[3] != height))
+    {
+        allocate(viewport[2], viewport[3]);
+    }
+    glBindFramebuffer(GL_FRAMEBUFFER, FBO);
+    glViewport(0, 0, width, height);
+    glStencilMask(0xFF);
+    glClearStencil(0);
+    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT | GL_STENCIL_BUFFER_BIT);
+    //! Count every fragment that passes the depth test.
+    glEnable(GL_STENCIL_TEST);
+    glStencilFunc(GL_ALWAYS, 0, 0xFF);
+    glStencilOp(GL_KEEP, GL_KEEP, GL_INCR);
+}
+
+long OverdrawCounter::end()
+{
+    glStencilOp(GL_KEEP, GL_KEEP, GL_KEEP);
+    glClearColor(0.0f, 0.0f, 0.0f, 0.0f);
+    glClear(GL_COLOR_BUFFER_BIT);
+    glDisable(GL_DEPTH_TEST);
+    glEnable(GL_BLEND);
+    glBlendFunc(GL_ONE, GL_ONE);
+    shader->Use();
+    shader->setFloat("weight", 1.0f / 255.0f);
+    glBindVertexArray(VAO);
+    //! Pass k adds one to every pixel whose count is at least k.
+    for (int x = 1; x <= std::min(maxLayers, 255); x++)
+    {
+        glStencilFunc(GL_LEQUAL, x, 0xFF);
+        glDrawArrays(GL_TRIANGLES, 0, 3);
+    }
+    glBindVertexArray(0);
+    glDisable(GL_BLEND);
+    glDisable(GL_STENCIL_TEST);
+    glEnable(GL_DEPTH_TEST);
+    glReadPixels(0, 0, width, height, GL_RGBA, GL_UNSIGNED_BYTE, readBack.data());
+    glBindFramebuffer(GL_FRAMEBUFFER, previous);
+    glViewport(viewport[0], viewport[1], viewport[2], viewport[3]);
+    fragments = pixels = 0;
+    for (int x = 0; x < width * height; x++)
+    {
+        fragments += readBack[x * 4];
+        pixels += (readBack[x * 4] > 0) ? 1 : 0;
+    }
+    if (debug1)
+    {
+        cout << "\n\tOverdraw:  " << fragments << " fragments over " << pixels << " pixels.";
+    }
+    return fragments;
+}
@@ -0,0 +1,153 @@
+/**********************************************************
+ *   ResourceRegistry:  A class to count the memory held by
+ *   each part of the program, and flag what is not freed.
+ *   Created by: Edward Charles Eberle <eberdeed@eberdeed.net>
+ *   October 2026 San Diego, California USA
+ * ********************************************************/
+
+#include "../include/resourceregistry.h"
+
+//! The names of the kinds in the report.
+static const char *kindNames[ResourceRegistry::KINDS] = {"heap", "GL buffers", "GL textures", "GL renderbuffers"};
+
+ResourceRegistry::ResourceRegistry()
+{
+    cout << "\n\n\tCreating ResourceRegistry.\n\n";
+}
+
+ResourceRegistry::~ResourceRegistry()
+{
+    report(true);
+    cout << "\n\n\tDestroying ResourceRegistry.\n\n";
+}
+
+ResourceRegistry &ResourceRegistry::shared()
+{
+    static ResourceRegistry registry;
+    return registry;
+}
+
+void ResourceRegistry::trackHeap(const void *pointer, string subsystem, long bytes)
+{
+    if ((!enabled) || (pointer == nullptr))
+    {
+        return;
+    }
+    lock_guard<mutex> guard(lock);
+    track(HEAP, (uintptr_t) pointer, subsystem, bytes);
+}
+
+void ResourceRegistry::releaseHeap(const void *pointer)
+{
+    if ((!enabled) || (pointer == nullptr))
+    {
+        return;
+    }
+    lock_guard<mutex> guard(lock);
+    release(HEAP, (uintptr_t) pointer);
+}
+
+void ResourceRegistry::trackGL(Kind kind, GLuint name, string subsystem, long bytes)
+{
+    if ((!enabled) || (name == 0))
+    {
+        return;
+    }
+    lock_guard<mutex> guard(lock);
+    track(kind, name, subsystem, bytes);
+}
+
+void ResourceRegistry::releaseGL(Kind kind, GLuint name)
+{
+    if ((!enabled) || (name == 0))
+    {
+        return;
+    }
+    lock_guard<mutex> guard(lock);
+    release(kind, name);
+}
+
+void ResourceRegistry::track(Kind kind, uintptr_t handle, string subsystem, long bytes)
+{
+    //! A handle recorded again is given its new size, under its new subsystem.
+    release(kind, handle);
+    Record &record = live[kind][handle];
+    record.subsystem = subsystem;
+    record.bytes = bytes;
+    Total &total = totals[subsystem][kind];
+    total.count++;
+    total.bytes += bytes;
+    total.peak = std::max(total.peak, total.bytes);
+    if (debug1)
+    {
+        cout << "\n\t" << subsystem << " holds " << bytes << " more bytes of " << kindNames[kind] << ".";
+    }
+}
+
+void ResourceRegistry::release(Kind kind, uintptr_t handle)
+{
+    auto found = live[kind].find(handle);
+    if (found == live[kind].end())
+    {
+        return;
+    }
+    Total &total = totals[found->second.subsystem][kind];
+    total.count--;
+    total.bytes -= found->second.bytes;
+    live[kind].erase(found);
+}
+
+long ResourceRegistry::held(string subsystem, Kind kind)
+{
+    lock_guard<mutex> guard(lock);
+    auto found = totals.find(subsystem);
+    if (found == totals.end())
+    {
+        return 0;
+    }
+    long bytes = 0;
+    for (int x = 0; x < KINDS; x++)
+    {
+        if ((kind == KINDS) || (kind == x))
+        {
+            bytes += found->second[x].bytes;
+        }
+    }
+    return bytes;
+}
+
+void ResourceRegistry::report(bool leaks)
+{
+    lock_guard<mutex> guard(lock);
+    long all[KINDS] = {0, 0, 0, 0};
+    int leaked = 0;
+    cout << "\n\n\t" << ((leaks) ? "Resources left at exit:" : "Resources held:")
+    << "\n\tSubsystem\tKind\tCount\tKB now\tKB peak";
+    for (auto &item : totals)
+    {
+        for (int x = 0; x < KINDS; x++)
+        {
+            Total &total = item.second[x];
+            if ((total.peak == 0) && (total.count == 0))
+            {
+                continue;
+            }
+            all[x] += total.bytes;
+            cout << "\n\t" << item.first << "\t" << kindNames[x] << "\t" << total.count
+            << "\t" << total.bytes / 1024 << "\t" << total.peak / 1024;
+            if ((leaks) && (total.count > 0))
+            {
+                cout << "\tLEAKED";
+                leaked += total.count;
+            }
+        }
+    }
+    cout << "\n\tTotal:  " << all[HEAP] / 1024 << " KB heap, " << all[BUFFER] / 1024
+    << " KB in GL buffers, " << all[TEXTURE] / 1024 << " KB in GL textures, "
+    << all[RENDERBUFFER] / 1024 << " KB in GL renderbuffers.";
+    if (leaks)
+    {
+        cout << "\n\t" << leaked << " allocations were never released.";
+    }
+    cout << "\n\n";
+}
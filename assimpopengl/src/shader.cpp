@@ -7,7 +7,12 @@
  * ****************************************************************/
 
 #include "../include/shader.h"
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
 
+vector<Shader*> Shader::pending;
 
 Shader::Shader()
 {
@@ -17,200 +22,237 @@ Shader::Shader()
 Shader::~Shader()
 {
     cout << "\n\n\tDestroying Shader:  " << shadername << ".\n\n";
+    if (compiling)
+    {
+        pending.erase(std::remove(pending.begin(), pending.end(), this), pending.end());
+        glDeleteShader(vertex);
+        glDeleteShader(fragment);
+    }
+    for (auto &item : variants)
+    {
+        delete item.second;
+    }
     glDeleteProgram(Program);
 }
 
 void Shader::initShader(string vertexPath, string fragmentPath, 
-    string outputFile)
+    string outputFile, vector<string> defines)
 {
-    cout << "\n\n\tIn initShader.\n\n";
+    startShader(vertexPath, fragmentPath, outputFile, defines);
+    finishShader();
+}
+
+void Shader::startShader(string vertexPath, string fragmentPath, 
+    string outputFile, vector<string> defines)
+{
+    cout << "\n\n\tIn startShader.\n\n";
+    static bool threadsSet = false;
+    if (!threadsSet)
+    {
+        //! Let the driver compile on as many threads as it likes.
+        if (GLEW_KHR_parallel_shader_compile)
+        {
+            glMaxShaderCompilerThreadsKHR(0xFFFFFFFF);
+            cout << "\n\n\tCompiling shaders in parallel.\n\n";
+        }
+        threadsSet = true;
+    }
     string home = getenv("HOME");
     shadername = outputFile;
+    this->vertexPath = vertexPath;
+    this->fragmentPath = fragmentPath;
+    this->defines = defines;
     outputFile =  home + "/.config/" + outputFile;
     this->outputFile = outputFile;
-    if (!exists(vertexPath))
+    if (!AssetPack::shared().has(vertexPath))
     {
         cout << "\n\n\tError no vertex shader at " << vertexPath << ".\n\n";
         exit(-1);
     }
-    if (!exists(fragmentPath))
+    if (!AssetPack::shared().has(fragmentPath))
     {
-        cout << "\n\n\tError no fragment shader at " << vertexPath << ".\n\n";
+        cout << "\n\n\tError no fragment shader at " << fragmentPath << ".\n\n";
         exit(-1);
     }
-    char *infoLog;
-    int numFormats = 0;
-    GLenum *valFormats;
-    glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &numFormats);
-    cout << "\n\n\tNumber of shader formats:  " << numFormats << "\n\n";
+    string vertexCode = readSource(vertexPath);
+    string fragmentCode = readSource(fragmentPath);
+    //! FNV-1a over everything that changes the compiled program.
+    const char *renderer = (const char*) glGetString(GL_RENDERER);
+    const char *version = (const char*) glGetString(GL_VERSION);
+    string keyText = vertexCode + '\0' + fragmentCode + '\0';
+    for (unsigned int x = 0; x < defines.size(); x++)
+    {
+        keyText += defines[x] + '\n';
+    }
+    keyText += string((renderer) ? renderer : "") + '\0' + string((version) ? version : "");
+    key = 14695981039346656037ull;
+    for (unsigned int x = 0; x < keyText.size(); x++)
+    {
+        key = (key ^ (unsigned char) keyText[x]) * 1099511628211ull;
+    }
     Program = glCreateProgram();
-    if (numFormats == 0)
+    if (loadBinary())
     {
-        response = false;
+        return;
     }
-    else
+    cout << "\n\n\tCompiling shader program:  " << shadername << ".\n\n";
+    vertex = createShader(GL_VERTEX_SHADER, vertexCode);
+    fragment = createShader(GL_FRAGMENT_SHADER, fragmentCode);
+    if ((!vertex) || (!fragment))
     {
-        if (numFormats > 1)
-        {
-            valFormats = new GLenum[numFormats];
-            glGetIntegerv(GL_PROGRAM_BINARY_FORMATS, (int*)valFormats);
-            format = valFormats[0];
-            for (int x = 0; x < numFormats; x++)
-            {
-                cout << "\n\nFormat " << x << " : " << valFormats[x] << " : " << format;
-            }
-            cout << "\n\n";
-        }
-        else
-        {
-            valFormats = new GLenum(0);
-            glGetIntegerv(GL_PROGRAM_BINARY_FORMATS, (int*) valFormats);
-            format = valFormats[0];
-            cout << "\n\n\tFormat " << 0 << " : " << valFormats[0] << " : " << format;
-        }
-        if (!format)
-        {
-            cout << "\n\tNo format available for program binary:  " << outputFile << ".\n\n";
-            response = false;
-        }
-        if (!exists(outputFile))
-        {
-            cout << "\n\tThe shader binary file:  " << outputFile << " does not exist.\n\n";
-            response = false;
-        }
-        else
-        {
-            boost::filesystem::ifstream shaderFile(outputFile, ios_base::in | ios_base::binary);
-            if (!shaderFile.is_open())
-            {
-                cout << "\n\n\tError opening file " << outputFile << ".\n\n";
-                response = false;
-                if (debug1)
-                {            
-                    exit(-1);
-                }
-            }
-            else
-            {
-                GLsizei fileSize = file_size(path(outputFile.c_str()));
-                if (debug1)
-                {
-                    cout << "\n\tFile Size:  " << fileSize;
-                }
-                char shaderBinary[fileSize];
-                if (debug1)
-                {
-                    cout << "\n\tCreated binary array to hold shader.\n\n";
-                }
-                shaderFile.read(shaderBinary, fileSize);
-                shaderFile.close();
-                glProgramBinary(Program, format, (GLvoid*) shaderBinary, fileSize);
-                glValidateProgram(Program);
-                glGetProgramiv(Program, GL_VALIDATE_STATUS, &response);
-                if (response)
-                {
-                    cout << "\n\n\tSuccessfully loaded and validated the pre-compiled agregate "
-                    << "program binary:  " << outputFile <<  ".\n\tThe program has binary format " 
-                    << format << " and size " << fileSize << " bytes.\n\n";
-                }
-            }
-        }
+        cout << "\n\n\tError creating shaders for shader:  " 
+        << outputFile << "\n\n";
+        exit(-1);
     }
-    cout << "\n\n\tCompleted program retrieval.\n\n";
-    if (!response)
+    glProgramParameteri(Program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+    glAttachShader(Program, vertex);
+    glAttachShader(Program, fragment);
+    glLinkProgram(Program);
+    //! The status is not asked for here, so the driver can go on
+    //! compiling while the next program is started.
+    compiling = true;
+    pending.push_back(this);
+}
+
+void Shader::finishShader()
+{
+    if (!compiling)
     {
-        glGetProgramiv(Program, GL_INFO_LOG_LENGTH, &response);
-        if (response > 1)
-        {
-            infoLog =  new char[response];
-            glGetProgramInfoLog(Program, response, NULL, infoLog);
-            cout << "\n\n\tError loading shader program binary \n\t" << infoLog 
-            << "\n\tFor binary:  " << outputFile << "\n\n";
-            if (false)
-            {            
-                exit(-1);
-            }
-        }
-        else
-        {
-            cout << "\n\n\tError loading program binary for file:  " << outputFile
-            << ".\n\tRecompile initiated.\n\n";
-            if (false)
-            {            
-                exit(-1);
-            }
-        }
-        vertex = createShader(GL_VERTEX_SHADER, vertexPath);
-        fragment = createShader(GL_FRAGMENT_SHADER, fragmentPath);
-        if ((!vertex) || (!fragment))
-        {
-            cout << "\n\n\tError compiling shaders for shader:  " 
-            << outputFile << "\n\n";
-            exit(1);
-        }
-        try {
-            glProgramParameteri(Program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
-            glAttachShader(Program, vertex);
-            glAttachShader(Program, fragment);
-            glLinkProgram(Program);
-        } catch(exception exc) {
-            cout << "\n\n\tError creating shader program:  " << exc.what() << "\n\n";
-            if (Program) {
-               glDeleteProgram(Program);
-            }
-            exit(-1);
-        }
-        
-        glGetProgramiv(Program, GL_PROGRAM_BINARY_LENGTH, &progLength);
-        // Print linking errors if any
+        return;
+    }
+    compiling = false;
+    pending.erase(std::remove(pending.begin(), pending.end(), this), pending.end());
+    glGetProgramiv(Program, GL_LINK_STATUS, &success);
+    if (!success)
+    {
+        shaderLog(vertex, vertexPath);
+        shaderLog(fragment, fragmentPath);
         glGetProgramiv(Program, GL_INFO_LOG_LENGTH, &infoLength);
-        if(infoLength > 0)
+        if (infoLength > 0)
         {
-            infoLog = new char[infoLength];
+            char *infoLog = new char[infoLength];
             glGetProgramInfoLog(Program, infoLength, NULL, infoLog);
             cout << "\n\n\tShader Program Link Error\n\t" << infoLog 
             << "\n\tFor shader:  " << outputFile << "\n\n";
-            exit(-1);
+            delete [] infoLog;
         }
-        else
-        {
-            cout << "\n\n\tShader agregate program created "
-            << "and the program has length " << progLength 
-            << " bytes.\n\n";
+        exit(-1);
+    }
+    glGetProgramiv(Program, GL_PROGRAM_BINARY_LENGTH, &progLength);
+    cout << "\n\n\tShader agregate program created "
+    << "and the program has length " << progLength 
+    << " bytes.\n\n";
+    // Delete the shaders as they're linked into our program now and no longer necessery
+    glDeleteShader(vertex);
+    glDeleteShader(fragment);
+    vertex = fragment = 0;
+    if(createBinary())
+    {
+        cout << "\n\n\tShader program binary " << outputFile 
+        << " compiled and saved.\n\n";
+    }
+    else
+    {
+        cout << "\n\n\tShader program binary " << outputFile 
+        << " failed to compile and save.\n\n";
+        if (debug1)
+        {            
+            exit(-1);
         }
-        // Delete the shaders as they're linked into our program now and no longer necessery
-        glDeleteShader(vertex);
-        glDeleteShader(fragment);
-        if(createBinary())
+    }
+}
+
+void Shader::finishAll()
+{
+    while (pending.size() > 0)
+    {
+        pending.front()->finishShader();
+    }
+}
+
+bool Shader::loadBinary()
+{
+    int numFormats = 0;
+    glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &numFormats);
+    if (debug1)
+    {
+        cout << "\n\n\tNumber of shader formats:  " << numFormats << "\n\n";
+    }
+    if (numFormats == 0)
+    {
+        cout << "\n\tNo format available for program binary:  " << outputFile << ".\n\n";
+        return false;
+    }
+    int fd = open(outputFile.c_str(), O_RDONLY);
+    if (fd < 0)
+    {
+        cout << "\n\tThe shader binary file:  " << outputFile << " does not exist.\n\n";
+        return false;
+    }
+    struct stat info;
+    if ((fstat(fd, &info) != 0) || (info.st_size < (off_t) sizeof(BinaryHeader)))
+    {
+        close(fd);
+        cout << "\n\tThe shader binary file:  " << outputFile << " is too short.\n\n";
+        return false;
+    }
+    size_t fileSize = info.st_size;
+    void *mapped = mmap(nullptr, fileSize, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (mapped == MAP_FAILED)
+    {
+        cout << "\n\n\tError mapping file " << outputFile << ".\n\n";
+        return false;
+    }
+    BinaryHeader header;
+    memcpy(&header, mapped, sizeof(header));
+    response = false;
+    if ((memcmp(header.magic, "ACSB", 4) != 0) || (header.version != 1)
+        || (header.length != fileSize - sizeof(header)))
+    {
+        cout << "\n\tThe shader binary file:  " << outputFile << " is not a shader cache.\n\n";
+    }
+    else if (header.key != key)
+    {
+        cout << "\n\tThe shader binary file:  " << outputFile 
+        << " was built from other sources or another driver.\n\n";
+    }
+    else
+    {
+        format = header.format;
+        glProgramBinary(Program, format, (const char*) mapped + sizeof(header), header.length);
+        glGetProgramiv(Program, GL_LINK_STATUS, &response);
+        if (response)
         {
-            cout << "\n\n\tShader program binary " << outputFile 
-            << " compiled and saved.\n\n";
+            cout << "\n\n\tSuccessfully loaded the pre-compiled agregate "
+            << "program binary:  " << outputFile <<  ".\n\tThe program has binary format " 
+            << format << " and size " << header.length << " bytes.\n\n";
         }
         else
         {
-            cout << "\n\n\tShader program binary " << outputFile 
-            << " failed to compile and save.\n\n";
-            if (debug1)
-            {            
-                exit(-1);
-            }
+            cout << "\n\n\tError loading program binary for file:  " << outputFile
+            << ".\n\tRecompile initiated.\n\n";
         }
     }
+    munmap(mapped, fileSize);
+    return response;
 }
 
-unsigned int Shader::createShader(unsigned int type, string fpath)
+string Shader::readSource(string fpath)
 {
-    unsigned int shaderobj;
-    int codeLen = 0;
-    string errorstr;
+    PackView packed;
+    if (AssetPack::shared().view(fpath, packed))
+    {
+        return addDefines(string((const char*) packed.data, packed.size));
+    }
     boost::filesystem::ifstream shaderFile(fpath);
     boost::filesystem::path filePath(fpath);
-    codeLen = file_size(filePath);
+    int codeLen = file_size(filePath);
     string shaderCode(codeLen, '\0');
     if (!shaderFile.is_open())
     {
         cout << "\n\n\tError opening file " << fpath << ".\n\n";
-        return 0;
+        exit(-1);
     }
     // Read file's buffer contents into streams
     if (codeLen > 0)
@@ -221,91 +263,79 @@ unsigned int Shader::createShader(unsigned int type, string fpath)
     else
     {
         cout << "\n\n\tNo data for shader: " << fpath << "\n\n";
-        return 0;
+        exit(-1);
     }
     shaderFile.close();
+    return addDefines(shaderCode);
+}
 
-    // Vertex Shader
-    try
+string Shader::addDefines(string shaderCode)
+{
+    //! The definitions go right after the #version line, and #line
+    //! keeps the compiler messages on the line numbers of the file.
+    if (defines.size() > 0)
     {
-        shaderobj = glCreateShader(type);
-        errorstr = getError();
-        glGetShaderiv(shaderobj, GL_INFO_LOG_LENGTH, &infoLength);
-        if (!shaderobj)
-        {
-            cout << "\n\n\tError creating shader object:  " << fpath << ".\n\n";
-            if (errorstr != "Unknown value.")
-            {
-                cout << "\n\n\tCreating the shader object produced:  " << errorstr << "\n\n";
-            }
-            exit(-1);
-        }
-        else if(infoLength > 0)
+        size_t version = shaderCode.find("#version");
+        size_t lineEnd = (version == string::npos) ? string::npos : shaderCode.find('\n', version);
+        if (lineEnd != string::npos)
         {
-            char infoLog[infoLength];
-            glGetShaderInfoLog(shaderobj, infoLength, NULL, infoLog);
-            cout << "\n\nShader Program Creation Error\n" << infoLog << "\n\tFor shader:  " << fpath << ".\n\n";
-            exit(-1);
-        }
-        else
-        {
-            cout << "\n\n\tCreated the shader object:  " << fpath << ".\n\n";
-        }
-        try 
-        {
-            glShaderCode[0] = (char*) shaderCode.c_str();
-            if (codeLen != strlen(glShaderCode[0]))
-            {
-                cout << "\n\n\tThe initial length of the shader string is " << codeLen
-                << " and the current length is " << strlen(glShaderCode[0]) 
-                << " for shader " << fpath << "\n\n";
-                exit(-1);
-            }
-            glShaderSource(shaderobj, 1, glShaderCode, &codeLen);
-            errorstr = getError();
-            if (errorstr != "GL_NO_ERROR")
+            int nextLine = count(shaderCode.begin(), shaderCode.begin() + lineEnd, '\n') + 2;
+            string header;
+            for (unsigned int x = 0; x < defines.size(); x++)
             {
-                cout << "\n\n\tAdding source code to the shader object produced:  " << errorstr << "\n\n";
-                exit(-1);
-            }
-            glCompileShader(shaderobj);
-            // Print compile errors if any
-            glGetShaderiv(shaderobj, GL_INFO_LOG_LENGTH, &infoLength);
-        } 
-        catch(exception exc) 
-        {
-            cout << "\n\n\tError creating shader object from code:  " << exc.what() << "\n\n";
-            exit(-1);
-        }
-        if ((!shaderobj) && (infoLength == 0))
-        {
-            cout << "\n\n\tError compiling shader object for shader:  " << fpath << ".\n\n";
-            if (debug1)
-            {            
-                exit(-1);
+                header += "#define " + defines[x] + "\n";
             }
+            header += "#line " + to_string(nextLine) + "\n";
+            shaderCode.insert(lineEnd + 1, header);
         }
-        else if(infoLength > 0)
-        {
-            char infoLog[infoLength];
-            glGetShaderInfoLog(shaderobj, infoLength, NULL, infoLog);
-            cout << "\n\n\tShader compilation error: \n" << infoLog 
-            << "\n\tFor shader " << fpath << "\n\n";
-            glDeleteShader(shaderobj);
-            return 0;
-        }
-        else
+    }
+    return shaderCode;
+}
+
+unsigned int Shader::createShader(unsigned int type, string code)
+{
+    string errorstr;
+    unsigned int shaderobj = glCreateShader(type);
+    if (!shaderobj)
+    {
+        errorstr = getError();
+        cout << "\n\n\tError creating shader object for:  " << shadername << ".\n\n";
+        if (errorstr != "Unknown value.")
         {
-             cout << "\n\n\tShader compiled.\n\n";
+            cout << "\n\n\tCreating the shader object produced:  " << errorstr << "\n\n";
         }
-        return shaderobj;
+        return 0;
     }
-    catch(exception exc)
+    int codeLen = code.size();
+    glShaderCode[0] = (char*) code.c_str();
+    glShaderSource(shaderobj, 1, glShaderCode, &codeLen);
+    glCompileShader(shaderobj);
+    return shaderobj;
+}
+
+bool Shader::shaderLog(GLuint shaderobj, string fpath)
+{
+    glGetShaderiv(shaderobj, GL_COMPILE_STATUS, &success);
+    if (success)
     {
-        cout << "\n\n\tError making shader:  " << exc.what() << "\n\n";
-        return 0;
+        return true;
+    }
+    glGetShaderiv(shaderobj, GL_INFO_LOG_LENGTH, &infoLength);
+    if (infoLength > 0)
+    {
+        char *infoLog = new char[infoLength];
+        glGetShaderInfoLog(shaderobj, infoLength, NULL, infoLog);
+        cout << "\n\n\tShader compilation error: \n" << infoLog 
+        << "\n\tFor shader " << fpath << "\n\n";
+        delete [] infoLog;
     }
+    else
+    {
+        cout << "\n\n\tError compiling shader object for shader:  " << fpath << ".\n\n";
+    }
+    return false;
 }
+
 string Shader::getError()
 {
     GLenum data = glGetError();
@@ -338,12 +368,59 @@ string Shader::getError()
     return answer;
 }
 
+Shader *Shader::variant(vector<string> extra)
+{
+    if (extra.size() < 1)
+    {
+        return this;
+    }
+    string key;
+    for (unsigned int x = 0; x < extra.size(); x++)
+    {
+        key += ((x > 0) ? "_" : "") + extra[x];
+    }
+    auto found = variants.find(key);
+    if (found != variants.end())
+    {
+        return found->second;
+    }
+    vector<string> all = defines;
+    all.insert(all.end(), extra.begin(), extra.end());
+    //! glastercube.bin becomes glastercube_NUM_DIFFUSE-1.bin and so on.
+    string base = shadername, extension;
+    size_t dot = base.rfind('.');
+    if (dot != string::npos)
+    {
+        extension = base.substr(dot);
+        base = base.substr(0, dot);
+    }
+    string name = base + "_" + key + extension;
+    replace(name.begin(), name.end(), ' ', '-');
+    cout << "\n\n\tCompiling shader variant " << name << ".\n\n";
+    Shader *item = new Shader();
+    item->startShader(vertexPath, fragmentPath, name, all);
+    variants[key] = item;
+    return item;
+}
+
+void Shader::setIntAll(const string name, int value)
+{
+    Use();
+    setInt(name, value);
+    for (auto &item : variants)
+    {
+        item.second->Use();
+        item.second->setInt(name, value);
+    }
+}
+
 void Shader::Use() 
 { 
     if (debug1)
     {
         cout << "\n\tShader " << shadername << " is being used.";
     }
+    finishShader();
     glUseProgram(Program); 
 }   
 
@@ -368,6 +445,7 @@ bool Shader::createBinary()
         << "\n\n";
         if (debug1)
         {
+            delete [] binary;
             return false;
         }
     }
@@ -376,17 +454,24 @@ bool Shader::createBinary()
     if (!shaderFile.is_open())
     {
         cout << "\n\n\tError opening file " << outputFile << ".\n\n";
+        delete [] binary;
         return false;
     }
-    for (int x = 0; x < progLenRet; x++)
-    { // Standard C I/O file writing loop.
-       shaderFile.put(binary[x]);
-    }
-    //shaderFile.close();
+    //! The key goes in front so a binary from other sources or
+    //! another driver is never handed back to glProgramBinary().
+    BinaryHeader header;
+    memcpy(header.magic, "ACSB", 4);
+    header.version = 1;
+    header.key = key;
+    header.format = format;
+    header.length = progLenRet;
+    shaderFile.write((const char*) &header, sizeof(header));
+    shaderFile.write((const char*) binary, progLenRet);
+    shaderFile.close();
     cout << "\n\n\tShader agregate binary program created "
     << "and saved.  The program has length " << progLenRet 
     << " bytes.\n\tAnd is saved at:  " << outputFile << ".\n\n";
-    free(binary);
+    delete [] binary;
     return true;
 }
     
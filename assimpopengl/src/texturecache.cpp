@@ -0,0 +1,113 @@
+/**********************************************************
+ *   TextureCache:  A class to share the textures made from
+ *   image files, reference counted and keyed by path and
+ *   sampler settings.
+ *   Created by: Edward Charles Eberle <eberdeed@eberdeed.net>
+ *   October 2026 San Diego, California USA
+ * ********************************************************/
+
+#include "../include/texturecache.h"
+
+TextureCache::TextureCache()
+{
+    cout << "\n\n\tCreating TextureCache.\n\n";
+}
+
+TextureCache::~TextureCache()
+{
+    cout << "\n\n\tDestroying TextureCache.\n\n";
+}
+
+TextureCache &TextureCache::shared()
+{
+    static TextureCache cache;
+    return cache;
+}
+
+string TextureCache::makeKey(vector<string> files, GLenum target, GLint wrap, GLint minFilter)
+{
+    string key;
+    for (unsigned int x = 0; x < files.size(); x++)
+    {
+        //! The same file reached by two paths is one texture.
+        boost::system::error_code error;
+        boost::filesystem::path full = canonical(boost::filesystem::path(files[x]), error);
+        key += ((error) ? files[x] : full.string()) + ";";
+    }
+    key += to_string(target) + ":" + to_string(wrap) + ":" + to_string(minFilter);
+    return key;
+}
+
+GLuint TextureCache::acquire(string key)
+{
+    auto found = entries.find(key);
+    if (found == entries.end())
+    {
+        misses++;
+        return 0;
+    }
+    hits++;
+    found->second.refs++;
+    found->second.uses++;
+    if (debug1)
+    {
+        cout << "\n\tTexture cache hit:  " << key << ".";
+    }
+    return found->second.id;
+}
+
+void TextureCache::insert(string key, GLuint textureID, long bytes)
+{
+    Entry entry;
+    entry.id = textureID;
+    entry.refs = entry.uses = 1;
+    entry.bytes = bytes;
+    entries[key] = entry;
+    keys[textureID] = key;
+    ResourceRegistry::shared().trackGL(ResourceRegistry::TEXTURE, textureID, "Textures", bytes);
+}
+
+void TextureCache::setBytes(GLuint textureID, long bytes)
+{
+    auto found = keys.find(textureID);
+    if (found != keys.end())
+    {
+        entries[found->second].bytes = bytes;
+        ResourceRegistry::shared().trackGL(ResourceRegistry::TEXTURE, textureID, "Textures", bytes);
+    }
+}
+
+bool TextureCache::release(GLuint textureID)
+{
+    auto found = keys.find(textureID);
+    if (found == keys.end())
+    {
+        glDeleteTextures(1, &textureID);
+        ResourceRegistry::shared().releaseGL(ResourceRegistry::TEXTURE, textureID);
+        return true;
+    }
+    Entry &entry = entries[found->second];
+    if (--entry.refs > 0)
+    {
+        return false;
+    }
+    glDeleteTextures(1, &textureID);
+    ResourceRegistry::shared().releaseGL(ResourceRegistry::TEXTURE, textureID);
+    entries.erase(found->second);
+    keys.erase(found);
+    return true;
+}
+
+void TextureCache::report()
+{
+    long resident = 0, saved = 0;
+    for (auto &item : entries)
+    {
+        resident += item.second.bytes;
+        //! Every use after the first would have been another copy.
+        saved += (long) (item.second.uses - 1) * item.second.bytes;
+    }
+    cout << "\n\n\tTexture cache:  " << entries.size() << " textures in "
+    << resident / 1024 << " KB, " << hits << " hits and " << misses
+    << " misses, " << saved / 1024 << " KB of video memory saved.\n\n";
+}
@@ -0,0 +1,602 @@
+/**********************************************************
+ *   TextureCompressor:  A class to turn decoded images into
+ *   ETC2 textures and keep them in a KTX file cache.
+ *   Created by: Edward Charles Eberle <eberdeed@eberdeed.net>
+ *   October 2026 San Diego, California USA
+ * ********************************************************/
+
+#include "../include/texturecompressor.h"
+#include "../include/createimage.h"
+#include "../include/assetpack.h"
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+bool TextureCompressor::enabled = true;
+bool TextureCompressor::debug1 = false;
+
+//! The ETC1 intensity modifiers, in selector order.
+static const int colorTables[8][4] = {
+    {2, 8, -2, -8}, {5, 17, -5, -17}, {9, 29, -9, -29}, {13, 42, -13, -42},
+    {18, 60, -18, -60}, {24, 80, -24, -80}, {33, 106, -33, -106}, {47, 183, -47, -183}
+};
+
+//! The EAC alpha modifiers.
+static const int alphaTables[16][8] = {
+    {-3, -6, -9, -15, 2, 5, 8, 14}, {-3, -7, -10, -13, 2, 6, 9, 12},
+    {-2, -5, -8, -13, 1, 4, 7, 12}, {-2, -4, -6, -13, 1, 3, 5, 12},
+    {-3, -6, -8, -12, 2, 5, 7, 11}, {-3, -7, -9, -11, 2, 6, 8, 10},
+    {-4, -7, -8, -11, 3, 6, 7, 10}, {-3, -5, -8, -11, 2, 4, 7, 10},
+    {-2, -6, -8, -10, 1, 5, 7, 9}, {-2, -5, -8, -10, 1, 4, 7, 9},
+    {-2, -4, -8, -10, 1, 3, 7, 9}, {-2, -5, -7, -10, 1, 4, 6, 9},
+    {-3, -4, -7, -10, 2, 3, 6, 9}, {-1, -2, -3, -10, 0, 1, 2, 9},
+    {-4, -6, -8, -9, 3, 5, 7, 8}, {-3, -5, -7, -9, 2, 4, 6, 8}
+};
+
+//! The KTX 1 file identifier.
+static const unsigned char ktxIdentifier[12] = {
+    0xAB, 'K', 'T', 'X', ' ', '1', '1', 0xBB, '\r', '\n', 0x1A, '\n'
+};
+
+//! The KTX 1 header after the identifier.
+struct KTXHeader {
+    uint32_t endianness, glType, glTypeSize, glFormat, glInternalFormat, glBaseInternalFormat;
+    uint32_t pixelWidth, pixelHeight, pixelDepth, numberOfArrayElements, numberOfFaces;
+    uint32_t numberOfMipmapLevels, bytesOfKeyValueData;
+};
+
+long CompressedImage::bytes()
+{
+    long total = 0;
+    for (unsigned int x = 0; x < levels.size(); x++)
+    {
+        total += levels[x].size();
+    }
+    return total;
+}
+
+bool TextureCompressor::load(vector<string> imagefiles, CompressedImage &texture)
+{
+    string path = cachePath(imagefiles);
+    if ((readKTX(path, texture)) && (texture.faces == (int) imagefiles.size()))
+    {
+        if (debug1)
+        {
+            cout << "\n\tCompressed texture from the cache:  " << path << ".";
+        }
+        return true;
+    }
+    vector<ImageData> images(imagefiles.size());
+    if (!CreateImage::decodeImages(imagefiles, images.data()))
+    {
+        return false;
+    }
+    vector<ImageData*> faces;
+    for (unsigned int x = 0; x < images.size(); x++)
+    {
+        if ((images[x].width != images[0].width) || (images[x].height != images[0].height))
+        {
+            cout << "\n\n\tThe images of " << imagefiles[0] << " are not all one size.\n\n";
+            return false;
+        }
+        faces.push_back(&images[x]);
+    }
+    chrono::steady_clock::time_point begin = chrono::steady_clock::now();
+    compress(faces, texture);
+    cout << "\n\n\tCompressed " << imagefiles[0] << " to "
+    << texture.bytes() / 1024 << " KB in "
+    << chrono::duration<float, milli>(chrono::steady_clock::now() - begin).count() << " ms.\n\n";
+    writeKTX(path, texture);
+    return true;
+}
+
+void TextureCompressor::compress(vector<ImageData*> images, CompressedImage &texture)
+{
+    texture.width = images[0]->width;
+    texture.height = images[0]->height;
+    texture.faces = images.size();
+    //! An opaque texture needs no alpha blocks.
+    bool opaque = true;
+    for (unsigned int f = 0; (f < images.size()) && (opaque); f++)
+    {
+        vector<unsigned char> &pixels = images[f]->pixels;
+        for (unsigned int x = 3; x < pixels.size(); x += 4)
+        {
+            if (pixels[x] != 255)
+            {
+                opaque = false;
+                break;
+            }
+        }
+    }
+    texture.format = (opaque) ? GL_COMPRESSED_RGB8_ETC2 : GL_COMPRESSED_RGBA8_ETC2_EAC;
+    int blockSize = (opaque) ? 8 : 16;
+    int levelCount = 1;
+    for (GLsizei size = std::max(texture.width, texture.height); size > 1; size /= 2)
+    {
+        levelCount++;
+    }
+    texture.levels.assign(levelCount, vector<unsigned char>());
+    for (unsigned int f = 0; f < images.size(); f++)
+    {
+        //! The level being compressed, always RGBA.
+        GLsizei width = texture.width, height = texture.height;
+        vector<unsigned char> level(images[f]->pixels);
+        if (images[f]->format == GL_BGRA_EXT)
+        {
+            for (unsigned int x = 0; x < level.size(); x += 4)
+            {
+                swap(level[x], level[x + 2]);
+            }
+        }
+        for (int l = 0; l < levelCount; l++)
+        {
+            int blocksWide = (width + 3) / 4, blocksHigh = (height + 3) / 4;
+            vector<unsigned char> &output = texture.levels[l];
+            size_t faceStart = output.size();
+            output.resize(faceStart + (size_t) blocksWide * blocksHigh * blockSize);
+            //! The block rows are split between threads.
+            auto encodeRows = [&](int first, int last)
+            {
+                unsigned char block[64];
+                for (int by = first; by < last; by++)
+                {
+                    for (int bx = 0; bx < blocksWide; bx++)
+                    {
+                        //! The edges of a level smaller than a block repeat.
+                        for (int y = 0; y < 4; y++)
+                        {
+                            for (int x = 0; x < 4; x++)
+                            {
+                                int sx = std::min(bx * 4 + x, width - 1);
+                                int sy = std::min(by * 4 + y, height - 1);
+                                memcpy(block + (y * 4 + x) * 4, level.data() + ((size_t) sy * width + sx) * 4, 4);
+                            }
+                        }
+                        unsigned char *target = output.data() + faceStart + ((size_t) by * blocksWide + bx) * blockSize;
+                        if (!opaque)
+                        {
+                            encodeAlpha(block, target);
+                            target += 8;
+                        }
+                        encodeColor(block, target);
+                    }
+                }
+            };
+            int threads = std::min(std::max(1, (int) thread::hardware_concurrency()), blocksHigh / 16);
+            if (threads < 2)
+            {
+                encodeRows(0, blocksHigh);
+            }
+            else
+            {
+                vector<thread> encoders;
+                for (int t = 0; t < threads; t++)
+                {
+                    encoders.push_back(thread(encodeRows, blocksHigh * t / threads, blocksHigh * (t + 1) / threads));
+                }
+                for (int t = 0; t < threads; t++)
+                {
+                    encoders[t].join();
+                }
+            }
+            if (l == levelCount - 1)
+            {
+                break;
+            }
+            //! The next level is a box filter of this one.
+            GLsizei nextWidth = std::max(1, width / 2), nextHeight = std::max(1, height / 2);
+            vector<unsigned char> next((size_t) nextWidth * nextHeight * 4);
+            for (int y = 0; y < nextHeight; y++)
+            {
+                for (int x = 0; x < nextWidth; x++)
+                {
+                    int x0 = std::min(x * 2, width - 1), x1 = std::min(x * 2 + 1, width - 1);
+                    int y0 = std::min(y * 2, height - 1), y1 = std::min(y * 2 + 1, height - 1);
+                    for (int c = 0; c < 4; c++)
+                    {
+                        int sum = level[((size_t) y0 * width + x0) * 4 + c] + level[((size_t) y0 * width + x1) * 4 + c]
+                        + level[((size_t) y1 * width + x0) * 4 + c] + level[((size_t) y1 * width + x1) * 4 + c];
+                        next[((size_t) y * nextWidth + x) * 4 + c] = (unsigned char) ((sum + 2) / 4);
+                    }
+                }
+            }
+            level.swap(next);
+            width = nextWidth;
+            height = nextHeight;
+        }
+    }
+}
+
+int TextureCompressor::fitHalf(const unsigned char block[64], const int pixels[8], const int base[3], int &table, int selectors[8])
+{
+    int bestError = numeric_limits<int>::max();
+    for (int t = 0; t < 8; t++)
+    {
+        int error = 0, choices[8];
+        for (int p = 0; p < 8; p++)
+        {
+            const unsigned char *pixel = block + pixels[p] * 4;
+            int pixelError = numeric_limits<int>::max();
+            for (int s = 0; s < 4; s++)
+            {
+                int sum = 0;
+                for (int c = 0; c < 3; c++)
+                {
+                    int diff = glm::clamp(base[c] + colorTables[t][s], 0, 255) - pixel[c];
+                    sum += diff * diff;
+                }
+                if (sum < pixelError)
+                {
+                    pixelError = sum;
+                    choices[p] = s;
+                }
+            }
+            error += pixelError;
+        }
+        if (error < bestError)
+        {
+            bestError = error;
+            table = t;
+            memcpy(selectors, choices, sizeof(choices));
+        }
+    }
+    return bestError;
+}
+
+void TextureCompressor::encodeColor(const unsigned char block[64], unsigned char *output)
+{
+    int bestError = numeric_limits<int>::max();
+    for (int flip = 0; flip < 2; flip++)
+    {
+        //! The pixels of each half, left and right or top and bottom.
+        int pixels[2][8], counts[2] = {0, 0};
+        float average[2][3] = {{0.0f, 0.0f, 0.0f}, {0.0f, 0.0f, 0.0f}};
+        for (int y = 0; y < 4; y++)
+        {
+            for (int x = 0; x < 4; x++)
+            {
+                int half = (flip) ? (y >> 1) : (x >> 1);
+                pixels[half][counts[half]++] = y * 4 + x;
+                for (int c = 0; c < 3; c++)
+                {
+                    average[half][c] += block[(y * 4 + x) * 4 + c] / 8.0f;
+                }
+            }
+        }
+        for (int differential = 0; differential < 2; differential++)
+        {
+            int quantized[2][3], base[2][3];
+            bool fits = true;
+            for (int h = 0; h < 2; h++)
+            {
+                for (int c = 0; c < 3; c++)
+                {
+                    if (differential)
+                    {
+                        quantized[h][c] = (int) roundf(average[h][c] * 31.0f / 255.0f);
+                        base[h][c] = (quantized[h][c] << 3) | (quantized[h][c] >> 2);
+                    }
+                    else
+                    {
+                        quantized[h][c] = (int) roundf(average[h][c] * 15.0f / 255.0f);
+                        base[h][c] = quantized[h][c] * 17;
+                    }
+                }
+            }
+            for (int c = 0; (c < 3) && (differential); c++)
+            {
+                int delta = quantized[1][c] - quantized[0][c];
+                fits = (fits) && (delta >= -4) && (delta <= 3);
+            }
+            if (!fits)
+            {
+                continue;
+            }
+            int tables[2], selectors[2][8];
+            int error = fitHalf(block, pixels[0], base[0], tables[0], selectors[0]);
+            if (error >= bestError)
+            {
+                continue;
+            }
+            error += fitHalf(block, pixels[1], base[1], tables[1], selectors[1]);
+            if (error >= bestError)
+            {
+                continue;
+            }
+            bestError = error;
+            //! The block is big endian, the base colors then the tables and flags.
+            for (int c = 0; c < 3; c++)
+            {
+                output[c] = (differential)
+                ? (unsigned char) ((quantized[0][c] << 3) | ((quantized[1][c] - quantized[0][c]) & 7))
+                : (unsigned char) ((quantized[0][c] << 4) | quantized[1][c]);
+            }
+            output[3] = (unsigned char) ((tables[0] << 5) | (tables[1] << 2) | (differential << 1) | flip);
+            //! The selectors go by column, high bits first.
+            unsigned int high = 0, low = 0;
+            for (int h = 0; h < 2; h++)
+            {
+                for (int p = 0; p < 8; p++)
+                {
+                    int index = (pixels[h][p] % 4) * 4 + pixels[h][p] / 4;
+                    high |= ((selectors[h][p] >> 1) & 1) << index;
+                    low |= (selectors[h][p] & 1) << index;
+                }
+            }
+            output[4] = (unsigned char) (high >> 8);
+            output[5] = (unsigned char) high;
+            output[6] = (unsigned char) (low >> 8);
+            output[7] = (unsigned char) low;
+        }
+    }
+}
+
+void TextureCompressor::encodeAlpha(const unsigned char block[64], unsigned char *output)
+{
+    int low = 255, high = 0;
+    for (int p = 0; p < 16; p++)
+    {
+        low = std::min(low, (int) block[p * 4 + 3]);
+        high = std::max(high, (int) block[p * 4 + 3]);
+    }
+    int bestError = numeric_limits<int>::max();
+    int bestBase = 0, bestMultiplier = 1, bestTable = 0;
+    int bestIndices[16] = {0};
+    for (int t = 0; (t < 16) && (bestError > 0); t++)
+    {
+        int spread = alphaTables[t][7] - alphaTables[t][3];
+        int estimate = (high - low + spread / 2) / spread;
+        for (int m = std::max(1, estimate - 1); m <= std::min(15, estimate + 1); m++)
+        {
+            //! The base puts the middle of the table at the middle of the alpha.
+            int base = glm::clamp((int) roundf((low + high) / 2.0f - (alphaTables[t][3] + alphaTables[t][7]) * m / 2.0f), 0, 255);
+            int error = 0, indices[16];
+            for (int p = 0; (p < 16) && (error < bestError); p++)
+            {
+                int pixelError = numeric_limits<int>::max();
+                for (int i = 0; i < 8; i++)
+                {
+                    int diff = glm::clamp(base + alphaTables[t][i] * m, 0, 255) - block[p * 4 + 3];
+                    if (diff * diff < pixelError)
+                    {
+                        pixelError = diff * diff;
+                        indices[p] = i;
+                    }
+                }
+                error += pixelError;
+            }
+            if (error < bestError)
+            {
+                bestError = error;
+                bestBase = base;
+                bestMultiplier = m;
+                bestTable = t;
+                memcpy(bestIndices, indices, sizeof(indices));
+            }
+        }
+    }
+    output[0] = (unsigned char) bestBase;
+    output[1] = (unsigned char) ((bestMultiplier << 4) | bestTable);
+    //! Sixteen three bit indices by column, the first in the highest bits.
+    uint64_t bits = 0;
+    for (int x = 0; x < 4; x++)
+    {
+        for (int y = 0; y < 4; y++)
+        {
+            bits = (bits << 3) | bestIndices[y * 4 + x];
+        }
+    }
+    for (int b = 0; b < 6; b++)
+    {
+        output[2 + b] = (unsigned char) (bits >> (40 - b * 8));
+    }
+}
+
+void TextureCompressor::upload(GLuint textureID, GLenum target, CompressedImage &texture)
+{
+    glBindTexture(target, textureID);
+    for (unsigned int l = 0; l < texture.levels.size(); l++)
+    {
+        GLsizei width = std::max(1, texture.width >> (texture.base + l)), height = std::max(1, texture.height >> (texture.base + l));
+        GLsizei faceSize = texture.levels[l].size() / texture.faces;
+        for (int f = 0; f < texture.faces; f++)
+        {
+            GLenum face = (target == GL_TEXTURE_CUBE_MAP) ? GL_TEXTURE_CUBE_MAP_POSITIVE_X + f : target;
+            glCompressedTexImage2D(face, l, texture.format, width, height, 0, faceSize, texture.levels[l].data() + f * faceSize);
+        }
+    }
+    GLint wrap = (target == GL_TEXTURE_CUBE_MAP) ? GL_CLAMP_TO_EDGE : GL_REPEAT;
+    glTexParameteri(target, GL_TEXTURE_WRAP_S, wrap);
+    glTexParameteri(target, GL_TEXTURE_WRAP_T, wrap);
+    if (target == GL_TEXTURE_CUBE_MAP)
+    {
+        glTexParameteri(target, GL_TEXTURE_WRAP_R, wrap);
+    }
+    glTexParameteri(target, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+    glTexParameteri(target, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glBindTexture(target, 0);
+}
+
+string TextureCompressor::cachePath(vector<string> imagefiles)
+{
+    //! FNV-1a over the format version and each file's path, size and time.
+    string keyText = "ETC2 1\n";
+    //! A texture decoded smaller is another texture, the full size keeps the old keys.
+    if ((CreateImage::decodeTier > 0) || (CreateImage::decodeLimit > 0))
+    {
+        keyText += "Decode " + to_string(CreateImage::decodeTier) + " " + to_string(CreateImage::decodeLimit) + "\n";
+    }
+    for (unsigned int x = 0; x < imagefiles.size(); x++)
+    {
+        //! A packed image is named by the hash of its contents.
+        uint64_t hash;
+        if (AssetPack::shared().contentHash(imagefiles[x], hash))
+        {
+            keyText += imagefiles[x] + '\0' + to_string(hash) + '\n';
+            continue;
+        }
+        boost::system::error_code error;
+        boost::filesystem::path file(imagefiles[x]);
+        boost::filesystem::path full = canonical(file, error);
+        keyText += ((error) ? imagefiles[x] : full.string()) + '\0';
+        uintmax_t size = file_size(file, error);
+        keyText += to_string((error) ? 0 : size) + '\0';
+        time_t changed = last_write_time(file, error);
+        keyText += to_string((error) ? 0 : changed) + '\n';
+    }
+    uint64_t key = 14695981039346656037ull;
+    for (unsigned int x = 0; x < keyText.size(); x++)
+    {
+        key = (key ^ (unsigned char) keyText[x]) * 1099511628211ull;
+    }
+    stringstream name;
+    name << hex << setw(16) << setfill('0') << key;
+    string home = getenv("HOME");
+    return home + "/.config/textures/" + name.str() + ".ktx";
+}
+
+bool TextureCompressor::writeKTX(string path, CompressedImage &texture)
+{
+    boost::system::error_code error;
+    create_directories(boost::filesystem::path(path).parent_path(), error);
+    //! Write to the side and rename, so a loader never reads half a file.
+    string partial = path + "." + to_string(getpid()) + "." + to_string(hash<thread::id>()(this_thread::get_id()));
+    boost::filesystem::ofstream output(partial, ios_base::out | ios_base::binary);
+    if (!output.is_open())
+    {
+        cout << "\n\n\tError opening texture cache file " << partial << ".\n\n";
+        return false;
+    }
+    KTXHeader header;
+    header.endianness = 0x04030201;
+    header.glType = header.glFormat = 0;
+    header.glTypeSize = 1;
+    header.glInternalFormat = texture.format;
+    header.glBaseInternalFormat = (texture.format == GL_COMPRESSED_RGB8_ETC2) ? GL_RGB : GL_RGBA;
+    header.pixelWidth = texture.width;
+    header.pixelHeight = texture.height;
+    header.pixelDepth = header.numberOfArrayElements = 0;
+    header.numberOfFaces = texture.faces;
+    header.numberOfMipmapLevels = texture.levels.size();
+    header.bytesOfKeyValueData = 0;
+    output.write((const char*) ktxIdentifier, sizeof(ktxIdentifier));
+    output.write((const char*) &header, sizeof(header));
+    for (unsigned int l = 0; l < texture.levels.size(); l++)
+    {
+        //! The size is of one face, and the blocks keep everything four byte aligned.
+        uint32_t imageSize = texture.levels[l].size() / texture.faces;
+        output.write((const char*) &imageSize, sizeof(imageSize));
+        output.write((const char*) texture.levels[l].data(), texture.levels[l].size());
+    }
+    output.close();
+    if (output.fail())
+    {
+        cout << "\n\n\tError writing texture cache file " << partial << ".\n\n";
+        remove(boost::filesystem::path(partial), error);
+        return false;
+    }
+    rename(boost::filesystem::path(partial), boost::filesystem::path(path), error);
+    return !error;
+}
+
+bool TextureCompressor::readKTX(string path, CompressedImage &texture, GLsizei want)
+{
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0)
+    {
+        return false;
+    }
+    struct stat info;
+    size_t headerSize = sizeof(ktxIdentifier) + sizeof(KTXHeader);
+    if ((fstat(fd, &info) != 0) || (info.st_size < (off_t) headerSize))
+    {
+        close(fd);
+        return false;
+    }
+    size_t fileSize = info.st_size;
+    void *mapped = mmap(nullptr, fileSize, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (mapped == MAP_FAILED)
+    {
+        cout << "\n\n\tError mapping file " << path << ".\n\n";
+        return false;
+    }
+    const unsigned char *data = (const unsigned char*) mapped;
+    KTXHeader header;
+    memcpy(&header, data + sizeof(ktxIdentifier), sizeof(header));
+    bool response = (memcmp(data, ktxIdentifier, sizeof(ktxIdentifier)) == 0)
+    && (header.endianness == 0x04030201)
+    && ((header.glInternalFormat == GL_COMPRESSED_RGB8_ETC2) || (header.glInternalFormat == GL_COMPRESSED_RGBA8_ETC2_EAC))
+    && ((header.numberOfFaces == 1) || (header.numberOfFaces == 6))
+    && (header.pixelWidth > 0) && (header.pixelHeight > 0)
+    && (header.pixelWidth <= 65536) && (header.pixelHeight <= 65536)
+    && (header.numberOfMipmapLevels > 0) && (header.numberOfMipmapLevels <= 32);
+    //! No more levels than halving the size down to one texel makes.
+    unsigned int most = 1;
+    for (uint32_t size = std::max(header.pixelWidth, header.pixelHeight); size > 1; size /= 2)
+    {
+        most++;
+    }
+    response = (response) && (header.numberOfMipmapLevels <= most);
+    size_t offset = headerSize + header.bytesOfKeyValueData;
+    //! The first level no larger than wanted, the file is only read from there.
+    int base = 0;
+    while ((want > 0) && (base < (int) header.numberOfMipmapLevels - 1)
+        && ((std::max(header.pixelWidth, header.pixelHeight) >> (base + 1)) >= (uint32_t) want))
+    {
+        base++;
+    }
+    if (response)
+    {
+        texture.format = header.glInternalFormat;
+        texture.width = header.pixelWidth;
+        texture.height = header.pixelHeight;
+        texture.faces = header.numberOfFaces;
+        texture.base = base;
+        texture.levels.assign(header.numberOfMipmapLevels - base, vector<unsigned char>());
+    }
+    for (unsigned int l = 0; (response) && (l < header.numberOfMipmapLevels); l++)
+    {
+        uint32_t imageSize;
+        if (offset + sizeof(imageSize) > fileSize)
+        {
+            response = false;
+            break;
+        }
+        memcpy(&imageSize, data + offset, sizeof(imageSize));
+        offset += sizeof(imageSize);
+        //! The size given must be that of the blocks of the level.
+        GLsizei width = std::max(1u, header.pixelWidth >> l), height = std::max(1u, header.pixelHeight >> l);
+        if (imageSize != TextureCompressor::levelSize(texture.format, width, height))
+        {
+            response = false;
+            break;
+        }
+        size_t levelSize = (size_t) imageSize * texture.faces;
+        if (offset + levelSize > fileSize)
+        {
+            response = false;
+            break;
+        }
+        //! A finer level is stepped over by its size, its pages are never touched.
+        if ((int) l >= base)
+        {
+            texture.levels[l - base].assign(data + offset, data + offset + levelSize);
+        }
+        offset += levelSize;
+    }
+    munmap(mapped, fileSize);
+    if (!response)
+    {
+        cout << "\n\tThe texture cache file:  " << path << " is not a usable KTX file.\n";
+    }
+    return response;
+}
+
+long TextureCompressor::levelSize(GLenum format, GLsizei width, GLsizei height)
+{
+    int blockSize = (format == GL_COMPRESSED_RGB8_ETC2) ? 8 : 16;
+    return (long) ((width + 3) / 4) * ((height + 3) / 4) * blockSize;
+}
@@ -0,0 +1,371 @@
+/**********************************************************
+ *   TextureStreamer:  A class to keep the textures of the
+ *   models within a video memory budget, by the levels
+ *   their instances show on screen.
+ *   Created by: Edward Charles Eberle <eberdeed@eberdeed.net>
+ *   October 2026 San Diego, California USA
+ * ********************************************************/
+
+#include "../include/texturestreamer.h"
+#include "../include/createimage.h"
+
+TextureStreamer::TextureStreamer()
+{
+    cout << "\n\n\tCreating TextureStreamer.\n\n";
+}
+
+TextureStreamer::~TextureStreamer()
+{
+    cout << "\n\n\tDestroying TextureStreamer.\n\n";
+}
+
+TextureStreamer &TextureStreamer::shared()
+{
+    static TextureStreamer streamer;
+    return streamer;
+}
+
+void TextureStreamer::add(GLuint textureID, string imagefile)
+{
+    Entry entry;
+    entry.file = imagefile;
+    entry.serial = ++serials;
+    entries[textureID] = entry;
+}
+
+void TextureStreamer::remove(GLuint textureID)
+{
+    auto found = entries.find(textureID);
+    if (found == entries.end())
+    {
+        return;
+    }
+    //! A read still running finds no entry and is thrown away.
+    Entry &entry = found->second;
+    if ((entry.pending >= 0) && ((entry.base < 0) || (entry.pending < entry.base)))
+    {
+        loading--;
+    }
+    entries.erase(found);
+}
+
+void TextureStreamer::request(GLuint textureID, float size)
+{
+    auto found = entries.find(textureID);
+    if ((found == entries.end()) || (size <= 0.0f))
+    {
+        return;
+    }
+    //! The largest instance of the frame decides.
+    Entry &entry = found->second;
+    if (entry.seen != frame)
+    {
+        entry.need = 0.0f;
+        entry.seen = frame;
+    }
+    entry.need = std::max(entry.need, size);
+}
+
+void TextureStreamer::prefetch(GLuint textureID, GLsizei pixels)
+{
+    auto found = entries.find(textureID);
+    if ((!enabled) || (found == entries.end()) || (found->second.pending >= 0) || (found->second.file.empty()))
+    {
+        return;
+    }
+    Entry &entry = found->second;
+    GLsizei want = (GLsizei) (pixels * detail);
+    if ((entry.base >= 0) && ((std::max(entry.width, entry.height) >> entry.base) >= want))
+    {
+        return;
+    }
+    Levels levels;
+    levels.loaded = read(entry.file, want, levels);
+    //! As a finer read, so finish() counts it done.
+    entry.pending = (entry.base < 0) ? 0 : entry.base - 1;
+    loading++;
+    loads++;
+    finish(textureID, entry.serial, levels);
+}
+
+void TextureStreamer::setBudget(long bytes)
+{
+    budget = std::max(bytes, 0L);
+    enabled = true;
+    cout << "\n\n\tStreaming textures within " << budget / 1024 << " KB.\n\n";
+}
+
+long TextureStreamer::bytesFrom(const vector<long> &levelBytes, int level)
+{
+    long total = 0;
+    for (unsigned int x = std::max(level, 0); x < levelBytes.size(); x++)
+    {
+        total += levelBytes[x];
+    }
+    return total;
+}
+
+int TextureStreamer::chooseLevel(Entry &entry)
+{
+    int last = entry.levelBytes.size() - 1;
+    GLsizei largest = std::max(entry.width, entry.height);
+    //! An unseen texture keeps only its coarse levels.
+    GLsizei want = (GLsizei) entry.need;
+    if ((entry.seen < 0) || (frame - entry.seen > idleFrames))
+    {
+        want = idleSize;
+    }
+    int level = 0;
+    while ((level < last) && ((largest >> (level + 1)) >= want))
+    {
+        level++;
+    }
+    return level;
+}
+
+void TextureStreamer::update(AssetLoader *loader)
+{
+    if (!enabled)
+    {
+        return;
+    }
+    //! The projected sizes are of half the viewport height.
+    GLint viewport[4];
+    glGetIntegerv(GL_VIEWPORT, viewport);
+    long total = 0;
+    for (auto &item : entries)
+    {
+        Entry &entry = item.second;
+        if (entry.seen == frame)
+        {
+            entry.need *= viewport[3] * detail;
+        }
+        entry.pressed = false;
+        if (entry.levelBytes.size() == 0)
+        {
+            continue;
+        }
+        entry.target = chooseLevel(entry);
+        //! A texture a level finer than it needs is left, so a size near a power of two does not read it over and over.
+        if (entry.target == entry.base + 1)
+        {
+            entry.target = entry.base;
+        }
+        total += bytesFrom(entry.levelBytes, entry.target);
+    }
+    //! Over budget, the levels showing the fewest pixels for their texels go first.
+    while (total > budget)
+    {
+        Entry *worst = nullptr;
+        float worstScore = 0.0f;
+        for (auto &item : entries)
+        {
+            Entry &entry = item.second;
+            if ((entry.levelBytes.size() == 0) || (entry.target >= (int) entry.levelBytes.size() - 1))
+            {
+                continue;
+            }
+            GLsizei largest = std::max(entry.width, entry.height) >> entry.target;
+            //! The longest unseen first, then the most texels for each pixel.
+            float score = (float) largest / std::max(entry.need, 1.0f);
+            if ((entry.seen < frame) && (entry.seen >= 0))
+            {
+                score = 1e9f + (float) (frame - entry.seen);
+            }
+            if ((worst == nullptr) || (score > worstScore))
+            {
+                worst = &entry;
+                worstScore = score;
+            }
+        }
+        if (worst == nullptr)
+        {
+            break;
+        }
+        total -= worst->levelBytes[worst->target];
+        worst->target++;
+        worst->pressed = true;
+    }
+    for (auto &item : entries)
+    {
+        GLuint textureID = item.first;
+        Entry &entry = item.second;
+        if (entry.pending >= 0)
+        {
+            continue;
+        }
+        GLsizei want;
+        if (entry.levelBytes.size() == 0)
+        {
+            //! The first read finds the size, the level is chosen from the request alone.
+            if ((entry.seen != frame) || (loading >= maxLoads))
+            {
+                continue;
+            }
+            want = (GLsizei) entry.need;
+            entry.pending = 0;
+            loading++;
+            loads++;
+        }
+        else
+        {
+            if ((entry.target == entry.base) || ((entry.target < entry.base) && (loading >= maxLoads)))
+            {
+                continue;
+            }
+            want = std::max(1, std::max(entry.width, entry.height) >> entry.target);
+            entry.pending = entry.target;
+            if (entry.target < entry.base)
+            {
+                loading++;
+                loads++;
+            }
+            else
+            {
+                drops++;
+            }
+        }
+        if (debug1)
+        {
+            cout << "\n\tStreaming " << entry.file << " from level " << entry.base
+            << " to " << entry.pending << ((entry.pressed) ? " over budget." : ".");
+        }
+        string file = entry.file;
+        int serial = entry.serial;
+        AssetLoader::Job job = [textureID, serial, file, want]() -> AssetLoader::Upload
+        {
+            shared_ptr<Levels> levels = make_shared<Levels>();
+            levels->loaded = read(file, want, *levels);
+            return [textureID, serial, levels]()
+            {
+                TextureStreamer::shared().finish(textureID, serial, *levels);
+            };
+        };
+        if (loader != nullptr)
+        {
+            loader->submit(file, job);
+        }
+        else
+        {
+            job()();
+        }
+    }
+    frame++;
+}
+
+bool TextureStreamer::read(string file, GLsizei want, Levels &levels)
+{
+    if (TextureCompressor::enabled)
+    {
+        CompressedImage &texture = levels.compressed;
+        //! Only the levels wanted are read from the cache, a texture not yet
+        //! compressed is made whole the first time.
+        if ((!TextureCompressor::readKTX(TextureCompressor::cachePath({file}), texture, want))
+            && (!TextureCompressor::load({file}, texture)))
+        {
+            return false;
+        }
+        levels.width = texture.width;
+        levels.height = texture.height;
+        int levelCount = texture.base + texture.levels.size();
+        for (int x = 0; x < levelCount; x++)
+        {
+            levels.levelBytes.push_back(TextureCompressor::levelSize(texture.format,
+                std::max(1, texture.width >> x), std::max(1, texture.height >> x)) * texture.faces);
+        }
+        levels.base = texture.base;
+        while ((levels.base < levelCount - 1) && ((std::max(levels.width, levels.height) >> (levels.base + 1)) >= want))
+        {
+            levels.base++;
+        }
+        texture.levels.erase(texture.levels.begin(), texture.levels.begin() + (levels.base - texture.base));
+        texture.base = levels.base;
+        return true;
+    }
+    levels.image = make_shared<ImageData>();
+    ImageData &image = *levels.image;
+    if (!CreateImage::decodeImage(file, image))
+    {
+        return false;
+    }
+    levels.width = image.width;
+    levels.height = image.height;
+    for (GLsizei width = image.width, height = image.height; ; width = std::max(1, width / 2), height = std::max(1, height / 2))
+    {
+        levels.levelBytes.push_back((long) width * height * 4);
+        if ((width == 1) && (height == 1))
+        {
+            break;
+        }
+    }
+    //! The finer levels are never uploaded, so they are boxed down here.
+    while ((levels.base < (int) levels.levelBytes.size() - 1) && ((std::max(image.width, image.height) / 2) >= want))
+    {
+        CreateImage::halveImage(image);
+        levels.base++;
+    }
+    return true;
+}
+
+void TextureStreamer::finish(GLuint textureID, int serial, Levels &levels)
+{
+    auto found = entries.find(textureID);
+    if ((found == entries.end()) || (found->second.serial != serial))
+    {
+        return;
+    }
+    Entry &entry = found->second;
+    if ((entry.base < 0) || (entry.pending < entry.base))
+    {
+        loading--;
+    }
+    entry.pending = -1;
+    if (!levels.loaded)
+    {
+        cout << "\n\n\tError:  The streamed texture " << entry.file << " will not load.\n\n";
+        //! Left as the placeholder, and not read again.
+        entry.file.clear();
+        entry.levelBytes.assign(1, 0);
+        entry.base = 0;
+        return;
+    }
+    bool compressed = (levels.image == nullptr);
+    int count = (compressed) ? levels.compressed.levels.size() : levels.levelBytes.size() - levels.base;
+    //! The range sampled is set first, as glGenerateMipmap() stops at it, and
+    //! the levels left from a finer texture are emptied.
+    glBindTexture(GL_TEXTURE_2D, textureID);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, count - 1);
+    for (int x = count; x < entry.count; x++)
+    {
+        glTexImage2D(GL_TEXTURE_2D, x, GL_RGBA, 0, 0, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+    }
+    glBindTexture(GL_TEXTURE_2D, 0);
+    if (compressed)
+    {
+        TextureCompressor::upload(textureID, GL_TEXTURE_2D, levels.compressed);
+    }
+    else
+    {
+        CreateImage::uploadTexture(textureID, *levels.image);
+    }
+    entry.width = levels.width;
+    entry.height = levels.height;
+    entry.levelBytes = levels.levelBytes;
+    entry.base = levels.base;
+    entry.count = count;
+    TextureCache::shared().setBytes(textureID, bytesFrom(entry.levelBytes, entry.base));
+}
+
+void TextureStreamer::report()
+{
+    long resident = 0, full = 0;
+    for (auto &item : entries)
+    {
+        resident += bytesFrom(item.second.levelBytes, item.second.base);
+        full += bytesFrom(item.second.levelBytes, 0);
+    }
+    cout << "\n\n\tTexture streamer:  " << entries.size() << " textures in "
+    << resident / 1024 << " KB of a " << budget / 1024 << " KB budget, "
+    << full / 1024 << " KB at full size, " << loads << " loads and "
+    << drops << " drops.\n\n";
+}
@@ -0,0 +1,184 @@
+/**********************************************************
+ *   VertexQuantizer:  A class to compress the Vertex and
+ *   Vertex1 arrays of a mesh into the VertexPacked and
+ *   Vertex1Packed layouts.
+ *   Created by: Edward Charles Eberle <eberdeed@eberdeed.net>
+ *   October 2026 San Diego, California USA
+ * ********************************************************/
+
+#include "../include/vertexquantizer.h"
+#include "../include/assimpopengl.h"
+
+VertexQuantizer::VertexQuantizer()
+{
+    cout << "\n\n\tCreating VertexQuantizer.\n\n";
+}
+
+VertexQuantizer::~VertexQuantizer()
+{
+    cout << "\n\n\tDestroying VertexQuantizer.\n\n";
+}
+
+void VertexQuantizer::bounds(const float *data, int count, int stride, int width, float *low, float *high)
+{
+    for (int y = 0; y < width; y++)
+    {
+        low[y] = high[y] = data[y];
+    }
+    for (int x = 1; x < count; x++)
+    {
+        for (int y = 0; y < width; y++)
+        {
+            float value = data[x * stride + y];
+            low[y] = std::min(low[y], value);
+            high[y] = std::max(high[y], value);
+        }
+    }
+}
+
+bool VertexQuantizer::validNormals(const float *data, int count, int stride)
+{
+    for (int x = 0; x < count; x++)
+    {
+        const float *normal = &data[x * stride];
+        float len = normal[0] * normal[0] + normal[1] * normal[1] + normal[2] * normal[2];
+        //! Degenerate faces can leave zero or NaN normals from aiProcess_GenNormals.
+        if (!(len > 0.0001f))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool VertexQuantizer::canPack(Vertex *vertices, int vertSize)
+{
+    float low[3], high[3], extent = 0.0f;
+    const int stride = sizeof(Vertex) / sizeof(float);
+    if (vertSize < 1)
+    {
+        return false;
+    }
+    bounds(vertices[0].Position, vertSize, stride, 3, low, high);
+    for (int y = 0; y < 3; y++)
+    {
+        extent = std::max(extent, high[y] - low[y]);
+    }
+    if ((extent / 65535.0f) > positionTolerance)
+    {
+        return false;
+    }
+    bounds(vertices[0].TexCoords, vertSize, stride, 2, low, high);
+    for (int y = 0; y < 2; y++)
+    {
+        if (!(((high[y] - low[y]) / 65535.0f) <= texTolerance))
+        {
+            return false;
+        }
+    }
+    return validNormals(vertices[0].Normal, vertSize, stride);
+}
+
+bool VertexQuantizer::canPack(Vertex1 *vertices, int vertSize)
+{
+    float low[3], high[3], extent = 0.0f;
+    const int stride = sizeof(Vertex1) / sizeof(float);
+    if (vertSize < 1)
+    {
+        return false;
+    }
+    bounds(vertices[0].Position, vertSize, stride, 3, low, high);
+    for (int y = 0; y < 3; y++)
+    {
+        extent = std::max(extent, high[y] - low[y]);
+    }
+    if ((extent / 65535.0f) > positionTolerance)
+    {
+        return false;
+    }
+    return validNormals(vertices[0].Normal, vertSize, stride);
+}
+
+unsigned short VertexQuantizer::unorm16(float value, float low, float range)
+{
+    if (range <= 0.0f)
+    {
+        return 0;
+    }
+    return (unsigned short) (glm::clamp((value - low) / range, 0.0f, 1.0f) * 65535.0f + 0.5f);
+}
+
+void VertexQuantizer::octEncode(const float *normal, short *encoded)
+{
+    float sum = fabsf(normal[0]) + fabsf(normal[1]) + fabsf(normal[2]);
+    float x = normal[0] / sum;
+    float y = normal[1] / sum;
+    //! Fold the lower hemisphere over the diagonals.
+    if (normal[2] < 0.0f)
+    {
+        float tmp = x;
+        x = (1.0f - fabsf(y)) * (tmp >= 0.0f ? 1.0f : -1.0f);
+        y = (1.0f - fabsf(tmp)) * (y >= 0.0f ? 1.0f : -1.0f);
+    }
+    encoded[0] = (short) roundf(glm::clamp(x, -1.0f, 1.0f) * 32767.0f);
+    encoded[1] = (short) roundf(glm::clamp(y, -1.0f, 1.0f) * 32767.0f);
+}
+
+VertexPacked *VertexQuantizer::pack(Vertex *vertices, int vertSize, Mesh *mesh)
+{
+    float low[3], high[3], uvLow[2], uvHigh[2];
+    const int stride = sizeof(Vertex) / sizeof(float);
+    bounds(vertices[0].Position, vertSize, stride, 3, low, high);
+    bounds(vertices[0].TexCoords, vertSize, stride, 2, uvLow, uvHigh);
+    mesh->posOffset = vec3(low[0], low[1], low[2]);
+    mesh->posScale = vec3(high[0] - low[0], high[1] - low[1], high[2] - low[2]);
+    mesh->uvOffset = vec2(uvLow[0], uvLow[1]);
+    mesh->uvScale = vec2(uvHigh[0] - uvLow[0], uvHigh[1] - uvLow[1]);
+    mesh->packed = true;
+    VertexPacked *packed = new VertexPacked[vertSize];
+    for (int x = 0; x < vertSize; x++)
+    {
+        for (int y = 0; y < 3; y++)
+        {
+            packed[x].Position[y] = unorm16(vertices[x].Position[y], low[y], mesh->posScale[y]);
+        }
+        packed[x].Position[3] = 0;
+        octEncode(vertices[x].Normal, packed[x].Normal);
+        for (int y = 0; y < 2; y++)
+        {
+            packed[x].TexCoords[y] = unorm16(vertices[x].TexCoords[y], uvLow[y], mesh->uvScale[y]);
+        }
+    }
+    if (debug1)
+    {
+        cout << "\n\tPacked " << vertSize << " textured vertices from " << sizeof(Vertex)
+        << " to " << sizeof(VertexPacked) << " bytes each.";
+    }
+    return packed;
+}
+
+Vertex1Packed *VertexQuantizer::pack(Vertex1 *vertices, int vertSize, Mesh *mesh)
+{
+    float low[3], high[3];
+    const int stride = sizeof(Vertex1) / sizeof(float);
+    bounds(vertices[0].Position, vertSize, stride, 3, low, high);
+    mesh->posOffset = vec3(low[0], low[1], low[2]);
+    mesh->posScale = vec3(high[0] - low[0], high[1] - low[1], high[2] - low[2]);
+    mesh->packed = true;
+    Vertex1Packed *packed = new Vertex1Packed[vertSize];
+    for (int x = 0; x < vertSize; x++)
+    {
+        for (int y = 0; y < 3; y++)
+        {
+            packed[x].Position[y] = unorm16(vertices[x].Position[y], low[y], mesh->posScale[y]);
+        }
+        packed[x].Position[3] = 0;
+        octEncode(vertices[x].Normal, packed[x].Normal);
+    }
+    if (debug1)
+    {
+        cout << "\n\tPacked " << vertSize << " untextured vertices from " << sizeof(Vertex1)
+        << " to " << sizeof(Vertex1Packed) << " bytes each.";
+    }
+    return packed;
+}
@@ -62,6 +62,18 @@ private:
     /** \brief Display error messages.
      */
     void logSDLError(ostream &os, const string &msg);
+    /** \brief Draw the skybox and the objects in the order of the
+     *  pass ordering mode.  With skyLast the opaque objects are drawn
+     *  first, nearest first, then the skybox at the far plane, then
+     *  anything blended.
+     */
+    void drawScene(bool skyLast);
+#ifndef NDEBUG
+    /** \brief Draw the frame in both pass orders into the overdraw
+     *  counter and report the fragments shaded by each.
+     */
+    void measureOverdraw();
+#endif
 
     //! Settings
     const unsigned int SCR_WIDTH = 1000;
@@ -83,6 +95,25 @@ private:
     Terrain *terrain;
     //! The blender objects.
     Objects *objects;
+    //! Holds the frame time to the budget with resolution and detail.
+    FrameGovernor *governor;
+    //! The frame time budget in milliseconds.
+    float frameBudget = 1000.0f / 60.0f;
+    //! Loads the sky box and the asteroids in the background.
+    AssetLoader *loader;
+    //! The milliseconds of each frame given to uploading loaded assets.
+    float loadBudget = 4.0f;
+    //! The video memory the asteroid textures are streamed within.
+    long textureBudget = 32L * 1024 * 1024;
+    /** The size the images are decoded at, 1 to 3 for 1/2 to 1/8 on small
+     *  hosts, -1 to fit the textures of the budget, 0 for the full size.
+     */
+    int decodeTier = 0;
+    //! The textures sharing the budget when the decode size is fitted to it.
+    int budgetTextures = 8;
+    //! The asset pack made by astercubepack, and the directory it was made from.
+    string packFile = "/usr/share/openglresources/astercube.pack";
+    string resourceRoot = "/usr/share/openglresources";
     // SDL window variables.
     SDL_Window *window;
     SDL_Renderer *renderer;
@@ -93,6 +124,19 @@ private:
     bool test = false;
     bool altSet = false;
     bool debug1 = false;
+    //! The pass ordering mode, the skybox after the objects by default.
+    bool skyboxLast = true;
+    //! The depth pre-pass of the asteroids, off by default.
+    bool depthPrepass = false;
+#ifndef NDEBUG
+    //! The overdraw counter and its resolve shader, debug builds only.
+    OverdrawCounter *overdraw;
+    Shader *overdrawShader;
+    //! Measure the overdraw of the next frame.
+    bool measureNext = false;
+    string overdrawVertexShader = "/usr/share/openglresources/shaders/overdraw.vs";
+    string overdrawFragmentShader = "/usr/share/openglresources/shaders/overdraw.frag";
+#endif
     //! The sky box sampler cube.
     unsigned int skyboxTex;
     int amount;
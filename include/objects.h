@@ -62,8 +62,14 @@ public:
     void printVec3(vec3 vecVal);
     //! \breif Print a 4x4 float matrix.
     void printMat4(mat4 matVal);
-    //! \brief Initialize all the objects.
-    void initObjects();
+    /** \brief Initialize all the objects.
+     * loader : Load the asteroids in the background, see Model.
+     */
+    void initObjects(AssetLoader *loader = nullptr);
+    /** \brief Capture the impostors of the asteroids, once they and
+     *  their textures are resident.  Only the first call does anything.
+     */
+    void buildImpostors();
     //! \brief Calculate one's position.
     void calcPosition(mat4 model, int amount);
     //! \breif Blender model info.
@@ -76,6 +82,12 @@ public:
     /** \brief Draw the objects on the  screen.
      */
     void drawObjects(mat4 model, mat4 view, mat4 projection, vec3 viewPos);
+    /** \brief Switch the depth pre-pass of the asteroids on or off.
+     */
+    void setDepthPrepass(bool enabled);
+    /** \brief Pass the detail settings of the frame governor to the asteroids.
+     */
+    void setQuality(float lodBias, float impostorScale);
     /** \brief Get a normalized direction from two points.
      */
     vec3 getDirection(vec3 viewer, vec3 viewed);
@@ -90,11 +102,15 @@ public:
     const float pi180 = acos(-1.0f);
     const float pi90 = acos(-1.0f) / 2.0f;
     //! The shader to display the objects.
-    Shader *shader;
+    Shader *shader = nullptr;
+    //! The shader to display distant objects as impostors.
+    Shader *impostorShader = nullptr;
+    //! The depth only shader of the pre-pass.
+    Shader *depthShader = nullptr;
     //! The pointer to the skybox sampler cube.
     unsigned int skyboxTex;
     //! The asteroid location data isolated.
-    float *instanceData;
+    float *instanceData = nullptr;
     //! Affine matrix location for each instance of a particular asteroid.
     vector<mat4>modelData;
     //! The scale variable.
@@ -119,6 +135,8 @@ public:
     vec3 viewPos, transvec, velocity;
     //! Object pointer for creation and drawing in OpenGL.
     Model *figure;
+    //! Whether the impostors have been captured.
+    bool impostorsBuilt = false;
      /** \brief A structure to contain the bulk of the
      *  configuration and mesh information for the given
      *  blender objects. See the info.h file for more information.
@@ -139,6 +157,10 @@ public:
     //! Shader locations.
     string vertexShader = "/usr/share/openglresources/shaders/test.vs";
     string fragmentShader = "/usr/share/openglresources/shaders/test.frag";
+    string impostorVertexShader = "/usr/share/openglresources/shaders/impostor.vs";
+    string impostorFragmentShader = "/usr/share/openglresources/shaders/impostor.frag";
+    string depthVertexShader = "/usr/share/openglresources/shaders/depthonly.vs";
+    string depthFragmentShader = "/usr/share/openglresources/shaders/depthonly.frag";
     //! Debug flag.
     bool debug1 = false;
 };
@@ -12,6 +12,7 @@
 //! Using components from the assimpopengl library.
 #include "../assimpopengl/include/createimage.h"
 #include "../assimpopengl/include/shader.h"
+#include "../assimpopengl/include/assetloader.h"
 #include "asterobject.h"
 
 /** \class SkyBox  Display a skybox for a given scene.
@@ -29,12 +30,15 @@ public:
     /** \brief Create the vertex array and assign
      * it to an OpenGl buffer as well as creating
      * the sampler cube.
+     * loader : Decode the images in the background, drawing a
+     * plain sky until they are in.  Without one they load here.
      */
-    void initSkyBox();
+    void initSkyBox(AssetLoader *loader = nullptr);
     /** \brief Set the overall size of the skybox.
      */
     void setScale(float value);
-    /** \brief Draw the skybox.
+    /** \brief Draw the skybox on the far plane with GL_LEQUAL, so it
+     *  can be drawn before or after the objects in front of it.
      */
     void drawSkyBox(mat4 model, mat4 view, mat4 projection);
     /** \brief display the vertex values for the skybox.
@@ -46,11 +50,11 @@ public:
     //! Pointer to the image handling class.
     CreateImage *image;
     //! Pointer to the cube creating class.
-    AsterObject *cuby;
+    AsterObject *cuby = nullptr;
     //! Pointer to the shader.
     Shader *skyboxShader;
     //! Pointer to the cube matrix.
-    float *skycube;
+    float *skycube = nullptr;
     //! Overall size.
     float size;
     //! Texture and buffer pointers.
@@ -0,0 +1,19 @@
+/**********************************************************
+ *   depthonly.frag:  A shader for the depth pre-pass.  The
+ *   color writes are masked off, only the depth is kept.
+ *   Created by: Edward Charles Eberle <eberdeed@eberdeed.net>
+ *   October 2026 San Diego, California USA
+ * ********************************************************/ 
+/** \class depthonly.frag
+  *  Fragment shader.
+  */
+#version 300 es
+
+precision highp float;
+
+out vec4 color;
+
+void main()
+{
+    color = vec4(0.0);
+}
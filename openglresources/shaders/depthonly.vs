@@ -0,0 +1,47 @@
+/**********************************************************
+ *   depthonly.vs:  A shader to write the depth of instanced
+ *   objects before they are shaded.  It reads only the
+ *   position stream and must place each vertex exactly where
+ *   test.vs does, so both declare gl_Position invariant and
+ *   use the same expression.
+ *   Created by: Edward Charles Eberle <eberdeed@eberdeed.net>
+ *   October 2026 San Diego, California USA
+ * ********************************************************/ 
+/** \class depthonly.vs
+  *  Vertex shader.
+  */
+#version 300 es
+
+#define NUM_INSTANCES 36
+
+precision highp float;
+
+layout (location = 0) in vec3 position;
+
+invariant gl_Position;
+
+uniform mat4 view;
+uniform mat4 projection;
+//! The packed layout decode values, see VertexQuantizer.
+uniform bool packedVertex;
+uniform vec3 posOffset;
+uniform vec3 posScale;
+
+layout uniform itemData{
+    mat4 location[NUM_INSTANCES];
+};
+
+vec3 vertPos;
+
+void main()
+{
+    if (packedVertex)
+    {
+        vertPos = posOffset + position * posScale;
+    }
+    else
+    {
+        vertPos = position;
+    }
+    gl_Position = projection * view * location[gl_InstanceID] * vec4(vertPos, 1.0);
+}
@@ -0,0 +1,32 @@
+/**********************************************************
+ *   impostor.frag:  A shader to color the camera facing
+ *   quads of distant objects from an atlas of views.
+ *   Created by: Edward Charles Eberle <eberdeed@eberdeed.net>
+ *   October 2026 San Diego, California USA
+ * ********************************************************/ 
+
+/** \class impostor.frag A shader to color impostor quads.
+ */
+
+#version 300 es
+
+precision highp float;
+
+in vec2 texCoord;
+
+out vec4 color;
+
+uniform sampler2D atlas;
+
+vec4 texVal;
+
+void main()
+{
+    texVal = texture(atlas, texCoord);
+    //! Alpha tested so the quads write depth like the meshes they stand in for.
+    if (texVal.a < 0.5)
+    {
+        discard;
+    }
+    color = vec4(texVal.rgb, 1.0);
+}
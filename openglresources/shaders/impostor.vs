@@ -0,0 +1,61 @@
+/**********************************************************
+ *   impostor.vs:  A shader to render distant instanced
+ *   objects as camera facing quads.  Each quad takes the
+ *   atlas tile whose view direction is closest to the
+ *   direction of the camera in the object's own space.
+ *   Created by: Edward Charles Eberle <eberdeed@eberdeed.net>
+ *   October 2026 San Diego, California USA
+ * ********************************************************/ 
+/** \class impostor.vs
+  *  Vertex shader.
+  */
+#version 300 es
+
+#define MAX_VIEWS 16
+
+precision highp float;
+
+layout (location = 0) in vec2 corner;
+layout (location = 1) in mat4 instance;
+
+out vec2 texCoord;
+
+uniform mat4 view;
+uniform mat4 projection;
+uniform vec3 viewPos;
+//! The bounding radius the atlas was rendered with.
+uniform float radius;
+//! The number of tiles and the atlas width in tiles.
+uniform int views;
+uniform int columns;
+//! The view direction and up vector of each tile in model space.
+uniform vec3 tileDir[MAX_VIEWS];
+uniform vec3 tileUp[MAX_VIEWS];
+
+void main()
+{
+    //! The camera direction in model space, the scale is removed by normalize.
+    vec3 dir = normalize(transpose(mat3(instance)) * (viewPos - instance[3].xyz));
+    int tile = 0;
+    float best = -2.0;
+    for (int x = 0; x < MAX_VIEWS; x++)
+    {
+        if (x < views)
+        {
+            float match = dot(dir, tileDir[x]);
+            if (match > best)
+            {
+                best = match;
+                tile = x;
+            }
+        }
+    }
+    //! The screen axes the tile was rendered with.
+    vec3 forward = -tileDir[tile];
+    vec3 side = normalize(cross(forward, tileUp[tile]));
+    vec3 up = cross(side, forward);
+    vec3 local = (corner.x * side + corner.y * up) * radius;
+    gl_Position = projection * view * instance * vec4(local, 1.0);
+    vec2 cell = vec2(float(tile % columns), float(tile / columns));
+    texCoord = (cell + (corner * 0.5) + 0.5) / float(columns);
+}
@@ -0,0 +1,17 @@
+/**********************************************************
+ *   overdraw.frag:  A shader to add one count to each pixel
+ *   that passes the stencil test, with additive blending.
+ *   Created by: Edward Charles Eberle <eberdeed@eberdeed.net>
+ *   October 2026 San Diego, California USA
+ * ********************************************************/
+#version 300 es
+precision highp float;
+
+out vec4 color;
+
+uniform float weight;
+
+void main()
+{
+    color = vec4(weight, 0.0, 0.0, 1.0);
+}
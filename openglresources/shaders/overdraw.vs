@@ -0,0 +1,16 @@
+/**********************************************************
+ *   overdraw.vs:  A shader to cover the screen with a
+ *   single triangle, used to resolve the overdraw counts
+ *   held in the stencil buffer.
+ *   Created by: Edward Charles Eberle <eberdeed@eberdeed.net>
+ *   October 2026 San Diego, California USA
+ * ********************************************************/
+#version 300 es
+precision highp float;
+
+void main()
+{
+    //! The corners (-1, -1), (3, -1) and (-1, 3) cover the screen.
+    vec2 corner = vec2(float((gl_VertexID & 1) << 2), float((gl_VertexID & 2) << 1)) - 1.0;
+    gl_Position = vec4(corner, 0.0, 1.0);
+}
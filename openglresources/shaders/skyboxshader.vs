@@ -19,7 +19,9 @@ vec4 tmpvec;
 void main()
 {
       
-    gl_Position = projection * view * model * vec4(position, 1.0);
+    //! Setting z to w puts the sky on the far plane, so it can be
+    //! drawn after the asteroids and only shade what they leave open.
+    gl_Position = (projection * view * model * vec4(position, 1.0)).xyww;
     tmpvec = model * vec4(position, 1.0);
     textureDir = tmpvec.xyz;
 }
@@ -14,6 +14,17 @@
 
 #version 300 es
 
+/** The variant definitions, set by Shader::variant() from the
+ *  textures of each mesh:
+ *  NUM_DIFFUSE : The number of diffuse textures, 0, 1 or 2.
+ *  NORMAL_MAP : Take the normal from the normal map.
+ *  LIT : Light the color with the sky box, otherwise the
+ *  texture color is the output.
+ */
+#ifndef NUM_DIFFUSE
+#define NUM_DIFFUSE 0
+#endif
+
 precision highp float;
 
 struct Location
@@ -28,96 +39,51 @@ in Location locval;
 
 out vec4 color;
 
-uniform samplerCube SkyBoxOne;
-uniform vec3 viewPos;
-//! Texture (optional)
+#if (NUM_DIFFUSE == 1) || (NUM_DIFFUSE == 2)
 uniform sampler2D diffuseOne;
+#endif
+#if NUM_DIFFUSE == 2
 uniform sampler2D diffuseTwo;
-uniform sampler2D specularOne;
-uniform sampler2D binormalOne;
-//! Specular intensity
-uniform float shininess;
-//! Toggle for texture
-uniform int numDiffuse;
-uniform bool isSpecular;
-uniform bool diffOnly;
-uniform bool isBiNormal;
+#endif
+#if (NUM_DIFFUSE != 1) && (NUM_DIFFUSE != 2)
+uniform vec3 colordiff;
 //! Object transparency
 uniform float opacity;
+#endif
+#ifdef LIT
+uniform samplerCube SkyBoxOne;
+uniform vec3 viewPos;
 uniform float gamma;
-uniform vec3 colordiff;
-uniform int debug;
-//! Shader variables
-vec3 light, I;
-vec4 texVal, texVal1, texVal2, lightVal;
-vec3 lightDir, reflectDir, normal;
-// diffuse shading
-float diff;
-// combine results
-vec3 ambient;
-vec3 diffuse;
-vec3 tmpval;
-float dotProd;
-/** \brief Calculate the color based on light and camera
-  *  position as well as surface normal.
-  */
-// function prototypes
-float mydot(vec3 a, vec3 b);
-
+#ifdef NORMAL_MAP
+uniform sampler2D binormalOne;
+#endif
+#endif
 
 void main()
 {
-    lightDir = normalize(vec3( -50.0,  150.0,  50.0) - locval.Position);
-    if (numDiffuse == 1)
-    {
-        texVal = texture(diffuseOne, locval.TexCoord);
-    }
-    else if (numDiffuse == 2)
-    {
-        texVal1 = texture(diffuseOne, locval.TexCoord);
-        texVal2 = texture(diffuseTwo, locval.TexCoord);
-        texVal = mix(texVal1, texVal2, 0.5);
-    }
-    else
-    {
-        texVal = vec4(colordiff, opacity);
-    }
-    if (isBiNormal)
-    {
-        // obtain normal from normal map in range [0,1]
-        normal = vec4(texture(binormalOne, locval.TexCoord)).xyz;
-        // transform normal vector to range [-1,1]
-        normal = (normal * 2.0) - 1.0;  // this normal is in tangent space
-        normal = normalize(normal);
-    }
-    else
-    {
-        normal = locval.Normal;
-    }
-    //! \brief Vector describing direction from camera to object.
-    I = normalize(viewPos - locval.Position);
-    //! The reflected light.
-    lightVal = texture(SkyBoxOne, I);
-    //light = vec3(0.3, 0.3, 0.3);
-    light = lightVal.xyz;
-    // Diffuse shading
-    dotProd = mydot(I, normal);
-    diff = max(dotProd, 0.0);
-    ambient  = 0.2 * texVal.xyz;
-    diffuse  = light * diff * texVal.xyz;
-    tmpval = ambient + diffuse;
-    color = vec4(tmpval, 1.0);
-    color = gamma * color ;
+    vec4 texVal;
+#if NUM_DIFFUSE == 1
+    texVal = texture(diffuseOne, locval.TexCoord);
+#elif NUM_DIFFUSE == 2
+    texVal = mix(texture(diffuseOne, locval.TexCoord), texture(diffuseTwo, locval.TexCoord), 0.5);
+#else
+    texVal = vec4(colordiff, opacity);
+#endif
+#ifdef LIT
+#ifdef NORMAL_MAP
+    //! The normal map holds [0, 1], the normal is in [-1, 1].
+    vec3 normal = normalize((texture(binormalOne, locval.TexCoord).xyz * 2.0) - 1.0);
+#else
+    vec3 normal = locval.Normal;
+#endif
+    //! The direction from the object to the camera, and the sky seen along it.
+    vec3 I = normalize(viewPos - locval.Position);
+    vec3 light = texture(SkyBoxOne, I).xyz;
+    float diff = max(dot(I, normal), 0.0);
+    vec3 ambient = 0.2 * texVal.xyz;
+    vec3 diffuse = light * diff * texVal.xyz;
+    color = gamma * vec4(ambient + diffuse, 1.0);
+#else
     color = texVal;
-}  
-/* Dot product */
-float mydot(vec3 a, vec3 b)
-{
-    float total = 0.0;
-    for (int x = 0; x < 3; x++)
-    {
-        total += a[x] * b[x];
-    }
-    return total;
+#endif
 }
-        
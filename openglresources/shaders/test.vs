@@ -27,25 +27,59 @@ struct Location
 };
 
 out Location locval;
+//! Placed exactly as depthonly.vs places it, for the GL_EQUAL pass.
+invariant gl_Position;
 
 uniform mat4 view;
 uniform mat4 projection;
+//! The packed layout decode values, see VertexQuantizer.
+uniform bool packedVertex;
+uniform vec3 posOffset;
+uniform vec3 posScale;
+uniform vec2 uvOffset;
+uniform vec2 uvScale;
 
 layout uniform itemData{
     mat4 location[NUM_INSTANCES];
 };
 
 vec4 tmpvec;
+vec3 vertPos;
+vec3 vertNormal;
+vec2 vertTex;
+
+//! Decode an octahedral encoded normal.
+vec3 octDecode(vec2 enc)
+{
+    vec3 n = vec3(enc.x, enc.y, 1.0 - abs(enc.x) - abs(enc.y));
+    float t = max(-n.z, 0.0);
+    n.x += (n.x >= 0.0) ? -t : t;
+    n.y += (n.y >= 0.0) ? -t : t;
+    return normalize(n);
+}
 
 void main()
 {
+    if (packedVertex)
+    {
+        //! Positions and texture coordinates arrive normalized to [0, 1].
+        vertPos = posOffset + position * posScale;
+        vertNormal = octDecode(normal.xy);
+        vertTex = uvOffset + texCoord * uvScale;
+    }
+    else
+    {
+        vertPos = position;
+        vertNormal = normal;
+        vertTex = texCoord;
+    }
     //! Calculate the location of the vertex.
-    tmpvec = projection * view * location[gl_InstanceID] * vec4(position, 1.0);
+    tmpvec = projection * view * location[gl_InstanceID] * vec4(vertPos, 1.0);
     gl_Position = tmpvec;
     locval.Position = tmpvec.xyz;
     //! Calculate the normal to the vertex.
-    locval.Normal = vec4(location[gl_InstanceID] * vec4(normal, 1.0)).xyz;
+    locval.Normal = vec4(location[gl_InstanceID] * vec4(vertNormal, 1.0)).xyz;
     //! Pass along the texture coordinate.
-    locval.TexCoord = texCoord;
+    locval.TexCoord = vertTex;
     //gl_PointSize = 20.0;
 } 
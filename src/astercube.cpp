@@ -39,11 +39,18 @@ AsterCube::AsterCube()
 AsterCube::~AsterCube()
 {
     cout << "\n\n\tDestroying AsterCube\n\n";
+    //! The workers stop before the classes their jobs fill are deleted.
+    delete loader;
     delete skybox;
     //delete terrain;
     delete objects;
     delete camera;
     cout << "\n\n\tDeleted Camera.\n\n";
+    delete governor;
+#ifndef NDEBUG
+    delete overdraw;
+    delete overdrawShader;
+#endif
 }
 
 
@@ -52,6 +59,21 @@ void AsterCube::exec()
     cout << "\n\n\tIn exec.\n\n";
     SDL_Event e;
     quit = false;
+    //! The assets load in the background while the first frames are
+    //! drawn, and the time to the first frame is counted from here.
+    loader = new AssetLoader();
+    //! With a pack the assets are read from one mapped file, without one from the disk.
+    AssetPack::shared().open(packFile, resourceRoot);
+    //! The asteroid textures hold the levels their size on screen needs.
+    TextureStreamer::shared().setBudget(textureBudget);
+    if (decodeTier < 0)
+    {
+        CreateImage::setDecodeBudget(textureBudget, budgetTextures);
+    }
+    else
+    {
+        CreateImage::decodeTier = decodeTier;
+    }
     try
     {
         // Setup the window
@@ -148,17 +170,27 @@ void AsterCube::exec()
         }
         //glCullFace(GL_BACK);
         glDepthRange(0.1f, 1000.0f);
+#ifndef NDEBUG
+        overdrawShader = new Shader();
+        overdrawShader->startShader(overdrawVertexShader, overdrawFragmentShader, "glastercubeoverdraw.bin");
+#endif
         skybox = new SkyBox();
         //terrain = new Terrain();
         objects = new Objects();
         skybox->setScale(size);
         //terrain->setScale(size);
         objects->setScale(limit);
-        objects->initObjects();
+        objects->initObjects(loader);
         camera = new Camera(SCR_WIDTH, SCR_HEIGHT, vec3(0.0f, -7.0f, 10.0f), vec3(0.0f, 0.0f, 0.0f));
-        skybox->initSkyBox();
+        governor = new FrameGovernor(frameBudget, SCR_WIDTH, SCR_HEIGHT);
+        skybox->initSkyBox(loader);
         skyboxTex = skybox->getSkyBox();
         objects->setSkyBox(skyboxTex);
+#ifndef NDEBUG
+        overdraw = new OverdrawCounter(overdrawShader);
+#endif
+        //! Anything still compiling is done before the first frame.
+        Shader::finishAll();
     }
     catch(exception exc)
     {
@@ -170,6 +202,18 @@ void AsterCube::exec()
     {
         //! Grab a time to adjust camera speed.
         intbegin  = chrono::system_clock::now();
+        //! Put a slice of the loaded assets into OpenGL, and capture the
+        //! impostors once everything is resident.
+        loader->pump(loadBudget);
+        if ((!objects->impostorsBuilt) && (loader->idle()))
+        {
+            objects->buildImpostors();
+            TextureCache::shared().report();
+            TextureStreamer::shared().report();
+        }
+        //! Pick the render size and detail for this frame.
+        governor->beginFrame();
+        objects->setQuality(governor->lodBias, governor->impostorScale);
         //! Find the camera.
         //! render
         // ------
@@ -178,9 +222,17 @@ void AsterCube::exec()
         view = camera->getViewMatrix(); //! render
         viewPos = camera->getPosition();
         projection = camera->getPerspective();
-        skybox->drawSkyBox(model, view, projection);
-        //terrain->drawTerrain(model, view, projection);
-        objects->drawObjects(model, view, projection, viewPos);
+#ifndef NDEBUG
+        if (measureNext)
+        {
+            measureOverdraw();
+            measureNext = false;
+        }
+#endif
+        drawScene(skyboxLast);
+        //! Read and drop texture levels for what was just drawn.
+        TextureStreamer::shared().update(loader);
+        governor->endFrame();
         intend = chrono::system_clock::now();
         while (SDL_PollEvent(&e))
         {
@@ -189,6 +241,7 @@ void AsterCube::exec()
             mouseMove(e);
         };
         SDL_GL_SwapWindow(window);
+        loader->frameDrawn();
         if (debug1)
         {
             cout << "\n\n\tThe window is replaced with a new window.\n\n";
@@ -202,6 +255,42 @@ void AsterCube::exec()
     SDL_Quit();
     return;
 }
+
+void AsterCube::drawScene(bool skyLast)
+{
+    if (skyLast)
+    {
+        //! Opaque objects, sorted nearest first by the library.
+        //terrain->drawTerrain(model, view, projection);
+        objects->drawObjects(model, view, projection, viewPos);
+        //! The sky only shades the pixels the objects left open.
+        skybox->drawSkyBox(model, view, projection);
+        //! Blended objects would follow here, farthest first.
+    }
+    else
+    {
+        skybox->drawSkyBox(model, view, projection);
+        //terrain->drawTerrain(model, view, projection);
+        objects->drawObjects(model, view, projection, viewPos);
+    }
+}
+
+#ifndef NDEBUG
+void AsterCube::measureOverdraw()
+{
+    long shaded[2];
+    for (int x = 0; x < 2; x++)
+    {
+        overdraw->begin();
+        drawScene(x == 1);
+        shaded[x] = overdraw->end();
+    }
+    cout << "\n\n\tOverdraw over " << overdraw->pixels << " pixels:  skybox first "
+    << shaded[0] << " fragments, skybox last " << shaded[1] << " fragments, saved "
+    << shaded[0] - shaded[1] << ".\n\n";
+}
+#endif
+
 // ---------------------------------------------------------------------------------------------------------
 void AsterCube::keyDown(SDL_Event e)
 {
@@ -261,6 +350,26 @@ void AsterCube::keyDown(SDL_Event e)
             case SDLK_DOWN:
                 camera->processMouseScroll(Camera::Camera_Movement::AWAY);
                 break;
+            //! Switch the pass ordering mode.
+            case SDLK_o:
+                skyboxLast = !skyboxLast;
+                cout << "\n\n\tSkybox drawn " << (skyboxLast ? "last" : "first") << ".\n\n";
+                break;
+            //! Switch the depth pre-pass.
+            case SDLK_i:
+                depthPrepass = !depthPrepass;
+                objects->setDepthPrepass(depthPrepass);
+                break;
+#ifndef NDEBUG
+            //! Count the fragments shaded in each pass order.
+            case SDLK_p:
+                measureNext = true;
+                break;
+#endif
+            //! Print the memory held by each subsystem.
+            case SDLK_m:
+                ResourceRegistry::shared().report();
+                break;
             case SDLK_ESCAPE:
                 cout << "\n\n\tIn SDL Escape.\n\n";
                 quit = true;
@@ -329,7 +438,7 @@ void AsterCube::windowEvent(SDL_Event e)
         case SDL_WINDOWEVENT_SIZE_CHANGED:
             cout << "\n\n\tWindow " << e.window.windowID << " size changed to " 
             << e.window.data1 << ", " << e.window.data2 << "\n\n";
-            glViewport(0, 0, e.window.data1, e.window.data2);
+            framebufferSize(e.window.data1, e.window.data2);
             break;
         case SDL_WINDOWEVENT_MINIMIZED:
             cout << "\n\n\tWindow " << e.window.windowID << " minimized.\n\n";
@@ -380,6 +489,8 @@ void AsterCube::framebufferSize(int width, int height)
     // height will be significantly larger than specified on retina displays.
     glViewport(0, 0, width, height);
     camera->resizeView(width, height);
+    //! The governor renders at a fraction of this size and scales up to it.
+    governor->resize(width, height);
 }
 
 void AsterCube::logSDLError(ostream &os, const string &msg)
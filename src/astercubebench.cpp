@@ -0,0 +1,316 @@
+/**********************************************************
+ *   AsterCubeBench:  A program to time the kernels of the
+ *   asteroid field one at a time:  placing the asteroids,
+ *   moving fields of several sizes, making the cubes,
+ *   decoding an image, loading the asteroid models,
+ *   sorting them and setting shader uniforms.  Each is run
+ *   a number of times and the fastest, median and mean time
+ *   of one call is printed, and written as JSON to compare
+ *   one release with the next.  Those needing OpenGL are
+ *   left out when no context can be made.
+ *   Usage:  astercube_bench [--runs count] [--json file]
+ *   [--image file] [--pack file]
+ *   Created by: Edward Charles Eberle <eberdeed@eberdeed.net>
+ *   October 2026 San Diego, California USA
+ * ********************************************************/
+
+#include "../include/commonheader.h"
+#include "../include/objects.h"
+#include "../include/asterobject.h"
+
+//! The timings of one kernel at one size, in nanoseconds a call.
+struct BenchResult {
+    string name;
+    long size = 0;
+    int iterations = 0;
+    double fastest = 0.0, median = 0.0, mean = 0.0;
+};
+
+//! Quiets the messages of the classes while they are timed.
+struct Quiet {
+    streambuf *saved;
+    Quiet() : saved(cout.rdbuf(nullptr)) {}
+    ~Quiet()
+    {
+        cout.rdbuf(saved);
+        cout.clear();
+    }
+};
+
+//! Prints fixed point numbers while it lives, then gives the stream back its format.
+struct Fixed {
+    ostream &stream;
+    ios::fmtflags flags;
+    streamsize precision;
+    Fixed(ostream &stream, int digits) : stream(stream), flags(stream.flags()), precision(stream.precision())
+    {
+        stream << fixed << setprecision(digits);
+    }
+    ~Fixed()
+    {
+        stream.flags(flags);
+        stream.precision(precision);
+    }
+};
+
+//! Lets the benchmark reach the sort of the models.
+class BenchModel : public Model
+{
+public:
+    using Model::Model;
+    using Model::sortDists;
+};
+
+//! Each kernel is timed runs times, each run calling it iterations times.
+static int runs = 10;
+static vector<BenchResult> results;
+
+template <typename Body>
+static void measure(string name, long size, int iterations, Body body)
+{
+    vector<double> times;
+    for (int x = 0; x < runs; x++)
+    {
+        auto begin = chrono::steady_clock::now();
+        {
+            Quiet quiet;
+            for (int y = 0; y < iterations; y++)
+            {
+                body();
+            }
+        }
+        times.push_back(chrono::duration<double, nano>(chrono::steady_clock::now() - begin).count() / iterations);
+    }
+    sort(times.begin(), times.end());
+    BenchResult result;
+    result.name = name;
+    result.size = size;
+    result.iterations = iterations;
+    result.fastest = times.front();
+    result.median = times[times.size() / 2];
+    for (unsigned int x = 0; x < times.size(); x++)
+    {
+        result.mean += times[x] / times.size();
+    }
+    results.push_back(result);
+    Fixed format(cout, 1);
+    cout << "\t" << name << "\t" << size << "\t" << iterations << "\t"
+    << result.fastest << "\t" << result.median << "\t" << result.mean << "\n";
+}
+
+//! Write the results for the next release to be compared with.
+static bool writeJson(string file, bool gl)
+{
+    ofstream out(file);
+    if (!out)
+    {
+        return false;
+    }
+    Fixed format(out, 1);
+    out << "{\n  \"program\": \"astercube_bench\",\n  \"runs\": " << runs
+    << ",\n  \"gl\": " << ((gl) ? "true" : "false") << ",\n  \"unit\": \"ns\",\n  \"results\": [";
+    for (unsigned int x = 0; x < results.size(); x++)
+    {
+        out << ((x > 0) ? ",\n" : "\n") << "    {\"name\": \"" << results[x].name << "\", \"size\": " << results[x].size
+        << ", \"iterations\": " << results[x].iterations
+        << ", \"fastest\": " << results[x].fastest << ", \"median\": " << results[x].median
+        << ", \"mean\": " << results[x].mean << "}";
+    }
+    out << "\n  ]\n}\n";
+    return true;
+}
+
+//! Make a hidden window with an OpenGL ES 3.0 context, as the program does.
+static bool makeContext(SDL_Window *&window, SDL_GLContext &context)
+{
+    if (SDL_Init(SDL_INIT_VIDEO) != 0)
+    {
+        return false;
+    }
+    SDL_GL_SetAttribute(SDL_GL_CONTEXT_MAJOR_VERSION, 3);
+    SDL_GL_SetAttribute(SDL_GL_CONTEXT_MINOR_VERSION, 0);
+    SDL_GL_SetAttribute(SDL_GL_CONTEXT_PROFILE_MASK, SDL_GL_CONTEXT_PROFILE_ES);
+    window = SDL_CreateWindow("AsterCube Bench", 0, 0, 640, 480, SDL_WINDOW_OPENGL | SDL_WINDOW_HIDDEN);
+    if (window == nullptr)
+    {
+        SDL_Quit();
+        return false;
+    }
+    context = SDL_GL_CreateContext(window);
+    if (context == nullptr)
+    {
+        SDL_DestroyWindow(window);
+        SDL_Quit();
+        return false;
+    }
+    SDL_GL_MakeCurrent(window, context);
+    glewExperimental = GL_TRUE;
+    if (glewInit() != GLEW_OK)
+    {
+        SDL_GL_DeleteContext(context);
+        SDL_DestroyWindow(window);
+        SDL_Quit();
+        return false;
+    }
+    return true;
+}
+
+int main(int argc, char **argv)
+{
+    string jsonFile = "astercube_bench.json";
+    string imageFile = "/usr/share/openglresources/skyboxes/mp_drakeq/drakeq_rt.tga";
+    string packFile = "/usr/share/openglresources/astercube.pack";
+    for (int x = 1; x < argc; x++)
+    {
+        string arg = argv[x];
+        if ((arg == "--runs") && (x + 1 < argc))
+        {
+            runs = std::max(atoi(argv[++x]), 1);
+        }
+        else if ((arg == "--json") && (x + 1 < argc))
+        {
+            jsonFile = argv[++x];
+        }
+        else if ((arg == "--image") && (x + 1 < argc))
+        {
+            imageFile = argv[++x];
+        }
+        else if ((arg == "--pack") && (x + 1 < argc))
+        {
+            packFile = argv[++x];
+        }
+        else
+        {
+            cout << "\n\n\tUsage:  astercube_bench [--runs count] [--json file] [--image file] [--pack file]\n\n";
+            return -1;
+        }
+    }
+    AssetPack::shared().open(packFile, "/usr/share/openglresources");
+    //! The counting of every allocation would be timed too.
+    ResourceRegistry::shared().enabled = false;
+    Objects objects;
+    objects.setScale(80.0f);
+    cout << "\n\n\tBenchmark\tSize\tIterations\tFastest ns\tMedian ns\tMean ns\n";
+    //! The asteroid field, without OpenGL.
+    measure("Objects::createAsteroids", QUANTITY * AMOUNT, 20, [&objects]()
+    {
+        objects.modelinfo.clear();
+        objects.createAsteroids(AMOUNT);
+    });
+    for (int amount : {1, 2, 4, AMOUNT})
+    {
+        measure("Objects::calcPosition", QUANTITY * amount, 100, [&objects, amount]()
+        {
+            objects.calcPosition(mat4(1.0f), amount);
+        });
+    }
+    AsterObject cube;
+    measure("AsterObject::genCube", 36, 1000, [&cube]()
+    {
+        delete [] cube.genCube(1.0f, true, true, true);
+    });
+    measure("AsterObject::genMatrices", 36, 1000, [&cube]()
+    {
+        cube.genMatrices();
+    });
+    if (AssetPack::shared().has(imageFile))
+    {
+        CreateImage image;
+        measure("CreateImage::setImage", 0, 1, [&image, imageFile]()
+        {
+            image.setImage(imageFile);
+        });
+    }
+    else
+    {
+        cout << "\n\n\tNo image at " << imageFile << ", CreateImage::setImage is not timed.\n\n";
+    }
+    //! The models and shaders need a context.
+    SDL_Window *window = nullptr;
+    SDL_GLContext context = nullptr;
+    bool gl = makeContext(window, context);
+    if (!gl)
+    {
+        cout << "\n\n\tNo OpenGL ES 3.0 context, the models and shaders are not timed.\n\n";
+    }
+    else
+    {
+        Shader shader;
+        shader.initShader(objects.vertexShader, objects.fragmentShader, "glastercube.bin");
+        shader.Use();
+        mat4 matrix = mat4(1.0f);
+        //! Only uniforms active in the plain program, the others are not there to set.
+        measure("Shader::setInt", 1, 10000, [&shader]()
+        {
+            shader.setInt("packedVertex", 0);
+        });
+        measure("Shader::setFloat", 1, 10000, [&shader]()
+        {
+            shader.setFloat("opacity", 1.0f);
+        });
+        measure("Shader::setVec3", 1, 10000, [&shader]()
+        {
+            shader.setVec3("posOffset", vec3(0.0f, -7.0f, 10.0f));
+        });
+        measure("Shader::setMat4", 1, 10000, [&shader, &matrix]()
+        {
+            shader.setMat4("view", matrix);
+        });
+        bool found = true;
+        for (int x = 0; x < AMOUNT; x++)
+        {
+            found = (found) && (AssetPack::shared().has(objects.asteroids[x]));
+        }
+        if (found)
+        {
+            objects.modelinfo.clear();
+            objects.createAsteroids(AMOUNT);
+            //! The first load fills the mesh and compressed texture caches,
+            //! so it is left out and the timed loads all take the warm path.
+            {
+                Quiet quiet;
+                delete new Model(objects.modelinfo, QUANTITY, &shader, 2);
+            }
+            //! Each load reads and uploads every asteroid, so only a few are made.
+            int saved = runs;
+            runs = std::min(runs, 3);
+            measure("Model::loadModels warm", AMOUNT, 1, [&objects, &shader]()
+            {
+                delete new Model(objects.modelinfo, QUANTITY, &shader, 2);
+            });
+            runs = saved;
+            BenchModel *model;
+            {
+                Quiet quiet;
+                model = new BenchModel(objects.modelinfo, QUANTITY, &shader, 2);
+            }
+            float angle = 0.0f;
+            measure("Model::sortDists", AMOUNT, 10000, [model, &angle]()
+            {
+                angle += 0.01f;
+                model->sortDists(vec3(cos(angle) * 50.0f, 0.0f, sin(angle) * 50.0f));
+            });
+            {
+                Quiet quiet;
+                delete model;
+            }
+        }
+        else
+        {
+            cout << "\n\n\tThe asteroid models are not there, Model is not timed.\n\n";
+        }
+    }
+    if (!writeJson(jsonFile, gl))
+    {
+        cout << "\n\n\tError:  Can not write " << jsonFile << ".\n\n";
+        return -1;
+    }
+    cout << "\n\n\tWrote the results to " << jsonFile << ".\n\n";
+    if (gl)
+    {
+        SDL_GL_DeleteContext(context);
+        SDL_DestroyWindow(window);
+        SDL_Quit();
+    }
+    return 0;
+}
@@ -0,0 +1,105 @@
+/**********************************************************
+ *   AsterCubeObjBench:  A program to time the OBJ parser
+ *   against the Assimp importer on the same files.  Each
+ *   file is read a number of times by each and the fastest
+ *   read of each is printed, with the meshes, vertices and
+ *   triangles each made.
+ *   Usage:  astercubeobjbench [--runs count] [file.obj ...]
+ *   The asteroids in /usr/share/openglresources by default.
+ *   Created by: Edward Charles Eberle <eberdeed@eberdeed.net>
+ *   October 2026 San Diego, California USA
+ * ********************************************************/
+
+#include "../include/commonheader.h"
+#include <sys/stat.h>
+
+int main(int argc, char **argv)
+{
+    int runs = 20;
+    vector<string> files;
+    for (int x = 1; x < argc; x++)
+    {
+        string arg = argv[x];
+        if ((arg == "--runs") && (x + 1 < argc))
+        {
+            runs = std::max(atoi(argv[++x]), 1);
+        }
+        else
+        {
+            files.push_back(arg);
+        }
+    }
+    if (files.size() == 0)
+    {
+        for (int x = 1; x <= 6; x++)
+        {
+            files.push_back("/usr/share/openglresources/asteroids/asteroid" + to_string(x) + ".obj");
+        }
+    }
+    cout << "\n\n\tFile\tBytes\tParser ms\tMeshes\tVertices\tTriangles"
+    << "\tAssimp ms\tMeshes\tVertices\tTriangles\tSpeed up\n";
+    for (unsigned int x = 0; x < files.size(); x++)
+    {
+        struct stat status;
+        if (stat(files[x].c_str(), &status) != 0)
+        {
+            cout << "\n\n\tError:  No file " << files[x] << ".\n\n";
+            return -1;
+        }
+        //! The parser, freeing its arrays after each read.
+        double parserTime = 1e30;
+        long parserMeshes = 0, parserVertices = 0, parserTriangles = 0;
+        for (int y = 0; y < runs; y++)
+        {
+            vector<MeshData> meshes;
+            auto begin = chrono::steady_clock::now();
+            bool parsed = ObjParser::read(files[x], meshes);
+            parserTime = std::min(parserTime, chrono::duration<double, milli>(chrono::steady_clock::now() - begin).count());
+            if (!parsed)
+            {
+                cout << "\n\n\tError:  The parser can not read " << files[x] << ".\n\n";
+                return -1;
+            }
+            parserMeshes = meshes.size();
+            parserVertices = parserTriangles = 0;
+            for (unsigned int z = 0; z < meshes.size(); z++)
+            {
+                parserVertices += meshes[z].vertSize;
+                parserTriangles += meshes[z].indexSize / 3;
+                delete [] meshes[z].vertices;
+                delete [] meshes[z].vertices1;
+                delete [] meshes[z].indices;
+            }
+        }
+        //! Assimp with the flags of Model::readScene().
+        double assimpTime = 1e30;
+        long assimpMeshes = 0, assimpVertices = 0, assimpTriangles = 0;
+        Assimp::Importer importer;
+        for (int y = 0; y < runs; y++)
+        {
+            auto begin = chrono::steady_clock::now();
+            const aiScene *scene = importer.ReadFile(files[x], aiProcess_Triangulate | aiProcess_GenNormals
+            | aiProcess_GenUVCoords);
+            assimpTime = std::min(assimpTime, chrono::duration<double, milli>(chrono::steady_clock::now() - begin).count());
+            if (scene == nullptr)
+            {
+                cout << "\n\n\tError:  Assimp can not read " << files[x] << ":  " << importer.GetErrorString() << "\n\n";
+                return -1;
+            }
+            assimpMeshes = scene->mNumMeshes;
+            assimpVertices = assimpTriangles = 0;
+            for (unsigned int z = 0; z < scene->mNumMeshes; z++)
+            {
+                assimpVertices += scene->mMeshes[z]->mNumVertices;
+                assimpTriangles += scene->mMeshes[z]->mNumFaces;
+            }
+            importer.FreeScene();
+        }
+        cout << "\t" << files[x].substr(files[x].find_last_of('/') + 1) << "\t" << status.st_size
+        << "\t" << parserTime << "\t" << parserMeshes << "\t" << parserVertices << "\t" << parserTriangles
+        << "\t" << assimpTime << "\t" << assimpMeshes << "\t" << assimpVertices << "\t" << assimpTriangles
+        << "\t" << assimpTime / std::max(parserTime, 1e-6) << "\n";
+    }
+    cout << "\n\n";
+    return 0;
+}
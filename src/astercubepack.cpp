@@ -0,0 +1,44 @@
+/**********************************************************
+ *   AsterCubePack:  A program to pack the AsterCube assets,
+ *   the models, images and shaders, into the one file that
+ *   AsterCube maps at start up.
+ *   Usage:  astercubepack [directory] [pack] [--store]
+ *   The directory is /usr/share/openglresources and the pack
+ *   astercube.pack in it by default.  --store leaves the
+ *   files uncompressed.
+ *   Created by: Edward Charles Eberle <eberdeed@eberdeed.net>
+ *   October 2026 San Diego, California USA
+ * ********************************************************/
+
+#include "../include/commonheader.h"
+
+int main(int argc, char **argv)
+{
+    string root = "/usr/share/openglresources";
+    string pack;
+    bool compress = true;
+    vector<string> names;
+    for (int x = 1; x < argc; x++)
+    {
+        string arg = argv[x];
+        if (arg == "--store")
+        {
+            compress = false;
+        }
+        else
+        {
+            names.push_back(arg);
+        }
+    }
+    if (names.size() > 2)
+    {
+        cout << "\n\n\tUsage:  astercubepack [directory] [pack] [--store]\n\n";
+        return -1;
+    }
+    if (names.size() > 0)
+    {
+        root = names[0];
+    }
+    pack = (names.size() > 1) ? names[1] : root + "/astercube.pack";
+    return (AssetPack::build(root, pack, compress)) ? 0 : -1;
+}
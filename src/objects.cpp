@@ -28,6 +28,10 @@ Objects::~Objects()
 {
     cout << "\n\n\tDestorying Objects.\n\n";
     delete shader;
+    delete impostorShader;
+    delete depthShader;
+    delete [] instanceData;
+    ResourceRegistry::shared().releaseHeap(instanceData);
 }
 void Objects::setScale(float value)
 {
@@ -53,16 +57,37 @@ void Objects::debug()
         }
     }
 }
-void Objects::initObjects()
+void Objects::initObjects(AssetLoader *loader)
 {
         createAsteroids(AMOUNT);
+        //! The shaders compile while the models are read, and are
+        //! finished the first time they are used.
         shader = new Shader();
-        shader->initShader(vertexShader, fragmentShader, "glastercube.bin");
-        cout << "\n\n\tShader created.\n\n";
-        figure = new Model(modelinfo, QUANTITY, shader, 2);
+        shader->startShader(vertexShader, fragmentShader, "glastercube.bin");
+        impostorShader = new Shader();
+        impostorShader->startShader(impostorVertexShader, impostorFragmentShader, "glastercubeimpostor.bin");
+        depthShader = new Shader();
+        depthShader->startShader(depthVertexShader, depthFragmentShader, "glastercubedepth.bin");
+        cout << "\n\n\tShaders started.\n\n";
+        figure = new Model(modelinfo, QUANTITY, shader, 2, loader);
+        //! With a loader the impostors wait for the assets, see buildImpostors().
+        if (loader == nullptr)
+        {
+            buildImpostors();
+        }
+        figure->setDepthPrepass(false, depthShader);
         debug();
 }
 
+void Objects::buildImpostors()
+{
+        if (!impostorsBuilt)
+        {
+            figure->buildImpostors(impostorShader);
+            impostorsBuilt = true;
+        }
+}
+
 void Objects::drawObjects(mat4 model, mat4 view, mat4 projection, vec3 viewPos)
 {
         
@@ -81,10 +106,20 @@ void Objects::drawObjects(mat4 model, mat4 view, mat4 projection, vec3 viewPos)
         }
         glActiveTexture(GL_TEXTURE1);
         glBindTexture(GL_TEXTURE_CUBE_MAP, skyboxTex); 
-        shader->setInt("SkyBoxOne", 1);
+        shader->setIntAll("SkyBoxOne", 1);
         figure->DrawInstanced(view, projection, modelinfo, modelData, lights, spotLights, viewPos);
         glBindTexture(GL_TEXTURE_CUBE_MAP, 0);
 }
+void Objects::setDepthPrepass(bool enabled)
+{
+    figure->setDepthPrepass(enabled);
+}
+
+void Objects::setQuality(float lodBias, float impostorScale)
+{
+    figure->setQuality(lodBias, impostorScale);
+}
+
 vec3 Objects::getDirection(vec3 viewer, vec3 viewed)
 {
     vec3 tmpval = normalize(viewed - viewer);
@@ -236,6 +271,7 @@ void Objects::createAsteroids(int value)
         //! The position and orientation matrix.
         item.model = tmpLocs[x].objMatrices;
         item.gamma = 2.3f;
+        item.quantize = true;
         item.location = tmpLocs[x].objLocs;
         //! Tack it onto the vector.
         modelinfo.push_back(item);
@@ -246,7 +282,11 @@ void Objects::calcPosition(mat4 model, int value)
 {
     //! Distribute the asteroid location, scale and rotation values among the three asteroids.
     //! each value of matLocs is one type of asteroid field value.
+    //! The last frame's array is freed, it was kept until now.
+    delete [] instanceData;
+    ResourceRegistry::shared().releaseHeap(instanceData);
     instanceData = new float[(int) QUANTITY * value * 16];
+    ResourceRegistry::shared().trackHeap(instanceData, "Asteroid field", (long) QUANTITY * value * 16 * sizeof(float));
     int count = 1;
     mat4 matpos;
     vec4 vecpos;
@@ -26,10 +26,15 @@ SkyBox::SkyBox()
 SkyBox::~SkyBox()
 {
     cout << "\n\n\tDestroying SkyBox.\n\n";
+    CreateImage::releaseTexture(skyboxTex);
     delete image;
     delete skyboxShader;
     glDeleteBuffers(1, &skyboxVBO);
     glDeleteVertexArrays(1, &skyboxVAO);
+    ResourceRegistry::shared().releaseGL(ResourceRegistry::BUFFER, skyboxVBO);
+    delete [] skycube;
+    ResourceRegistry::shared().releaseHeap(skycube);
+    delete cuby;
 }
 void SkyBox::setScale(float value)
 {
@@ -40,15 +45,18 @@ unsigned int SkyBox::getSkyBox()
     return skyboxTex;
 }
 
-void SkyBox::initSkyBox()
+void SkyBox::initSkyBox(AssetLoader *loader)
 {
     skyboxShader = new Shader();
-    skyboxShader->initShader(vertexShader, fragmentShader, "supercubeskybox.bin");
+    skyboxShader->startShader(vertexShader, fragmentShader, "supercubeskybox.bin");
     cout << "\n\n\tCreated skybox shader.\n\n";
     image = new CreateImage();
-    image->createSkyBoxTex(skyboxTex, skybox);
+    //! A dark sky is drawn until the six faces are decoded.
+    static const unsigned char night[4] = {8, 8, 24, 255};
+    image->loadSkyBox(skyboxTex, skybox, loader, night);
     cuby = new AsterObject();
     skycube = cuby->genCube(size, false, false, false);
+    ResourceRegistry::shared().trackHeap(skycube, "Skybox", 108 * sizeof(float));
     //debug();
     //! Set up the skybox VAO
     glGenVertexArrays(1, &skyboxVAO);
@@ -57,6 +65,7 @@ void SkyBox::initSkyBox()
     glBindVertexArray(skyboxVAO);
     glBindBuffer(GL_ARRAY_BUFFER, skyboxVBO);
     glBufferData(GL_ARRAY_BUFFER, 108 * sizeof(float), skycube, GL_STATIC_DRAW);
+    ResourceRegistry::shared().trackGL(ResourceRegistry::BUFFER, skyboxVBO, "Skybox", 108 * sizeof(float));
     
     glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(GLfloat), (GLvoid*)0);
     glEnableVertexAttribArray(0);
@@ -77,6 +86,8 @@ void SkyBox::debug()
 void SkyBox::drawSkyBox(mat4 model, mat4 view, mat4 projection)
 {
         glDisable(GL_CULL_FACE);
+        //! The sky sits at the far plane, equal to the cleared depth.
+        glDepthFunc(GL_LEQUAL);
         skyboxShader->Use();
         skyboxShader->setMat4("view", view);
         skyboxShader->setMat4("projection", projection);
@@ -88,5 +99,5 @@ void SkyBox::drawSkyBox(mat4 model, mat4 view, mat4 projection)
         glDrawArrays(GL_TRIANGLES, 0, 36);
         glBindTexture(GL_TEXTURE_CUBE_MAP, 0);
         glBindVertexArray(0);
-    
+        glDepthFunc(GL_LESS);
 }
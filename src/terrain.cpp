@@ -27,6 +27,7 @@ Terrain::Terrain()
 Terrain::~Terrain()
 {
     cout << "\n\n\tDestroying Terrain.\n\n";
+    CreateImage::releaseTexture(floorTex);
     delete image;
     delete floorShader;
     glDeleteBuffers(1, &floorVBO);
@@ -93,10 +94,8 @@ void Terrain::initTerrain()
     floorShader->initShader(string("../../openglresources/shaders/floor.vs"),
     string("../../openglresources/shaders/floor.frag"),
     string("supercubefloor.bin"));
-    glGenTextures(1, &floorTex);
     image = new CreateImage();
-    image->setImage("../../openglresources/objects/images/dirt.jpg");
-    floorTex = image->textureObject();
+    floorTex = image->loadTexture("../../openglresources/objects/images/dirt.jpg");
     cout << "\n\n\tCreating floor vertex buffer.\n\n";
     // Generate the sky box.
     glGenVertexArrays(1, &floorVAO);